@@ -16,8 +16,10 @@
 #include "src/EEPROMManager.h"
 #include "src/Task.h"
 #include "src/Tasks.h"
+#include "src/DebugOutput.h"
 
-// Global objects
+// Global objects. debugOutput comes first: Settings prints from its constructor.
+DebugOutput debugOutput;
 Settings settings;
 EEPROMManager eepromManager;
 
@@ -26,7 +28,7 @@ float cpuUtilization = 0.0;
 unsigned long lastCpuUpdate = 0;
 
 void setup() {
-  Serial.begin(115200);
+  Serial.begin(SERIAL_DEBUG_BAUD);
   
   // Initialize EEPROM
   EEPROM.begin(EEPROM_SIZE);
@@ -35,11 +37,11 @@ void setup() {
   eepromManager.begin();
   
   // Initialize SPIFFS
-  Serial.println(F("Init SPIFFS"));
+  debugOutput.println(F("Init SPIFFS"));
   if (SPIFFS.begin()) {
     settings.readFromFile();
   } else {
-    Serial.println(F("SPIFFS mount failed"));
+    debugOutput.at(LOG_LEVEL_ERROR).println(F("SPIFFS mount failed"));
   }
   
   // Initialize I2C
@@ -50,7 +52,7 @@ void setup() {
   
   // Initialize MPU sensor
   if (!mpusensorTask.initFIFO()) {
-    Serial.println(F("MPU6050 initialization failed"));
+    debugOutput.at(LOG_LEVEL_ERROR).println(F("MPU6050 initialization failed"));
   }
 }
 
@@ -101,6 +103,9 @@ void loop() {
     cpuUtilization = (totalTaskTime * 100.0) / totalWindowTime;
   }
 
+  // Idle slot: pass queued debug text to the UART without waiting on it
+  debugOutput.drain();
+  
   lastSlowLoop = millis();
   lastTaskMask = taskMask;
 }
@@ -1,11 +1,126 @@
-// Binary data decoder for MPULogRecord format
+// Binary data decoder for MPULogRecord (.bin), MPUSummaryRecord (.sum) and MPUPyramidRecord
+// (.p16/.p256/.p4096) formats
 class MPULogDecoder {
   constructor() {
     this.RECORD_SIZE = 32; // bytes per record
+    this.SUMMARY_RECORD_SIZE = 56; // bytes per summary window
+    this.SUMMARY_FLAG_PARTIAL = 1;
+    this.PYRAMID_RECORD_SIZE = 32; // bytes per min/max pyramid bucket
+    this.HEADER_MAGIC = 0xFFFE4C4D; // MPULogHeader, only present on channel-masked files
+    this.HEADER_SIZE = 8;
+    this.LAYOUT_RECORDS = 0;
+    this.LAYOUT_COLUMNAR = 1;
+    this.COLUMNAR_PAGE_HEADER = 4;
+    this.CHANNEL_KEYS = ['accel_x', 'accel_y', 'accel_z', 'yaw', 'pitch', 'roll'];
+  }
+
+  isSummaryFile(fileName) {
+    return fileName.toLowerCase().endsWith('.sum');
+  }
+
+  // Min/max pyramid level of a raw log, returns its downsampling factor or 0
+  pyramidFactor(fileName) {
+    const match = /\.p(16|256|4096)$/i.exec(fileName);
+    return match ? parseInt(match[1], 10) : 0;
+  }
+
+  async decode(arrayBuffer, fileName) {
+    if (this.pyramidFactor(fileName)) {
+      return this.decodePyramidFile(arrayBuffer, this.pyramidFactor(fileName));
+    }
+    return this.isSummaryFile(fileName) ? this.decodeSummaryFile(arrayBuffer) : this.decodeFile(arrayBuffer);
+  }
+
+  // Pyramid buckets hold the min/max of every channel over factor logged samples, in summary
+  // units. They decode like summary windows with the band midpoint standing in for the mean.
+  async decodePyramidFile(arrayBuffer, factor) {
+    const dataView = new DataView(arrayBuffer);
+    const records = [];
+    const scales = [1000, 1000, 1000, 10, 10, 10]; // to G and deg/s
+    const recordCount = Math.floor(arrayBuffer.byteLength / this.PYRAMID_RECORD_SIZE);
+
+    for (let offset = 0; offset <= arrayBuffer.byteLength - this.PYRAMID_RECORD_SIZE; offset += this.PYRAMID_RECORD_SIZE) {
+      const min = [], max = [], mid = [];
+      for (let c = 0; c < 6; c++) {
+        min.push(dataView.getInt16(offset + 8 + c * 2, true) / scales[c]);
+        max.push(dataView.getInt16(offset + 20 + c * 2, true) / scales[c]);
+        mid.push((min[c] + max[c]) / 2);
+      }
+
+      records.push({
+        timestamp: dataView.getUint32(offset, true),
+        sampleCount: dataView.getUint16(offset + 4, true),
+        flags: 0,
+        accel_x: mid[0],
+        accel_y: mid[1],
+        accel_z: mid[2],
+        yaw: mid[3],
+        pitch: mid[4],
+        roll: mid[5],
+        min: min,
+        max: max
+      });
+    }
+
+    return {
+      records: records,
+      recordCount: recordCount,
+      expectedCount: recordCount,
+      corrupted: (arrayBuffer.byteLength % this.PYRAMID_RECORD_SIZE) !== 0,
+      summary: true,
+      pyramidFactor: factor
+    };
+  }
+
+  // Summary records hold min/max/mean/RMS per channel, accel in mG and gyro in 0.1 deg/s.
+  // The means are also exposed as accel_x..roll so the table and exports work unchanged.
+  async decodeSummaryFile(arrayBuffer) {
+    const dataView = new DataView(arrayBuffer);
+    const records = [];
+    const scales = [1000, 1000, 1000, 10, 10, 10]; // to G and deg/s
+
+    const recordCount = Math.floor(arrayBuffer.byteLength / this.SUMMARY_RECORD_SIZE);
+
+    for (let offset = 0; offset <= arrayBuffer.byteLength - this.SUMMARY_RECORD_SIZE; offset += this.SUMMARY_RECORD_SIZE) {
+      const min = [], max = [], mean = [], rms = [];
+      for (let c = 0; c < 6; c++) {
+        const base = offset + 8 + c * 8;
+        min.push(dataView.getInt16(base, true) / scales[c]);
+        max.push(dataView.getInt16(base + 2, true) / scales[c]);
+        mean.push(dataView.getInt16(base + 4, true) / scales[c]);
+        rms.push(dataView.getUint16(base + 6, true) / scales[c]);
+      }
+
+      records.push({
+        timestamp: dataView.getUint32(offset, true),
+        sampleCount: dataView.getUint16(offset + 4, true),
+        flags: dataView.getUint16(offset + 6, true),
+        accel_x: mean[0],
+        accel_y: mean[1],
+        accel_z: mean[2],
+        yaw: mean[3],
+        pitch: mean[4],
+        roll: mean[5],
+        min: min,
+        max: max,
+        rms: rms
+      });
+    }
+
+    return {
+      records: records,
+      recordCount: recordCount,
+      expectedCount: recordCount,
+      corrupted: (arrayBuffer.byteLength % this.SUMMARY_RECORD_SIZE) !== 0,
+      summary: true
+    };
   }
 
   async decodeFile(arrayBuffer) {
     const dataView = new DataView(arrayBuffer);
+    if (arrayBuffer.byteLength >= this.HEADER_SIZE && dataView.getUint32(0, true) === this.HEADER_MAGIC) {
+      return this.decodeMaskedFile(dataView);
+    }
     const records = [];
     
     const recordCount = Math.floor(arrayBuffer.byteLength / this.RECORD_SIZE);
@@ -40,6 +155,149 @@ class MPULogDecoder {
       corrupted: records.length < recordCount || hasPartialRecord
     };
   }
+
+  // Files with an MPULogHeader hold only the channels in its mask; channels that were not
+  // logged are null so plots show them as gaps. channels optionally limits decoding to a
+  // subset of CHANNEL_KEYS, which columnar files can read without touching the rest.
+  decodeMaskedFile(dataView, channels) {
+    const channelMask = dataView.getUint8(5);
+    const recordSize = dataView.getUint8(6);
+    const layout = dataView.getUint8(7);
+    if (recordSize === 0) {
+      return { records: [], recordCount: 0, expectedCount: 0, corrupted: true, channelMask: channelMask };
+    }
+
+    // Byte offset of each logged channel within a record, or its block index in a columnar page
+    const slots = [];
+    let slot = 0;
+    for (let c = 0; c < 6; c++) {
+      const logged = (channelMask & (1 << c)) !== 0;
+      const wanted = !channels || channels.includes(this.CHANNEL_KEYS[c]);
+      slots.push(logged && wanted ? slot : -1);
+      if (logged) slot++;
+    }
+
+    const result = layout === this.LAYOUT_COLUMNAR
+      ? this.decodeColumnarPages(dataView, recordSize, slot, slots)
+      : this.decodePackedRecords(dataView, recordSize, slots);
+    result.expectedCount = result.recordCount;
+    result.channelMask = channelMask;
+    result.columnar = layout === this.LAYOUT_COLUMNAR;
+    return result;
+  }
+
+  decodePackedRecords(dataView, recordSize, slots) {
+    const records = [];
+    const dataBytes = dataView.byteLength - this.HEADER_SIZE;
+    const recordCount = Math.floor(dataBytes / recordSize);
+
+    for (let i = 0; i < recordCount; i++) {
+      const offset = this.HEADER_SIZE + i * recordSize;
+      const record = { timestamp: dataView.getUint32(offset, true) };
+      for (let c = 0; c < 6; c++) {
+        record[this.CHANNEL_KEYS[c]] = slots[c] < 0 ? null : dataView.getFloat32(offset + 4 + slots[c] * 4, true);
+      }
+      record.flags = dataView.getUint8(offset + recordSize - 2);
+      records.push(record);
+    }
+
+    return { records: records, recordCount: recordCount, corrupted: (dataBytes % recordSize) !== 0 };
+  }
+
+  // Columnar pages: uint16 count, uint16 reserved, count timestamps, count floats per logged
+  // channel, count flag bytes
+  decodeColumnarPages(dataView, recordSize, channelCount, slots) {
+    const records = [];
+    let offset = this.HEADER_SIZE;
+    let corrupted = false;
+
+    while (offset + this.COLUMNAR_PAGE_HEADER <= dataView.byteLength) {
+      const count = dataView.getUint16(offset, true);
+      const pageSize = this.COLUMNAR_PAGE_HEADER + count * (recordSize - 1);
+      if (count === 0 || offset + pageSize > dataView.byteLength) {
+        corrupted = true;
+        break;
+      }
+
+      const timestamps = offset + this.COLUMNAR_PAGE_HEADER;
+      const flags = timestamps + count * 4 * (channelCount + 1);
+      for (let i = 0; i < count; i++) {
+        const record = { timestamp: dataView.getUint32(timestamps + i * 4, true) };
+        for (let c = 0; c < 6; c++) {
+          record[this.CHANNEL_KEYS[c]] = slots[c] < 0 ? null
+            : dataView.getFloat32(timestamps + count * 4 * (slots[c] + 1) + i * 4, true);
+        }
+        record.flags = dataView.getUint8(flags + i);
+        records.push(record);
+      }
+      offset += pageSize;
+    }
+
+    return {
+      records: records,
+      recordCount: records.length,
+      corrupted: corrupted || offset !== dataView.byteLength
+    };
+  }
+}
+
+// Decode time for all channels against one channel, in both page layouts, on synthetic
+// data. Run from the browser console: benchmarkDecode() or benchmarkDecode(200000).
+function benchmarkDecode(recordCount = 100000) {
+  const decoder = new MPULogDecoder();
+  const recordSize = 30;
+  const pageRecords = 8;
+  const results = [];
+
+  [decoder.LAYOUT_RECORDS, decoder.LAYOUT_COLUMNAR].forEach(layout => {
+    const pages = Math.ceil(recordCount / pageRecords);
+    const size = layout === decoder.LAYOUT_COLUMNAR
+      ? decoder.HEADER_SIZE + pages * decoder.COLUMNAR_PAGE_HEADER + recordCount * (recordSize - 1)
+      : decoder.HEADER_SIZE + recordCount * recordSize;
+    const dataView = new DataView(new ArrayBuffer(size));
+    dataView.setUint32(0, decoder.HEADER_MAGIC, true);
+    dataView.setUint8(4, 1);
+    dataView.setUint8(5, 0x3F);
+    dataView.setUint8(6, recordSize);
+    dataView.setUint8(7, layout);
+
+    let offset = decoder.HEADER_SIZE;
+    for (let first = 0; first < recordCount; first += pageRecords) {
+      const count = Math.min(pageRecords, recordCount - first);
+      if (layout === decoder.LAYOUT_COLUMNAR) {
+        dataView.setUint16(offset, count, true);
+        offset += decoder.COLUMNAR_PAGE_HEADER;
+      }
+      for (let i = 0; i < count; i++) {
+        const base = layout === decoder.LAYOUT_COLUMNAR ? offset + i * 4 : offset + i * recordSize;
+        const stride = layout === decoder.LAYOUT_COLUMNAR ? count * 4 : 4;
+        dataView.setUint32(base, (first + i) * 10, true);
+        for (let c = 0; c < 6; c++) {
+          dataView.setFloat32(base + (c + 1) * stride, Math.sin((first + i) / 50 + c), true);
+        }
+      }
+      offset += count * (layout === decoder.LAYOUT_COLUMNAR ? recordSize - 1 : recordSize);
+    }
+
+    [null, ['accel_z']].forEach(channels => {
+      const start = performance.now();
+      const decoded = decoder.decodeMaskedFile(dataView, channels);
+      results.push({
+        layout: layout === decoder.LAYOUT_COLUMNAR ? 'columnar' : 'records',
+        channels: channels ? channels.join(',') : 'all',
+        records: decoded.records.length,
+        ms: +(performance.now() - start).toFixed(1)
+      });
+    });
+  });
+
+  console.table(results);
+  return results;
+}
+
+// Format a channel value that may be null in channel-masked logs
+function formatValue(value, digits) {
+  return value == null ? '' : value.toFixed(digits);
 }
 
 // Helper function to calculate optimal Y-axis range with proper rounding
@@ -55,13 +313,21 @@ function calculateOptimalYRange(dataSeries) {
   dataSeries.forEach(series => {
     if (!series || series.length === 0) return;
     
-    const seriesMin = Math.min(...series);
-    const seriesMax = Math.max(...series);
+    // Unlogged channels in masked files are all null
+    const values = series.filter(v => v != null);
+    if (values.length === 0) return;
+    
+    const seriesMin = Math.min(...values);
+    const seriesMax = Math.max(...values);
     
     if (seriesMin < globalMin) globalMin = seriesMin;
     if (seriesMax > globalMax) globalMax = seriesMax;
   });
 
+  if (globalMin === Infinity) {
+    return { min: 0, max: 1 };
+  }
+
   // If all values are the same, create a small range around that value
   if (Math.abs(globalMax - globalMin) < 0.001) {
     const center = globalMin;
@@ -137,11 +403,18 @@ function roundToNice(value) {
   return value < 0 ? -niceValue : niceValue;
 }
 
+// MPULogRecord::FLAG_DEADBAND
+const DEADBAND_FLAG = 4;
+
+// MPULogRecord::FLAG_BURST
+const BURST_FLAG = 8;
+
 // Global variables
 let decoder = new MPULogDecoder();
 let currentData = null;
 let accelPlot = null;
 let orientationPlot = null;
+let plotLayout = null; // 'raw', 'stepped' (deadband log) or 'summary' (min/max bands)
 let fileList = [];
 let currentZoomRange = { accel: null, orientation: null };
 let defaultZoomRanges = { accel: { min: -10, max: 10 }, orientation: { min: -180, max: 180 } };
@@ -215,8 +488,8 @@ function updateFileSelect() {
   const select = document.getElementById('file-select');
   select.innerHTML = '<option value="">Select a file...</option>';
   
-  // Filter to only show .bin files
-  fileList.filter(file => file.name.endsWith('.bin')).forEach(file => {
+  // Filter to only show raw (.bin), summary (.sum) and min/max pyramid (.p16/.p256/.p4096) files
+  fileList.filter(file => file.name.endsWith('.bin') || file.name.endsWith('.sum') || decoder.pyramidFactor(file.name)).forEach(file => {
     const option = document.createElement('option');
     option.value = file.name;
     option.textContent = `${file.name} (${formatFileSize(file.size)})`;
@@ -250,9 +523,10 @@ async function handleLocalFileSelection(event) {
   const file = event.target.files[0];
   if (!file) return;
   
-  // Check if it's a .bin file
-  if (!file.name.toLowerCase().endsWith('.bin')) {
-    updateStatus('Please select a .bin file', 'warning');
+  // Check if it's a raw or summary log file
+  const lowerName = file.name.toLowerCase();
+  if (!lowerName.endsWith('.bin') && !lowerName.endsWith('.sum') && !decoder.pyramidFactor(lowerName)) {
+    updateStatus('Please select a .bin, .sum or pyramid (.p16/.p256/.p4096) file', 'warning');
     return;
   }
 
@@ -266,7 +540,7 @@ async function handleLocalFileSelection(event) {
     updateProgress(50);
     
     // Decode binary data using existing decoder
-    const decodedData = await decoder.decodeFile(arrayBuffer);
+    const decodedData = await decoder.decode(arrayBuffer, file.name);
     updateProgress(75);
     
     if (decodedData.records.length === 0) {
@@ -382,7 +656,7 @@ async function loadSelectedFile() {
     updateProgress(50);
     
     // Decode binary data
-    const decodedData = await decoder.decodeFile(arrayBuffer);
+    const decodedData = await decoder.decode(arrayBuffer, filename);
     updateProgress(75);
     
     if (decodedData.records.length === 0) {
@@ -421,6 +695,16 @@ async function loadSelectedFile() {
   }
 }
 
+// Deletes are queued by the logger; poll until the command has run
+async function waitForCommand(data) {
+  while (data.status === 'queued') {
+    await new Promise(resolve => setTimeout(resolve, 500));
+    const response = await fetch(`/api/commands?id=${data.id}`);
+    data = await response.json();
+  }
+  return data;
+}
+
 // Delete selected file
 async function deleteSelectedFile() {
   const filename = document.getElementById('file-select').value;
@@ -434,7 +718,7 @@ async function deleteSelectedFile() {
   
   try {
     const response = await fetch(`${filename.startsWith('/') ? filename : '/' + filename}`, { method: 'DELETE' });
-    const data = await response.json();
+    const data = await waitForCommand(await response.json());
     
     if (data.status === 'ok') {
       updateStatus(`Successfully deleted ${filename}`, 'success');
@@ -490,6 +774,25 @@ function displayData(decodedData) {
     originalTimestamps: timestamps // Keep for reference
   };
 
+  // Summary files carry a min/max band per channel. Deadband logs only hold a record when a
+  // value changed, so they are drawn as steps. Either changes the series layout, so rebuild.
+  let layout = 'raw';
+  if (decodedData.summary) {
+    layout = 'summary';
+    chartData.min = [0, 1, 2, 3, 4, 5].map(c => records.map(r => r.min[c]));
+    chartData.max = [0, 1, 2, 3, 4, 5].map(c => records.map(r => r.max[c]));
+  } else if (records.some(r => r.flags & DEADBAND_FLAG)) {
+    layout = 'stepped';
+    chartData.stepped = true;
+  }
+  if (accelPlot && plotLayout !== layout) {
+    accelPlot.destroy();
+    orientationPlot.destroy();
+    accelPlot = null;
+    orientationPlot = null;
+  }
+  plotLayout = layout;
+
   // Initialize or update plots
   if (!accelPlot) {
     initPlots(chartData);
@@ -517,9 +820,98 @@ function getSize(elementId) {
   };
 }
 
+// uPlot series, bands and data arrays for one summary chart: each channel is drawn as its
+// mean with a shaded band between the window minimum and maximum.
+function buildSummaryPlot(data, names, colors, fills, first) {
+  const series = [{
+    label: "Time (seconds)",
+    value: (u, v) => v != null ? v.toFixed(2) + "s" : "",
+  }];
+  const bands = [];
+  const arrays = [data.relativeTime];
+
+  names.forEach((name, i) => {
+    const c = first + i;
+    const meanIndex = series.length;
+    series.push({ label: name, stroke: colors[i], width: 1, points: { show: false } });
+    series.push({ label: name + " max", stroke: fills[i], width: 0, points: { show: false } });
+    series.push({ label: name + " min", stroke: fills[i], width: 0, points: { show: false } });
+    bands.push({ series: [meanIndex + 1, meanIndex + 2], fill: fills[i] });
+    arrays.push(data[['accelX', 'accelY', 'accelZ', 'yaw', 'pitch', 'roll'][c]], data.max[c], data.min[c]);
+  });
+
+  return { series: series, bands: bands, arrays: arrays };
+}
+
+function initSummaryPlots(data) {
+  const dims = getSize('accel-plot');
+  const groups = [
+    { element: 'accel-plot', names: ["Accel X", "Accel Y", "Accel Z"], first: 0,
+      colors: ["#ff6b6b", "#4ecdc4", "#45b7d1"],
+      fills: ["rgba(255,107,107,0.2)", "rgba(78,205,196,0.2)", "rgba(69,183,209,0.2)"] },
+    { element: 'gyros-plot', names: ["Yaw", "Pitch", "Roll"], first: 3,
+      colors: ["#ff9f43", "#10ac84", "#5f27cd"],
+      fills: ["rgba(255,159,67,0.2)", "rgba(16,172,132,0.2)", "rgba(95,39,205,0.2)"] }
+  ];
+
+  const plots = groups.map(group => {
+    const plot = buildSummaryPlot(data, group.names, group.colors, group.fills, group.first);
+    const range = calculateOptimalYRange(plot.arrays.slice(1));
+
+    return new uPlot({
+      width: dims.width,
+      height: dims.height,
+      scales: {
+        x: {
+          time: false
+        },
+        y: {
+          range: [range.min, range.max],
+          align: 1
+        }
+      },
+      series: plot.series,
+      bands: plot.bands,
+      axes: [
+        {
+          stroke: "#666",
+          grid: { show: false },
+          label: "Time (seconds)",
+          size: 60
+        },
+        {
+          stroke: "#666",
+          grid: { show: true },
+          size: 50
+        }
+      ],
+      cursor: {
+        sync: {
+          key: "cursor",
+          setSeries: true,
+        },
+        focus: {
+          prox: 30,
+        },
+      }
+    }, plot.arrays, document.getElementById(group.element));
+  });
+
+  accelPlot = plots[0];
+  orientationPlot = plots[1];
+}
+
 // Initialize uPlot charts
 function initPlots(data) {
+  if (data.min) {
+    initSummaryPlots(data);
+    return;
+  }
+
   const dims = getSize('accel-plot');
+  
+  // Deadband records hold their value until the next one
+  const linePaths = data.stepped ? uPlot.paths.stepped({ align: 1 }) : undefined;
 
   // Calculate auto-scaled Y-axis range for acceleration data
   const accelRange = calculateOptimalYRange([data.accelX, data.accelY, data.accelZ]);
@@ -546,19 +938,22 @@ function initPlots(data) {
         label: "Accel X",
         stroke: "#ff6b6b",
         width: 1,
-        points: { show: false }
+        points: { show: false },
+        paths: linePaths
       },
       {
         label: "Accel Y", 
         stroke: "#4ecdc4",
         width: 1,
-        points: { show: false }
+        points: { show: false },
+        paths: linePaths
       },
       {
         label: "Accel Z",
         stroke: "#45b7d1", 
         width: 1,
-        points: { show: false }
+        points: { show: false },
+        paths: linePaths
       }
     ],
     axes: [
@@ -615,19 +1010,22 @@ function initPlots(data) {
         label: "Yaw",
         stroke: "#ff9f43",
         width: 1,
-        points: { show: false }
+        points: { show: false },
+        paths: linePaths
       },
       {
         label: "Pitch",
         stroke: "#10ac84",
         width: 1,
-        points: { show: false }
+        points: { show: false },
+        paths: linePaths
       },
       {
         label: "Roll",
         stroke: "#5f27cd",
         width: 1,
-        points: { show: false }
+        points: { show: false },
+        paths: linePaths
       }
     ],
     axes: [
@@ -662,6 +1060,14 @@ function initPlots(data) {
 
 // Update existing plots with new data
 function updatePlots(data) {
+  if (data.min) {
+    // Summary plots are cheap to rebuild and keep their band layout that way
+    accelPlot.destroy();
+    orientationPlot.destroy();
+    initSummaryPlots(data);
+    return;
+  }
+
   if (accelPlot) {
     // Calculate new Y-axis range for acceleration data
     const accelRange = calculateOptimalYRange([data.accelX, data.accelY, data.accelZ]);
@@ -845,6 +1251,19 @@ function downloadAsCSV() {
 
   // Use current file name (works for both server and local files)
   const filename = currentLocalFileName || document.getElementById('file-select').value;
+
+  // Raw logs on the logger are converted there as they download, so nothing is built in memory
+  if (!currentLocalFileName && filename.endsWith('.bin')) {
+    const name = filename.replace(/^\//, '');
+    const a = document.createElement('a');
+    a.href = `/api/files/${name.replace('.bin', '.csv')}`;
+    a.download = name.replace('.bin', '_data.csv');
+    document.body.appendChild(a);
+    a.click();
+    document.body.removeChild(a);
+    updateStatus(`Downloading ${name} as CSV`, 'success');
+    return;
+  }
   
   // Always export all records (same as JSON export behavior)
   const records = currentData.records;
@@ -869,12 +1288,12 @@ function downloadAsCSV() {
     const row = [
       relativeTime[i].toFixed(3),                    // Time (s) - 3 decimal places
       interSampleDelay.toFixed(3),                    // Delay (s) - 3 decimal places
-      record.accel_x.toFixed(4),                      // Accel X (G) - 4 decimal places
-      record.accel_y.toFixed(4),                      // Accel Y (G) - 4 decimal places
-      record.accel_z.toFixed(4),                      // Accel Z (G) - 4 decimal places
-      record.yaw.toFixed(2),                          // Yaw (°) - 2 decimal places
-      record.pitch.toFixed(2),                        // Pitch (°) - 2 decimal places
-      record.roll.toFixed(2),                         // Roll (°) - 2 decimal places
+      formatValue(record.accel_x, 4),                 // Accel X (G) - 4 decimal places
+      formatValue(record.accel_y, 4),                 // Accel Y (G) - 4 decimal places
+      formatValue(record.accel_z, 4),                 // Accel Z (G) - 4 decimal places
+      formatValue(record.yaw, 2),                     // Yaw (°) - 2 decimal places
+      formatValue(record.pitch, 2),                   // Pitch (°) - 2 decimal places
+      formatValue(record.roll, 2),                    // Roll (°) - 2 decimal places
       record.flags                                     // Flags - integer
     ];
     
@@ -915,12 +1334,28 @@ function updateFileInfo(file, decodedData) {
   const duration = decodedData.records.length > 0 ? 
     (decodedData.records[decodedData.records.length - 1].timestamp - decodedData.records[0].timestamp) / 1000 : 0;
   
+  if (decodedData.summary) {
+    const records = decodedData.records;
+    const windowSec = records.length > 1 ? (records[1].timestamp - records[0].timestamp) / 1000 : 0;
+    const samples = records.reduce((total, r) => total + r.sampleCount, 0);
+    infoEl.innerHTML = `
+      File: ${file.name} (${decodedData.pyramidFactor ? `1:${decodedData.pyramidFactor} min/max` : 'summary'}) | 
+      Size: ${formatFileSize(file.size)} | 
+      Windows: ${records.length} x ${windowSec.toFixed(decodedData.pyramidFactor ? 2 : 0)}s | 
+      Samples: ${samples} | 
+      Duration: ${(duration + windowSec).toFixed(1)}s
+      ${decodedData.corrupted ? ' | ⚠️ Some data may be corrupted' : ''}
+    `;
+    return;
+  }
+  
   infoEl.innerHTML = `
     File: ${file.name} | 
     Size: ${formatFileSize(file.size)} | 
     Records: ${decodedData.records.length} | 
     Duration: ${duration.toFixed(1)}s |
-    Sample Rate: ${(decodedData.records.length / Math.max(duration, 1)).toFixed(1)} Hz
+    ${decodedData.records.some(r => r.flags & DEADBAND_FLAG) ? 'Deadband log' : `Sample Rate: ${(decodedData.records.length / Math.max(duration, 1)).toFixed(1)} Hz`}
+    ${decodedData.records.some(r => r.flags & BURST_FLAG) ? ' | Burst capture' : ''}
     ${decodedData.corrupted ? ' | ⚠️ Some data may be corrupted' : ''}
   `;
 }
@@ -949,6 +1384,7 @@ function clearCharts() {
     orientationPlot.destroy();
     orientationPlot = null;
   }
+  plotLayout = null;
   document.getElementById('charts').style.display = 'none';
   document.getElementById('table-container').style.display = 'none';
   document.getElementById('file-info').innerHTML = '';
@@ -61,12 +61,12 @@ function updateTable() {
     tr.innerHTML = `
       <td>${row.relativeTime.toFixed(3)}</td>
       <td>${row.interSampleDelay}</td>
-      <td>${row.accel_x.toFixed(4)}</td>
-      <td>${row.accel_y.toFixed(4)}</td>
-      <td>${row.accel_z.toFixed(4)}</td>
-      <td>${row.yaw.toFixed(2)}</td>
-      <td>${row.pitch.toFixed(2)}</td>
-      <td>${row.roll.toFixed(2)}</td>
+      <td>${formatValue(row.accel_x, 4)}</td>
+      <td>${formatValue(row.accel_y, 4)}</td>
+      <td>${formatValue(row.accel_z, 4)}</td>
+      <td>${formatValue(row.yaw, 2)}</td>
+      <td>${formatValue(row.pitch, 2)}</td>
+      <td>${formatValue(row.roll, 2)}</td>
       <td>${row.flags}</td>
     `;
     tbody.appendChild(tr);
@@ -0,0 +1,198 @@
+#include "BiquadFilter.h"
+#include <math.h>
+#include <string.h>
+
+static const float Q30 = 1073741824.0f;
+
+BiquadFilter::BiquadFilter()
+  : sectionCount(0),
+    rejectedSections(0),
+    sampleRateHz(0) {
+  reset();
+}
+
+uint8_t BiquadFilter::configure(const FilterSectionConfig* configs, uint8_t count, float sampleRateHz) {
+  this->sampleRateHz = sampleRateHz;
+  sectionCount = 0;
+  rejectedSections = 0;
+  
+  for (uint8_t i = 0; i < count && i < FILTER_MAX_SECTIONS; i++) {
+    if (configs[i].type == FILTER_NONE) {
+      continue;
+    }
+    
+    Section& section = sections[sectionCount];
+    section.config = configs[i];
+    if (design(section, sampleRateHz)) {
+      sectionCount++;
+    } else {
+      rejectedSections |= 1 << i;
+    }
+  }
+  
+  reset();
+  return sectionCount;
+}
+
+void BiquadFilter::reset() {
+  memset(state, 0, sizeof(state));
+}
+
+bool BiquadFilter::design(Section& section, float sampleRateHz) {
+  const FilterSectionConfig& config = section.config;
+  if (config.frequencyHz <= 0 || config.frequencyHz >= sampleRateHz / 2 || config.q <= 0) {
+    return false;
+  }
+  
+  // RBJ audio EQ cookbook
+  const float w0 = 2.0f * M_PI * config.frequencyHz / sampleRateHz;
+  const float cosW0 = cosf(w0);
+  const float alpha = sinf(w0) / (2.0f * config.q);
+  float b0, b1, b2;
+  
+  switch (config.type) {
+    case FILTER_LOWPASS:
+      b0 = (1.0f - cosW0) / 2.0f;
+      b1 = 1.0f - cosW0;
+      b2 = b0;
+      break;
+    case FILTER_HIGHPASS:
+      b0 = (1.0f + cosW0) / 2.0f;
+      b1 = -(1.0f + cosW0);
+      b2 = b0;
+      break;
+    case FILTER_BANDPASS:
+      b0 = alpha;   // 0dB peak gain
+      b1 = 0;
+      b2 = -alpha;
+      break;
+    case FILTER_NOTCH:
+      b0 = 1.0f;
+      b1 = -2.0f * cosW0;
+      b2 = 1.0f;
+      break;
+    default:
+      return false;
+  }
+  
+  const float a0 = 1.0f + alpha;
+  section.b[0] = b0 / a0;
+  section.b[1] = b1 / a0;
+  section.b[2] = b2 / a0;
+  section.a[0] = 1.0f;
+  section.a[1] = -2.0f * cosW0 / a0;
+  section.a[2] = (1.0f - alpha) / a0;
+  
+  // Every coefficient of a stable section is within +/-2, which Q30 just holds
+  section.b0 = (int32_t)lroundf(section.b[0] * Q30);
+  section.b1 = (int32_t)lroundf(section.b[1] * Q30);
+  section.b2 = (int32_t)lroundf(section.b[2] * Q30);
+  section.a1 = (int32_t)lroundf(section.a[1] * Q30);
+  section.a2 = (int32_t)lroundf(section.a[2] * Q30);
+  return true;
+}
+
+int32_t BiquadFilter::processSection(const Section& section, int64_t sectionState[2], int32_t x) {
+  // Direct Form II Transposed: y = b0*x + s1; s1 = b1*x - a1*y + s2; s2 = b2*x - a2*y.
+  // The fed-back y keeps FILTER_FRACTION_BITS below the sample LSB: with poles close to
+  // z = 1 (low cutoffs) the rounding error of y is amplified by 1 / (1 + a1 + a2).
+  const int32_t xf = x << FILTER_FRACTION_BITS;
+  const int64_t acc = (int64_t)section.b0 * xf + sectionState[0];
+  const int32_t yf = (int32_t)((acc + (1LL << 29)) >> 30);
+  sectionState[0] = (int64_t)section.b1 * xf - (int64_t)section.a1 * yf + sectionState[1];
+  sectionState[1] = (int64_t)section.b2 * xf - (int64_t)section.a2 * yf;
+  return (yf + (1 << (FILTER_FRACTION_BITS - 1))) >> FILTER_FRACTION_BITS;
+}
+
+void BiquadFilter::process(int32_t values[CHANNELS]) {
+  for (uint8_t s = 0; s < sectionCount; s++) {
+    const Section& section = sections[s];
+    for (uint8_t c = 0; c < CHANNELS; c++) {
+      if (section.config.channelMask & (1 << c)) {
+        values[c] = processSection(section, state[s][c], values[c]);
+      }
+    }
+  }
+}
+
+uint8_t BiquadFilter::getRejectedSections() const {
+  return rejectedSections;
+}
+
+uint8_t BiquadFilter::getActiveSections() const {
+  return sectionCount;
+}
+
+const FilterSectionConfig& BiquadFilter::getSectionConfig(uint8_t section) const {
+  return sections[section].config;
+}
+
+float BiquadFilter::designResponse(uint8_t section, float frequencyHz) const {
+  const Section& s = sections[section];
+  const float w = 2.0f * M_PI * frequencyHz / sampleRateHz;
+  
+  // |B(e^jw)| / |A(e^jw)|
+  float numRe = s.b[0] + s.b[1] * cosf(w) + s.b[2] * cosf(2 * w);
+  float numIm = -(s.b[1] * sinf(w) + s.b[2] * sinf(2 * w));
+  float denRe = 1.0f + s.a[1] * cosf(w) + s.a[2] * cosf(2 * w);
+  float denIm = -(s.a[1] * sinf(w) + s.a[2] * sinf(2 * w));
+  return sqrtf((numRe * numRe + numIm * numIm) / (denRe * denRe + denIm * denIm));
+}
+
+float BiquadFilter::measuredResponse(uint8_t section, float frequencyHz) const {
+  // Drive a fresh copy of the section state with a sine and compare output and input RMS once settled
+  const int32_t amplitude = FILTER_SELFTEST_AMPLITUDE;
+  const uint32_t settle = FILTER_SELFTEST_SETTLE_SAMPLES;
+  // The work is bounded, as it runs without yielding: whole periods up to the measure limit,
+  // or a part of one for frequencies too low to fit a period in
+  const uint32_t period = (uint32_t)(sampleRateHz / frequencyHz) + 1;
+  const uint32_t measure = period < FILTER_SELFTEST_MEASURE_SAMPLES
+    ? FILTER_SELFTEST_MEASURE_SAMPLES / period * period : FILTER_SELFTEST_MEASURE_SAMPLES;
+  
+  int64_t testState[2] = {0, 0};
+  float inputPower = 0;
+  float outputPower = 0;
+  for (uint32_t n = 0; n < settle + measure; n++) {
+    int32_t x = (int32_t)lroundf(amplitude * sinf(2.0f * M_PI * frequencyHz * n / sampleRateHz));
+    int32_t y = processSection(sections[section], testState, x);
+    if (n >= settle) {
+      inputPower += (float)x * x;
+      outputPower += (float)y * y;
+    }
+  }
+  return inputPower > 0 ? sqrtf(outputPower / inputPower) : 0;
+}
+
+const char* BiquadFilter::typeName(uint8_t type) {
+  switch (type) {
+    case FILTER_LOWPASS:
+      return "lowpass";
+    case FILTER_HIGHPASS:
+      return "highpass";
+    case FILTER_BANDPASS:
+      return "bandpass";
+    case FILTER_NOTCH:
+      return "notch";
+    default:
+      return "none";
+  }
+}
+
+uint8_t BiquadFilter::typeFromName(const char* name) {
+  if (name == nullptr) {
+    return FILTER_NONE;
+  }
+  if (strcmp(name, "lowpass") == 0) {
+    return FILTER_LOWPASS;
+  }
+  if (strcmp(name, "highpass") == 0) {
+    return FILTER_HIGHPASS;
+  }
+  if (strcmp(name, "bandpass") == 0) {
+    return FILTER_BANDPASS;
+  }
+  if (strcmp(name, "notch") == 0) {
+    return FILTER_NOTCH;
+  }
+  return FILTER_NONE;
+}
@@ -0,0 +1,80 @@
+#ifndef BIQUAD_FILTER_H
+#define BIQUAD_FILTER_H
+
+#include <stdint.h>
+#include "constants.h"
+
+enum FilterType : uint8_t {
+  FILTER_NONE = 0,
+  FILTER_LOWPASS = 1,
+  FILTER_HIGHPASS = 2,
+  FILTER_BANDPASS = 3,
+  FILTER_NOTCH = 4
+};
+
+// One configured section, as stored in settings.json
+struct FilterSectionConfig {
+  uint8_t type = FILTER_NONE;
+  uint8_t channelMask = FILTER_ALL_CHANNELS;  // Bit 0-2 accel X/Y/Z, bit 3-5 gyro X/Y/Z
+  float frequencyHz = 0;                      // Cutoff, centre or notch frequency
+  float q = 0.7071f;
+};
+
+/**
+ * Chain of up to FILTER_MAX_SECTIONS biquad sections applied to the six fixed-point
+ * sensor channels. Each section applies to the channels in its mask, so every channel
+ * has its own chain of up to FILTER_MAX_SECTIONS sections.
+ *
+ * Coefficients follow the RBJ audio EQ cookbook designs, are computed on-device in float
+ * and quantised to Q30. Samples run through Direct Form II Transposed with int64 state,
+ * so the hot path is integer only. Nothing here needs the Arduino core, so
+ * tools/filter_benchmark.cpp builds it on the host.
+ */
+class BiquadFilter {
+  public:
+    static const uint8_t CHANNELS = 6;
+    
+    BiquadFilter();
+    
+    // Design every section for the given sample rate. Sections of an unknown type or with a
+    // frequency outside (0, sampleRate/2) are skipped. Returns the number of active sections.
+    uint8_t configure(const FilterSectionConfig* configs, uint8_t count, float sampleRateHz);
+    
+    // Bit i set for each config the last configure() skipped as invalid
+    uint8_t getRejectedSections() const;
+    void reset();
+    
+    // Filter one sample of all six channels in place
+    void process(int32_t values[CHANNELS]);
+    
+    uint8_t getActiveSections() const;
+    const FilterSectionConfig& getSectionConfig(uint8_t section) const;
+    
+    // Magnitude response of one section from its unquantised design (the reference)
+    float designResponse(uint8_t section, float frequencyHz) const;
+    
+    // Measured gain of the fixed-point section for a sine of the given frequency
+    float measuredResponse(uint8_t section, float frequencyHz) const;
+    
+    static const char* typeName(uint8_t type);
+    static uint8_t typeFromName(const char* name);
+    
+  private:
+    struct Section {
+      FilterSectionConfig config;
+      float b[3];                   // Normalised float design, a0 = 1
+      float a[3];
+      int32_t b0, b1, b2, a1, a2;   // Q30
+    };
+    
+    Section sections[FILTER_MAX_SECTIONS];
+    int64_t state[FILTER_MAX_SECTIONS][CHANNELS][2];
+    uint8_t sectionCount;
+    uint8_t rejectedSections;
+    float sampleRateHz;
+    
+    static bool design(Section& section, float sampleRateHz);
+    static int32_t processSection(const Section& section, int64_t sectionState[2], int32_t x);
+};
+
+#endif
@@ -0,0 +1,136 @@
+#include "BurstCapture.h"
+
+BurstCapture::BurstCapture() {
+}
+
+BurstCapture::~BurstCapture() {
+  release();
+}
+
+bool BurstCapture::arm(uint32_t durationMs) {
+  if (isBusy()) {
+    return false;
+  }
+  
+  this->durationMs = constrain(durationMs, (uint32_t)1, (uint32_t)BURST_MAX_DURATION_MS);
+  sampleCount = 0;
+  overflows = 0;
+  fileName = "";
+  state = BURST_ARMED;
+  return true;
+}
+
+bool BurstCapture::allocate() {
+  release();
+  
+  // Leave a reserve for the network stack and never ask for more than one free block
+  uint32_t freeHeap = ESP.getFreeHeap();
+  uint32_t available = freeHeap > BURST_HEAP_RESERVE ? freeHeap - BURST_HEAP_RESERVE : 0;
+  uint32_t block = ESP.getMaxFreeBlockSize();
+  if (available > block) {
+    available = block;
+  }
+  
+  capacity = durationMs * BURST_RATE_HZ / 1000;
+  if (capacity > available / (6 * sizeof(int16_t))) {
+    capacity = available / (6 * sizeof(int16_t));
+  }
+  if (capacity == 0) {
+    return false;
+  }
+  
+  samples = (int16_t*)malloc(capacity * 6 * sizeof(int16_t));
+  if (samples == nullptr) {
+    capacity = 0;
+    return false;
+  }
+  return true;
+}
+
+void BurstCapture::release() {
+  free(samples);
+  samples = nullptr;
+}
+
+bool BurstCapture::add(const uint8_t* fifoSample) {
+  if (isFull()) {
+    return false;
+  }
+  
+  int16_t* out = samples + sampleCount * 6;
+  for (uint8_t i = 0; i < 6; i++) {
+    out[i] = (int16_t)((fifoSample[2 * i] << 8) | fifoSample[2 * i + 1]);
+  }
+  sampleCount++;
+  return true;
+}
+
+void BurstCapture::getSample(uint32_t index, int16_t accel[3], int16_t gyro[3]) const {
+  const int16_t* sample = samples + index * 6;
+  for (uint8_t i = 0; i < 3; i++) {
+    accel[i] = sample[i];
+    gyro[i] = sample[3 + i];
+  }
+}
+
+BurstCapture::State BurstCapture::getState() const {
+  return state;
+}
+
+void BurstCapture::setState(State state) {
+  this->state = state;
+}
+
+bool BurstCapture::isBusy() const {
+  return state == BURST_ARMED || state == BURST_CAPTURING || state == BURST_CAPTURED || state == BURST_WRITING;
+}
+
+bool BurstCapture::isFull() const {
+  return samples == nullptr || sampleCount >= capacity;
+}
+
+uint32_t BurstCapture::getSampleCount() const {
+  return sampleCount;
+}
+
+uint32_t BurstCapture::getCapacity() const {
+  return capacity;
+}
+
+uint32_t BurstCapture::getStartMillis() const {
+  return startMillis;
+}
+
+void BurstCapture::setStartMillis(uint32_t startMillis) {
+  this->startMillis = startMillis;
+}
+
+void BurstCapture::markOverflow() {
+  overflows++;
+}
+
+void BurstCapture::setFileName(const String& fileName) {
+  this->fileName = fileName;
+}
+
+void BurstCapture::writeStatusJSON(JsonWriter& json) const {
+  json.add("state", stateName(state));
+  json.add("rateHz", BURST_RATE_HZ);
+  json.add("durationMs", durationMs);
+  json.add("samples", sampleCount);
+  json.add("capacity", capacity);
+  json.add("fifoOverflows", overflows);
+  json.add("file", fileName);
+}
+
+const char* BurstCapture::stateName(State state) {
+  switch (state) {
+    case BURST_ARMED: return "armed";
+    case BURST_CAPTURING: return "capturing";
+    case BURST_CAPTURED: return "captured";
+    case BURST_WRITING: return "writing";
+    case BURST_COMMITTED: return "committed";
+    case BURST_FAILED: return "failed";
+    default: return "idle";
+  }
+}
@@ -0,0 +1,64 @@
+#ifndef BURST_CAPTURE_H
+#define BURST_CAPTURE_H
+
+#include <Arduino.h>
+#include "constants.h"
+#include "JsonWriter.h"
+
+// Raw samples of one RAM burst capture. MPUSensorTask fills a heap arena from the sensor
+// FIFO at BURST_RATE_HZ without touching flash, then DataLoggingTask writes it to a log
+// file and frees it. The arena is sized when the burst is armed from the free heap.
+class BurstCapture {
+  public:
+    enum State {
+      BURST_IDLE,
+      BURST_ARMED,             // Requested, starts on the next sensor run
+      BURST_CAPTURING,
+      BURST_CAPTURED,          // Waiting for DataLoggingTask
+      BURST_WRITING,
+      BURST_COMMITTED,         // Written to fileName
+      BURST_FAILED
+    };
+    
+    BurstCapture();
+    ~BurstCapture();
+    
+    // Arms a capture of up to durationMs. False while another burst is in progress.
+    bool arm(uint32_t durationMs);
+    
+    // Allocates the arena for the armed duration, or as much as the heap allows
+    bool allocate();
+    void release();
+    
+    // Adds one big-endian FIFO sample. False once the arena is full.
+    bool add(const uint8_t* fifoSample);
+    void getSample(uint32_t index, int16_t accel[3], int16_t gyro[3]) const;
+    
+    State getState() const;
+    void setState(State state);
+    bool isBusy() const;
+    bool isFull() const;
+    
+    uint32_t getSampleCount() const;
+    uint32_t getCapacity() const;
+    uint32_t getStartMillis() const;
+    void setStartMillis(uint32_t startMillis);
+    void markOverflow();
+    void setFileName(const String& fileName);
+    
+    void writeStatusJSON(JsonWriter& json) const;
+    
+  private:
+    State state = BURST_IDLE;
+    uint32_t durationMs = BURST_DEFAULT_DURATION_MS;
+    int16_t* samples = nullptr;  // accel X/Y/Z, gyro X/Y/Z raw counts per sample
+    uint32_t capacity = 0;
+    uint32_t sampleCount = 0;
+    uint32_t startMillis = 0;
+    uint16_t overflows = 0;
+    String fileName;
+    
+    static const char* stateName(State state);
+};
+
+#endif
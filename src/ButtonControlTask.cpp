@@ -1,4 +1,5 @@
 #include "ButtonControlTask.h"
+#include "DebugOutput.h"
 
 ButtonControlTask::ButtonControlTask(DataLoggingTask& dataLogger, BuzzerFeedbackTask& buzzerTask, MPUSensorTask& sensorTask) 
   : dataLogger(&dataLogger), buzzerTask(&buzzerTask), sensorTask(&sensorTask) {
@@ -17,16 +18,25 @@ void ButtonControlTask::run() {
     
     switch (event) {
       case SHORT_PRESS:
-        Serial.println(F("BUTTON: Short press detected - toggling recording"));
+        // During a six-position calibration a short press captures the current face instead
+        if (sensorTask->isSixPositionActive()) {
+          debugOutput.println(F("BUTTON: Short press detected - capturing six-position orientation"));
+          if (sensorTask->captureSixPosition()) {
+            buzzerTask->playCalibrationStartTone();
+          }
+          break;
+        }
+        
+        debugOutput.println(F("BUTTON: Short press detected - toggling recording"));
         // Toggle recording state using DataLoggingTask
         dataLogger->toggleRecording();
         buzzerTask->playRecordingTone(!dataLogger->isRecording());
-        Serial.print(F("BUTTON: Recording state changed to: "));
-        Serial.println(dataLogger->isRecording() ? F("ON") : F("OFF"));
+        debugOutput.print(F("BUTTON: Recording state changed to: "));
+        debugOutput.println(dataLogger->isRecording() ? F("ON") : F("OFF"));
         break;
         
       case LONG_PRESS:
-        Serial.println(F("BUTTON: Long press detected - starting calibration"));
+        debugOutput.println(F("BUTTON: Long press detected - starting calibration"));
         // Start calibration using MPUSensorTask
         sensorTask->startCalibration();
         buzzerTask->playCalibrationStartTone();
@@ -66,9 +76,9 @@ void ButtonControlTask::updateButtonState() {
   unsigned long currentTime = millis();
   
   if(buttonState != prevButtonState){
-    Serial.print("BUTTON_PIN Changed Value: ");
-    if(buttonState == HIGH) Serial.println("HIGH");
-    if(buttonState == LOW) Serial.println("LOW");
+    Print& log = debugOutput.at(LOG_LEVEL_DEBUG);
+    log.print(F("BUTTON_PIN Changed Value: "));
+    log.println(buttonState == HIGH ? F("HIGH") : F("LOW"));
     prevButtonState = buttonState;
   }
   
@@ -82,7 +92,7 @@ void ButtonControlTask::updateButtonState() {
       if (!buttonState) {  // Button pressed (LOW due to INPUT_PULLUP)
         state = DEBOUNCE_PRESSED;
         lastDebounceTime = currentTime;
-        Serial.println(F("BUTTON: State changed to DEBOUNCE_PRESSED"));
+        debugOutput.at(LOG_LEVEL_DEBUG).println(F("BUTTON: State changed to DEBOUNCE_PRESSED"));
       }
       break;
       
@@ -91,11 +101,11 @@ void ButtonControlTask::updateButtonState() {
         if (currentTime - lastDebounceTime >= BUTTON_DEBOUNCE_MS) {
           state = PRESSED_HOLD;
           pressStartTime = currentTime;
-          Serial.println(F("BUTTON: State changed to PRESSED_HOLD"));
+          debugOutput.at(LOG_LEVEL_DEBUG).println(F("BUTTON: State changed to PRESSED_HOLD"));
         }
       } else {  // Released during debounce - treat as noise
         state = IDLE;
-        Serial.println(F("BUTTON: Noise detected, returning to IDLE"));
+        debugOutput.at(LOG_LEVEL_DEBUG).println(F("BUTTON: Noise detected, returning to IDLE"));
       }
       break;
       
@@ -104,7 +114,7 @@ void ButtonControlTask::updateButtonState() {
         state = DEBOUNCE_RELEASED;
         lastDebounceTime = currentTime;
         releaseTime = currentTime;
-        Serial.println(F("BUTTON: State changed to DEBOUNCE_RELEASED"));
+        debugOutput.at(LOG_LEVEL_DEBUG).println(F("BUTTON: State changed to DEBOUNCE_RELEASED"));
       } else {
         // Check for long press while holding
         if (currentTime - pressStartTime >= CALIBRATION_HOLD_MS) {
@@ -112,7 +122,7 @@ void ButtonControlTask::updateButtonState() {
           state = RELEASED_INHIBIT;  // Move to release debounce after generating event
           lastDebounceTime = currentTime;
           releaseTime = currentTime;
-          Serial.println(F("BUTTON: Long press detected, moving to DEBOUNCE_RELEASED"));
+          debugOutput.at(LOG_LEVEL_DEBUG).println(F("BUTTON: Long press detected, moving to DEBOUNCE_RELEASED"));
         }
       }
       break;
@@ -126,11 +136,11 @@ void ButtonControlTask::updateButtonState() {
             pendingEvent = SHORT_PRESS;
           }
           state = RELEASED_INHIBIT;
-          Serial.println(F("BUTTON: State changed to RELEASED_INHIBIT"));
+          debugOutput.at(LOG_LEVEL_DEBUG).println(F("BUTTON: State changed to RELEASED_INHIBIT"));
         }
       } else {  // Re-pressed during release debounce - treat as noise
         state = PRESSED_HOLD;
-        if(machineStateChanged) Serial.println(F("BUTTON: Noise detected during release debounce, returning to PRESSED_HOLD"));
+        if(machineStateChanged) debugOutput.at(LOG_LEVEL_DEBUG).println(F("BUTTON: Noise detected during release debounce, returning to PRESSED_HOLD"));
       }
       break;
       
@@ -139,12 +149,12 @@ void ButtonControlTask::updateButtonState() {
         if (currentTime - releaseTime >= BUTTON_RELEASE_INHIBIT_MS) {
           state = IDLE;
           pressStartTime = 0;
-          Serial.println(F("BUTTON: Inhibition period complete, returning to IDLE"));
+          debugOutput.at(LOG_LEVEL_DEBUG).println(F("BUTTON: Inhibition period complete, returning to IDLE"));
         }
       } else {  // Button pressed during inhibition - ignore and stay in inhibition
         // Reset release time to extend inhibition
         releaseTime = currentTime;
-        if(machineStateChanged) Serial.println(F("BUTTON: Press during inhibition ignored, extending inhibition period"));
+        if(machineStateChanged) debugOutput.at(LOG_LEVEL_DEBUG).println(F("BUTTON: Press during inhibition ignored, extending inhibition period"));
       }
       break;
   }
@@ -0,0 +1,71 @@
+#include "CommandQueue.h"
+
+const char* Command::typeName(Type type) {
+  switch (type) {
+    case RECORD_START: return "recordStart";
+    case RECORD_STOP: return "recordStop";
+    case CALIBRATE: return "calibrate";
+    case GENERATE_TEST_DATA: return "generateTestData";
+    case DELETE_FILE: return "deleteFile";
+    case SAVE_SETTINGS: return "saveSettings";
+    case CLEAR_TEMPCOMP: return "clearTempComp";
+    case RESET_RAINFLOW: return "resetRainflow";
+    case SPECTRUM_SELFTEST: return "spectrumSelfTest";
+    case RAINFLOW_SELFTEST: return "rainflowSelfTest";
+    case FILTER_SELFTEST: return "filterSelfTest";
+    default: return "";
+  }
+}
+
+const char* Command::stateName(State state) {
+  switch (state) {
+    case QUEUED: return "queued";
+    case DONE: return "ok";
+    default: return "error";
+  }
+}
+
+bool CommandQueue::isFull() const {
+  return (head + 1) % COMMAND_QUEUE_SIZE == tail;
+}
+
+uint16_t CommandQueue::push(Command::Type type, uint8_t option, const char* text) {
+  uint8_t next = (head + 1) % COMMAND_QUEUE_SIZE;
+  if (next == tail || (text && strlen(text) >= COMMAND_TEXT_MAX)) {
+    return 0;
+  }
+  
+  Command& command = ring[head];
+  command.id = nextId;
+  command.type = type;
+  command.state = Command::QUEUED;
+  command.option = option;
+  strcpy(command.text, text ? text : "");
+  command.message = nullptr;
+  
+  // The slot must be complete before the consumer can see it
+  __sync_synchronize();
+  head = next;
+  
+  // Ids wrap, skipping 0
+  nextId = nextId == 0xFFFF ? 1 : nextId + 1;
+  return command.id;
+}
+
+bool CommandQueue::pop(Command& command) {
+  if (tail == head) {
+    return false;
+  }
+  command = ring[tail];
+  __sync_synchronize();
+  tail = (tail + 1) % COMMAND_QUEUE_SIZE;
+  return true;
+}
+
+const Command* CommandQueue::peek(uint8_t index) const {
+  uint8_t waiting = (head + COMMAND_QUEUE_SIZE - tail) % COMMAND_QUEUE_SIZE;
+  if (index >= waiting) {
+    return nullptr;
+  }
+  return &ring[(tail + index) % COMMAND_QUEUE_SIZE];
+}
@@ -0,0 +1,73 @@
+#ifndef COMMAND_QUEUE_H
+#define COMMAND_QUEUE_H
+
+#include <Arduino.h>
+#include "constants.h"
+
+// Work a web handler hands to CommandTask instead of doing it in the network callback
+struct Command {
+  enum Type : uint8_t {
+    RECORD_START,
+    RECORD_STOP,
+    CALIBRATE,
+    GENERATE_TEST_DATA,   // option: TestDataGenerator test, text: file name
+    DELETE_FILE,          // text: file name
+    SAVE_SETTINGS,        // Writes the settings already applied in RAM to settings.json
+    CLEAR_TEMPCOMP,
+    RESET_RAINFLOW,
+    SPECTRUM_SELFTEST,
+    RAINFLOW_SELFTEST,
+    FILTER_SELFTEST
+  };
+  
+  enum State : uint8_t {
+    QUEUED,
+    DONE,
+    FAILED
+  };
+  
+  // GENERATE_TEST_DATA options
+  enum TestData : uint8_t {
+    TEST_MOTION,
+    TEST_STATIC,
+    TEST_COMBINED
+  };
+  
+  uint16_t id;
+  Type type;
+  State state;
+  uint8_t option;
+  char text[COMMAND_TEXT_MAX];
+  const __FlashStringHelper* message;   // Outcome, set when the command finishes
+  
+  static const char* typeName(Type type);
+  static const char* stateName(State state);
+};
+
+/**
+ * Bounded single-producer, single-consumer ring of commands. Web handlers push; CommandTask
+ * pops from the scheduler. Each side only writes its own index, and a slot is filled before
+ * head moves past it, so no lock is needed.
+ */
+class CommandQueue {
+  public:
+    // Producer side. The new command's id, or 0 if the queue is full or the text too long.
+    uint16_t push(Command::Type type, uint8_t option = 0, const char* text = nullptr);
+    
+    // Producer side. Only pop() frees a slot, so a push straight after this returns false succeeds.
+    bool isFull() const;
+    
+    // Consumer side
+    bool pop(Command& command);
+    
+    // The index-th waiting command, oldest first, or nullptr
+    const Command* peek(uint8_t index) const;
+    
+  private:
+    Command ring[COMMAND_QUEUE_SIZE];
+    volatile uint8_t head = 0;    // Next slot to fill, written by push() only
+    volatile uint8_t tail = 0;    // Next slot to run, written by pop() only
+    uint16_t nextId = 1;
+};
+
+#endif
@@ -0,0 +1,191 @@
+#include "CommandTask.h"
+#include "DebugOutput.h"
+#include "Tasks.h"
+#include "TestDataGenerator.h"
+#include "Settings.h"
+
+extern Settings settings;
+
+CommandTask::CommandTask()
+  : Task() {
+  setName(F("CommandTask"));
+  runInterval = 10;
+}
+
+void CommandTask::run() {
+  Command command;
+  if (!queue.pop(command)) {
+    return;
+  }
+  
+  execute(command);
+  
+  history[historyNext] = command;
+  historyNext = (historyNext + 1) % COMMAND_HISTORY;
+  if (historyCount < COMMAND_HISTORY) {
+    historyCount++;
+  }
+  
+  if (webStreamingTask.getConnectedClients() > 0) {
+    JsonWriter json(webStreamingTask.beginMessage());
+    writeCommandJSON(json, command);
+    webStreamingTask.broadcastMessage("command");
+  }
+}
+
+uint16_t CommandTask::submit(Command::Type type, uint8_t option, const char* text) {
+  return queue.push(type, option, text);
+}
+
+bool CommandTask::isQueueFull() const {
+  return queue.isFull();
+}
+
+const Command* CommandTask::findCommand(uint16_t id) const {
+  for (uint8_t i = 0; queue.peek(i); i++) {
+    if (queue.peek(i)->id == id) {
+      return queue.peek(i);
+    }
+  }
+  for (uint8_t i = 0; i < historyCount; i++) {
+    if (history[i].id == id) {
+      return &history[i];
+    }
+  }
+  return nullptr;
+}
+
+void CommandTask::writeCommandsJSON(JsonWriter& json) {
+  uint8_t oldest = (historyNext + COMMAND_HISTORY - historyCount) % COMMAND_HISTORY;
+  for (uint8_t i = 0; i < historyCount; i++) {
+    writeCommandJSON(json, history[(oldest + i) % COMMAND_HISTORY]);
+  }
+  for (uint8_t i = 0; queue.peek(i); i++) {
+    writeCommandJSON(json, *queue.peek(i));
+  }
+}
+
+void CommandTask::execute(Command& command) {
+  bool ok = true;
+  
+  switch (command.type) {
+    case Command::RECORD_START:
+      dataLoggingTask.startRecording();
+      command.message = F("Recording started");
+      debugOutput.println(F("WEB CONTROL: Recording started via web interface"));
+      break;
+    
+    case Command::RECORD_STOP:
+      dataLoggingTask.stopRecording();
+      command.message = F("Recording stopped");
+      debugOutput.println(F("WEB CONTROL: Recording stopped via web interface"));
+      break;
+    
+    case Command::CALIBRATE:
+      mpusensorTask.startCalibration();
+      command.message = F("Calibration started");
+      debugOutput.println(F("WEB CONTROL: Calibration started via web interface"));
+      break;
+    
+    case Command::GENERATE_TEST_DATA:
+      debugOutput.printf("Generating test data: type=%u, filename=%s\n", command.option, command.text);
+      if (command.option == Command::TEST_MOTION) {
+        ok = TestDataGenerator::generateBasicMotionTest(command.text);
+      } else if (command.option == Command::TEST_STATIC) {
+        ok = TestDataGenerator::generateStaticTest(command.text);
+      } else {
+        ok = TestDataGenerator::generateCombinedTest(command.text);
+      }
+      statusTask.noteFlashChanged();
+      command.message = ok ? F("Test data generated successfully") : F("Failed to generate test data");
+      debugOutput.at(ok ? LOG_LEVEL_INFO : LOG_LEVEL_ERROR)
+          .printf(ok ? "Test data generation completed: %s\n" : "ERROR: Test data generation failed: %s\n", command.text);
+      break;
+    
+    case Command::DELETE_FILE:
+      ok = webServerTask.deleteFile(command.text);
+      command.message = ok ? F("File deleted") : F("Error deleting file");
+      debugOutput.at(ok ? LOG_LEVEL_INFO : LOG_LEVEL_ERROR)
+          .printf(ok ? "File deleted via DELETE: %s\n" : "Failed to delete: %s\n", command.text);
+      break;
+    
+    case Command::SAVE_SETTINGS:
+      ok = settings.writeToFile();
+      command.message = ok ? F("Settings saved") : F("Failed to save settings");
+      debugOutput.at(ok ? LOG_LEVEL_INFO : LOG_LEVEL_ERROR)
+          .println(ok ? F("WEB CONTROL: Settings updated via web interface") : F("ERROR: Failed to save settings"));
+      break;
+    
+    case Command::CLEAR_TEMPCOMP:
+      mpusensorTask.clearTemperatureModel();
+      command.message = F("Temperature compensation model cleared");
+      debugOutput.println(F("WEB CONTROL: Temperature compensation model cleared"));
+      break;
+    
+    case Command::RESET_RAINFLOW:
+      rainflowTask.resetCounts();
+      command.message = F("Rainflow counts reset");
+      debugOutput.println(F("WEB CONTROL: Rainflow counts reset"));
+      break;
+    
+    case Command::SPECTRUM_SELFTEST:
+    case Command::RAINFLOW_SELFTEST:
+    case Command::FILTER_SELFTEST:
+      ok = runSelfTest(command.type);
+      command.message = ok ? F("Self-test complete") : F("Self-test result too large");
+      break;
+  }
+  
+  command.state = ok ? Command::DONE : Command::FAILED;
+}
+
+bool CommandTask::runSelfTest(Command::Type type) {
+  BufferPrint out(selfTestResult, sizeof(selfTestResult));
+  JsonWriter json(out);
+  json.beginObject();
+  if (type == Command::SPECTRUM_SELFTEST) {
+    SpectrumTask::runSelfTest(json);
+  } else if (type == Command::RAINFLOW_SELFTEST) {
+    RainflowTask::runSelfTest(json);
+  } else {
+    mpusensorTask.writeFiltersJSON(json, true);
+  }
+  json.endObject();
+  
+  selfTestType = type;
+  selfTestValid = !out.overflowed();
+  return selfTestValid;
+}
+
+const char* CommandTask::getSelfTestResult(Command::Type type) const {
+  return selfTestValid && selfTestType == type ? selfTestResult : nullptr;
+}
+
+void CommandTask::writeCommandJSON(JsonWriter& json, const Command& command) {
+  static const char* const testNames[] = { "motion", "static", "combined" };
+  
+  json.beginObject();
+  json.add("id", command.id);
+  json.add("command", Command::typeName(command.type));
+  json.add("status", Command::stateName(command.state));
+  if (command.message) {
+    json.add(command.state == Command::FAILED ? "error" : "message", command.message);
+  }
+  
+  switch (command.type) {
+    case Command::RECORD_START:
+    case Command::RECORD_STOP:
+      json.add("recording", dataLoggingTask.isRecording());
+      break;
+    case Command::GENERATE_TEST_DATA:
+      json.add("filename", command.text);
+      json.add("type", testNames[command.option < 3 ? command.option : 2]);
+      break;
+    case Command::DELETE_FILE:
+      json.add("file", command.text);
+      break;
+    default:
+      break;
+  }
+  json.endObject();
+}
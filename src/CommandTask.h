@@ -0,0 +1,60 @@
+#ifndef COMMAND_TASK_H
+#define COMMAND_TASK_H
+
+#include "Task.h"
+#include "CommandQueue.h"
+#include "JsonWriter.h"
+#include "constants.h"
+
+/**
+ * Runs the commands web handlers queue, from the scheduler rather than the network callback,
+ * so SPIFFS work such as opening a log or generating test data never stalls TCP, and it takes
+ * its turn with sampling like any other task. One command runs per pass.
+ *
+ * A handler replies 202 with the command id. The outcome is broadcast as a "command" event
+ * and kept for GET /api/commands?id=<id> until COMMAND_HISTORY newer commands have finished.
+ */
+class CommandTask : public Task {
+  public:
+    static const uint16_t MASK { COMMAND_TASK_MASK };
+    
+    CommandTask();
+    
+    virtual uint16_t getMask() override {
+      return CommandTask::MASK;
+    }
+    
+    virtual void run() override;
+    
+    // Called from web handlers. The command id, or 0 if the queue is full.
+    uint16_t submit(Command::Type type, uint8_t option = 0, const char* text = nullptr);
+    bool isQueueFull() const;
+    
+    // A waiting or recently finished command; nullptr if the id is unknown or no longer kept
+    const Command* findCommand(uint16_t id) const;
+    void writeCommandJSON(JsonWriter& json, const Command& command);
+    
+    // Waiting and recently finished commands, oldest first, as array elements
+    void writeCommandsJSON(JsonWriter& json);
+    
+    // The JSON object written by the last self-test command, if it was of this type; nullptr if
+    // another self-test has run since, or none has
+    const char* getSelfTestResult(Command::Type type) const;
+    
+  private:
+    CommandQueue queue;
+    Command history[COMMAND_HISTORY];
+    uint8_t historyCount = 0;
+    uint8_t historyNext = 0;
+    
+    // Self-tests are CPU-bound for tens of milliseconds, so they run here and their GET endpoints
+    // serve what they wrote. One buffer is shared by all three.
+    char selfTestResult[SELFTEST_RESULT_MAX];
+    Command::Type selfTestType;
+    bool selfTestValid = false;
+    
+    void execute(Command& command);
+    bool runSelfTest(Command::Type type);
+};
+
+#endif
@@ -0,0 +1,305 @@
+#include "CsvEncoder.h"
+#include <string.h>
+
+static const char CSV_HEADER[] =
+  "Time (s),Delay (s),Accel X (G),Accel Y (G),Accel Z (G),Yaw (\xC2\xB0),Pitch (\xC2\xB0),Roll (\xC2\xB0),Flags\n";
+
+static const uint32_t POWERS_OF_TEN[] = {
+  1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000
+};
+
+// Decimal places per channel, as the viewer's CSV download
+static const uint8_t CHANNEL_DECIMALS[6] = { 4, 4, 4, 2, 2, 2 };
+
+static uint32_t readUint32(const uint8_t* data) {
+  uint32_t value;
+  memcpy(&value, data, sizeof(value));
+  return value;
+}
+
+static float readFloat(const uint8_t* data) {
+  float value;
+  memcpy(&value, data, sizeof(value));
+  return value;
+}
+
+CsvEncoder::CsvEncoder() {
+  reset();
+}
+
+void CsvEncoder::reset() {
+  state = STATE_START;
+  layout = LAYOUT_LEGACY;
+  channelMask = LOG_CHANNELS_ALL;
+  channelCount = 6;
+  recordSize = LEGACY_RECORD_SIZE;
+  truncated = false;
+  inputLength = 0;
+  inputPosition = 0;
+  pageRecords = 0;
+  pageRecord = 0;
+  lineLength = 0;
+  linePosition = 0;
+  recordCount = 0;
+  firstTimestamp = 0;
+  lastTimestamp = 0;
+}
+
+size_t CsvEncoder::fill(Source& source, uint8_t* out, size_t maxLen) {
+  size_t written = 0;
+  while (written < maxLen) {
+    // A line that did not fit last time is finished first
+    if (linePosition == lineLength && !nextLine(source)) {
+      break;
+    }
+    size_t count = lineLength - linePosition;
+    if (count > maxLen - written) {
+      count = maxLen - written;
+    }
+    memcpy(out + written, line + linePosition, count);
+    linePosition += count;
+    written += count;
+  }
+  return written;
+}
+
+uint32_t CsvEncoder::getRecordCount() const {
+  return recordCount;
+}
+
+bool CsvEncoder::isTruncated() const {
+  return truncated;
+}
+
+uint8_t CsvEncoder::formatFloat(char* out, float value, uint8_t decimals) {
+  uint32_t bits;
+  memcpy(&bits, &value, sizeof(bits));
+  bool negative = bits >> 31;
+  int16_t exponent = (bits >> 23) & 0xFF;
+  uint32_t mantissa = bits & 0x7FFFFF;
+  
+  if (exponent == 0xFF || decimals > 9) {
+    return 0;
+  }
+  if (exponent == 0) {
+    // -0 prints as 0, like toFixed()
+    if (mantissa == 0) {
+      negative = false;
+    }
+    exponent = 1;
+  } else {
+    mantissa |= 0x800000;
+  }
+  
+  // value = mantissa * 2^shift, so value * 10^decimals is an integer product and a shift,
+  // rounded half away from zero
+  int16_t shift = exponent - 150;
+  uint64_t scaled = (uint64_t)mantissa * POWERS_OF_TEN[decimals];
+  if (shift >= 0) {
+    // Already at least 2^33 at the smallest shift that gets here
+    if (shift > 9) {
+      return 0;
+    }
+    scaled <<= shift;
+  } else if (shift > -64) {
+    scaled = (scaled + ((uint64_t)1 << (-shift - 1))) >> -shift;
+  } else {
+    scaled = 0;
+  }
+  if (scaled > 0xFFFFFFFFULL) {
+    return 0;
+  }
+  return formatUnsigned(out, (uint32_t)scaled, negative, decimals);
+}
+
+uint8_t CsvEncoder::formatFixed(char* out, int32_t units, uint8_t decimals) {
+  uint32_t magnitude = units < 0 ? 0 - (uint32_t)units : (uint32_t)units;
+  return formatUnsigned(out, magnitude, units < 0, decimals);
+}
+
+uint8_t CsvEncoder::formatUnsigned(char* out, uint32_t magnitude, bool negative, uint8_t decimals) {
+  // Digits are produced backwards, with at least one ahead of the point
+  char digits[11];
+  uint8_t count = 0;
+  do {
+    digits[count++] = '0' + magnitude % 10;
+    magnitude /= 10;
+  } while (magnitude > 0 || count <= decimals);
+  
+  uint8_t length = 0;
+  if (negative) {
+    out[length++] = '-';
+  }
+  while (count > 0) {
+    if (count == decimals) {
+      out[length++] = '.';
+    }
+    out[length++] = digits[--count];
+  }
+  return length;
+}
+
+bool CsvEncoder::nextLine(Source& source) {
+  lineLength = 0;
+  linePosition = 0;
+  
+  if (state == STATE_START) {
+    state = STATE_RECORDS;
+    readHeader(source);
+    lineLength = sizeof(CSV_HEADER) - 1;
+    memcpy(line, CSV_HEADER, lineLength);
+    return true;
+  }
+  if (state == STATE_DONE) {
+    return false;
+  }
+  
+  if (!nextRecord(source)) {
+    state = STATE_DONE;
+    return false;
+  }
+  formatRecord();
+  return true;
+}
+
+void CsvEncoder::readHeader(Source& source) {
+  // MPULogHeader: magic, version, channelMask, recordSize, layout
+  inputLength = readFully(source, input, HEADER_SIZE);
+  inputPosition = 0;
+  if (inputLength < HEADER_SIZE || readUint32(input) != LOG_HEADER_MAGIC) {
+    // Legacy log; the bytes read are the start of the first record
+    return;
+  }
+  
+  channelMask = input[5] & LOG_CHANNELS_ALL;
+  channelCount = 0;
+  for (uint8_t i = 0; i < 6; i++) {
+    if (channelMask & (1 << i)) {
+      channelCount++;
+    }
+  }
+  recordSize = input[6];
+  layout = input[7] == LOG_LAYOUT_COLUMNAR ? LAYOUT_COLUMNAR : LAYOUT_PACKED;
+  inputLength = 0;
+  
+  // A header that does not describe its own records leaves nothing to decode
+  if (recordSize != sizeof(uint32_t) + channelCount * sizeof(float) + 2) {
+    truncated = true;
+    state = STATE_DONE;
+  }
+}
+
+bool CsvEncoder::nextRecord(Source& source) {
+  if (!(layout == LAYOUT_COLUMNAR ? nextColumnarRecord(source) : nextPackedRecord(source))) {
+    return false;
+  }
+  
+  if (recordCount == 0) {
+    firstTimestamp = timestamp;
+    lastTimestamp = timestamp;
+  }
+  recordCount++;
+  return true;
+}
+
+bool CsvEncoder::nextPackedRecord(Source& source) {
+  if (inputLength - inputPosition < recordSize) {
+    // Keep the partial record and top the buffer up behind it
+    uint16_t remaining = inputLength - inputPosition;
+    memmove(input, input + inputPosition, remaining);
+    inputLength = remaining + readFully(source, input + remaining, sizeof(input) - remaining);
+    inputPosition = 0;
+    if (inputLength < recordSize) {
+      truncated = inputLength > 0;
+      return false;
+    }
+  }
+  
+  const uint8_t* record = input + inputPosition;
+  timestamp = readUint32(record);
+  if (layout == LAYOUT_LEGACY) {
+    for (uint8_t c = 0; c < 6; c++) {
+      values[c] = readFloat(record + 4 + c * 4);
+    }
+    flags = record[28];
+  } else {
+    uint8_t slot = 0;
+    for (uint8_t c = 0; c < 6; c++) {
+      if (channelMask & (1 << c)) {
+        values[c] = readFloat(record + 4 + slot++ * 4);
+      }
+    }
+    flags = record[recordSize - 2];
+  }
+  inputPosition += recordSize;
+  return true;
+}
+
+bool CsvEncoder::nextColumnarRecord(Source& source) {
+  if (pageRecord == pageRecords) {
+    // Page: uint16 count, uint16 reserved, count timestamps, count floats per logged channel,
+    // count flag bytes
+    uint8_t pageHeader[LOG_COLUMNAR_PAGE_HEADER];
+    size_t length = readFully(source, pageHeader, sizeof(pageHeader));
+    if (length < sizeof(pageHeader)) {
+      truncated = length > 0;
+      return false;
+    }
+    
+    uint16_t count = pageHeader[0] | (pageHeader[1] << 8);
+    size_t pageBytes = (size_t)count * (recordSize - 1);
+    if (count == 0 || pageBytes > sizeof(input) || readFully(source, input, pageBytes) < pageBytes) {
+      truncated = true;
+      return false;
+    }
+    pageRecords = count;
+    pageRecord = 0;
+  }
+  
+  const uint8_t* column = input + pageRecord * 4;
+  const uint16_t columnBytes = pageRecords * 4;
+  timestamp = readUint32(column);
+  for (uint8_t c = 0; c < 6; c++) {
+    if (channelMask & (1 << c)) {
+      column += columnBytes;
+      values[c] = readFloat(column);
+    }
+  }
+  flags = input[columnBytes * (channelCount + 1) + pageRecord];
+  pageRecord++;
+  return true;
+}
+
+void CsvEncoder::formatRecord() {
+  // Time since the first record and since the previous one, both in seconds; signed, so a
+  // timestamp that goes backwards shows as such
+  char* out = line;
+  out += formatFixed(out, (int32_t)(timestamp - firstTimestamp), 3);
+  *out++ = ',';
+  out += formatFixed(out, (int32_t)(timestamp - lastTimestamp), 3);
+  lastTimestamp = timestamp;
+  
+  for (uint8_t c = 0; c < 6; c++) {
+    *out++ = ',';
+    if (channelMask & (1 << c)) {
+      out += formatFloat(out, values[c], CHANNEL_DECIMALS[c]);
+    }
+  }
+  
+  *out++ = ',';
+  out += formatFixed(out, flags, 0);
+  *out++ = '\n';
+  lineLength = out - line;
+}
+
+size_t CsvEncoder::readFully(Source& source, uint8_t* buffer, size_t length) {
+  size_t total = 0;
+  while (total < length) {
+    size_t count = source.read(buffer + total, length - total);
+    if (count == 0) {
+      break;
+    }
+    total += count;
+  }
+  return total;
+}
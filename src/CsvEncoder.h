@@ -0,0 +1,93 @@
+#ifndef CSV_ENCODER_H
+#define CSV_ENCODER_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "constants.h"
+
+// Converts a raw log (legacy MPULogRecords, or packed or columnar records after an MPULogHeader)
+// to CSV a piece at a time, for GET /api/files/<name>.csv. The log is read a page at a time into
+// a fixed input buffer and each record is formatted into a fixed line buffer, so a multi-MB
+// export needs no more RAM than a short one. Numbers are formatted with integer arithmetic from
+// the float bits, rounding like the viewer's toFixed(). Nothing here touches SPIFFS or Arduino
+// APIs, so tools/csv_benchmark.cpp can time the same code on the host.
+//
+// Columns match the viewer's CSV download. Channels a masked log did not record are empty.
+class CsvEncoder {
+  public:
+    // Where the log bytes come from: a SPIFFS file on the device, memory on the host
+    class Source {
+      public:
+        virtual ~Source() {}
+        // Up to length bytes; fewer only at the end of the log
+        virtual size_t read(uint8_t* buffer, size_t length) = 0;
+    };
+    
+    static const uint8_t LEGACY_RECORD_SIZE = 32;   // sizeof(MPULogRecord)
+    static const uint8_t HEADER_SIZE = 8;           // sizeof(MPULogHeader)
+    
+    CsvEncoder();
+    
+    // Starts again from the header line, for a new log
+    void reset();
+    
+    // Writes up to maxLen bytes of CSV to out, reading the log from source as needed. Only
+    // returns 0 once the whole log has been written.
+    size_t fill(Source& source, uint8_t* out, size_t maxLen);
+    
+    uint32_t getRecordCount() const;
+    
+    // The log ended in a partial record or an invalid columnar page; the records before it
+    // were written
+    bool isTruncated() const;
+    
+    // Writes value with decimals (at most 9) places and returns the length. Non-finite values
+    // and values too large for the sensor (beyond +-4294967295 units of the last place) are
+    // written as an empty field.
+    static uint8_t formatFloat(char* out, float value, uint8_t decimals);
+    
+    // Writes units / 10^decimals, e.g. milliseconds as seconds with decimals = 3
+    static uint8_t formatFixed(char* out, int32_t units, uint8_t decimals);
+  
+  private:
+    enum Layout : uint8_t { LAYOUT_LEGACY, LAYOUT_PACKED, LAYOUT_COLUMNAR };
+    enum State : uint8_t { STATE_START, STATE_RECORDS, STATE_DONE };
+    
+    State state = STATE_START;
+    Layout layout = LAYOUT_LEGACY;
+    uint8_t channelMask = LOG_CHANNELS_ALL;
+    uint8_t channelCount = 6;
+    uint8_t recordSize = LEGACY_RECORD_SIZE;
+    bool truncated = false;
+    
+    uint8_t input[LOG_PAGE_SIZE];
+    uint16_t inputLength = 0;
+    uint16_t inputPosition = 0;
+    uint16_t pageRecords = 0;       // Columnar: records in the page held in input
+    uint16_t pageRecord = 0;        // Columnar: next record of the page
+    
+    char line[CSV_LINE_MAX];
+    uint8_t lineLength = 0;
+    uint8_t linePosition = 0;
+    
+    uint32_t recordCount = 0;
+    uint32_t firstTimestamp = 0;
+    uint32_t lastTimestamp = 0;
+    
+    // Current record
+    uint32_t timestamp = 0;
+    float values[6];
+    uint8_t flags = 0;
+    
+    bool nextLine(Source& source);
+    void readHeader(Source& source);
+    bool nextRecord(Source& source);
+    bool nextPackedRecord(Source& source);
+    bool nextColumnarRecord(Source& source);
+    void formatRecord();
+    
+    static size_t readFully(Source& source, uint8_t* buffer, size_t length);
+    static uint8_t formatUnsigned(char* out, uint32_t magnitude, bool negative, uint8_t decimals);
+};
+
+#endif
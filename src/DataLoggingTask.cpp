@@ -1,5 +1,8 @@
 #include "DataLoggingTask.h"
+#include "DebugOutput.h"
 #include "Settings.h"
+#include "MPUSensorTask.h"
+#include "StatusTask.h"
 #include <Arduino.h>
 #include <ESP8266WiFi.h>
 
@@ -30,17 +33,47 @@ bool DataLoggingTask::isRecording() const {
 void DataLoggingTask::startRecording() {
   if (!recording) {
     recording = true;
+    activeLogMode = settings->logMode;
+    summary.reset(millis());
+    summaryCount = 0;
+    histogramActive = false;  // Histogram counts restart with the recording
+    deadbandActive = settings->deadbandEnabled && activeLogMode == LOG_MODE_RAW;
+    activeChannelMask = activeLogMode == LOG_MODE_RAW ? settings->channelMask : LOG_CHANNELS_ALL;
+    activeColumnar = activeLogMode == LOG_MODE_RAW && settings->columnarPages;
+    pyramidActive = activeLogMode == LOG_MODE_RAW && settings->pyramidEnabled;
+    pyramid.reset();
+    for (uint8_t level = 0; level < PYRAMID_LEVELS; level++) {
+      pyramidCount[level] = 0;
+    }
+    packedRecordSize = MPULogHeader::recordSizeFor(activeChannelMask);
+    pageRecordCapacity = activeColumnar ? MPULogHeader::columnarPageRecords(packedRecordSize)
+                                        : LOG_PAGE_SIZE / packedRecordSize;
+    pageBytes = 0;
+    hasCommittedRecord = false;
+    samplesOffered = 0;
+    recordsCommitted = 0;
     currentFileName = "";  // Reset filename to force generation of new file number
     openLogFile();
-    Serial.println(F("DATA_LOG: Recording started"));
+    debugOutput.println(F("DATA_LOG: Recording started"));
   }
 }
 
 void DataLoggingTask::stopRecording() {
   if (recording) {
+    if (activeLogMode == LOG_MODE_SUMMARY && summary.getSampleCount() > 0) {
+      finishSummaryWindow(true);
+    }
+    if (activeLogMode == LOG_MODE_HISTOGRAM && histogramActive && histogram.getSampleCount() > 0) {
+      finishHistogramInterval(millis() - histogramStartMillis, true);
+      histogramStartMillis = millis();
+    }
+    if (pyramidActive) {
+      storePyramidBuckets(pyramid.finish());
+    }
+    writePageBufferToFlash();
     recording = false;
     closeLogFile();
-    Serial.println(F("DATA_LOG: Recording stopped"));
+    debugOutput.println(F("DATA_LOG: Recording stopped"));
   }
 }
 
@@ -53,26 +86,28 @@ void DataLoggingTask::toggleRecording() {
 }
 
 void DataLoggingTask::run() {
+  if (burstSensor) {
+    writeBurstRecords();
+  }
+  
   // ff_LogTask strategy: Check if we need to flush any remaining data
   // This handles the case where no new data is coming in but we have buffered data
-  bool hasData = false;
-  for(uint16_t i = 0; i < RAM_BUFFER_SIZE; i++) {
-    if(ramBuffer[i].timestamp > 0) {
-      hasData = true;
-      break;
-    }
-  }
+  bool hasData = hasBufferedRecords();
   
   // Fallback flush after AUTO_FLUSH_DELAY to prevent data loss
   if(hasData && (millis() - lastFlushTime >= AUTO_FLUSH_DELAY)) {
-    writeRamBufferToFlash();
+    if (usesPackedRecords()) {
+      writePageBufferToFlash();
+    } else {
+      writeRamBufferToFlash();
+    }
   }
 }
 
 void DataLoggingTask::logSensorData(float accel_x, float accel_y, float accel_z, 
                                   float yaw, float pitch, float roll) {
   // Only log data if we are recording - this fixes the timing race condition
-  if (!recording) {
+  if (!recording || activeLogMode != LOG_MODE_RAW) {
     return;
   }
   
@@ -85,22 +120,663 @@ void DataLoggingTask::logSensorData(float accel_x, float accel_y, float accel_z,
   record.pitch = pitch;
   record.roll = roll;
   record.setRecording(true);  // Use the flag method from MPULogRecord
+  samplesOffered++;
+  
+  // The pyramid covers every sample, including ones the deadband leaves out
+  if (pyramidActive) {
+    const float values[6] = { accel_x, accel_y, accel_z, yaw, pitch, roll };
+    uint8_t levels = pyramid.add(record.timestamp, values);
+    if (levels) {
+      storePyramidBuckets(levels);
+    }
+  }
+  
+  // Deadband: skip samples that stay within the thresholds of the last written record
+  if (deadbandActive) {
+    if (hasCommittedRecord && !outsideDeadband(record)) {
+      return;
+    }
+    record.flags |= MPULogRecord::FLAG_DEADBAND;
+    lastCommittedRecord = record;
+    hasCommittedRecord = true;
+  }
+  recordsCommitted++;
   
-  // Use ff_LogTask's ramBufferPut strategy for page-based buffering
-  ramBufferPut(record);
+  // Masked recordings are packed a page at a time, full ones use ff_LogTask's ramBufferPut strategy
+  if (usesPackedRecords()) {
+    packRecord(record);
+  } else {
+    ramBufferPut(record);
+  }
 }
 
-void DataLoggingTask::inhibited() {
-  // ff_LogTask strategy: Flush ramBuffer when inhibited to prevent data loss
-  bool hasData = false;
+bool DataLoggingTask::usesPackedRecords() const {
+  return activeChannelMask != LOG_CHANNELS_ALL || activeColumnar;
+}
+
+bool DataLoggingTask::hasBufferedRecords() const {
+  if (pageBytes > 0) {
+    return true;
+  }
   for(uint16_t i = 0; i < RAM_BUFFER_SIZE; i++) {
     if(ramBuffer[i].timestamp > 0) {
-      hasData = true;
-      break;
+      return true;
+    }
+  }
+  return false;
+}
+
+void DataLoggingTask::packRecord(const MPULogRecord& record) {
+  if (pageBytes / packedRecordSize >= pageRecordCapacity) {
+    writePageBufferToFlash();
+  }
+  
+  const float values[6] = { record.accel_x, record.accel_y, record.accel_z, record.yaw, record.pitch, record.roll };
+  uint8_t* out = pageBuffer + pageBytes;
+  uint32_t timestamp = record.timestamp;
+  memcpy(out, &timestamp, sizeof(timestamp));
+  out += sizeof(timestamp);
+  for (uint8_t i = 0; i < 6; i++) {
+    if (activeChannelMask & (1 << i)) {
+      memcpy(out, &values[i], sizeof(float));
+      out += sizeof(float);
+    }
+  }
+  *out++ = record.flags;
+  *out = 0;
+  pageBytes += packedRecordSize;
+}
+
+void DataLoggingTask::writePageBufferToFlash() {
+  if (!recording || pageBytes == 0) {
+    return;
+  }
+  
+  if (!currentFile || !currentFile.isFile()) {
+    if (!createNewLogFile()) {
+      debugOutput.at(LOG_LEVEL_ERROR).println(F("Failed to create log file"));
+      return;
+    }
+  }
+  
+  uint32_t firstTimestamp;
+  memcpy(&firstTimestamp, pageBuffer, sizeof(firstTimestamp));
+  indexPage(firstTimestamp);
+  
+  const uint8_t* page = pageBuffer;
+  uint16_t length = pageBytes;
+  uint8_t columns[LOG_PAGE_SIZE];
+  if (activeColumnar) {
+    length = transposePageBuffer(columns);
+    page = columns;
+  }
+  
+  if (currentFile.write(page, length) != length) {
+    Print& log = debugOutput.at(LOG_LEVEL_ERROR);
+    log.print(F("Failed to write records to '"));
+    log.print(currentFileName);
+    log.println(F("'."));
+  } else if (statusTask) {
+    statusTask->noteFlashWrite(length);
+  }
+  currentFile.flush();
+  
+  lastFlushTime = millis();
+  Print& log = debugOutput.at(LOG_LEVEL_DEBUG);
+  log.print(F("Wrote "));
+  log.print(pageBytes / packedRecordSize);
+  log.println(F(" packed records to log"));
+  pageBytes = 0;
+}
+
+// Rewrites the packed records in pageBuffer as a columnar page: record count, then all
+// timestamps, then each selected channel, then the flags
+uint16_t DataLoggingTask::transposePageBuffer(uint8_t* columns) const {
+  const uint16_t count = pageBytes / packedRecordSize;
+  const uint16_t header[2] = { count, 0 };
+  memcpy(columns, header, sizeof(header));
+  uint8_t* out = columns + sizeof(header);
+  
+  // Fields are the 4-byte timestamp and floats, then the flags byte, at fixed record offsets
+  const uint8_t fields = (packedRecordSize - 2) / 4;
+  for (uint8_t field = 0; field < fields; field++) {
+    for (uint16_t i = 0; i < count; i++) {
+      memcpy(out, pageBuffer + i * packedRecordSize + field * 4, 4);
+      out += 4;
+    }
+  }
+  for (uint16_t i = 0; i < count; i++) {
+    *out++ = pageBuffer[i * packedRecordSize + fields * 4];
+  }
+  
+  return out - columns;
+}
+
+bool DataLoggingTask::outsideDeadband(const MPULogRecord& record) const {
+  // Heartbeat keeps a long idle period visible as records rather than a gap
+  if (record.timestamp - lastCommittedRecord.timestamp >= settings->deadbandHeartbeatMs) {
+    return true;
+  }
+  
+  const float current[6] = { record.accel_x, record.accel_y, record.accel_z, record.yaw, record.pitch, record.roll };
+  const float committed[6] = { lastCommittedRecord.accel_x, lastCommittedRecord.accel_y, lastCommittedRecord.accel_z,
+                               lastCommittedRecord.yaw, lastCommittedRecord.pitch, lastCommittedRecord.roll };
+  for (uint8_t i = 0; i < 6; i++) {
+    if (fabs(current[i] - committed[i]) > settings->deadband[i]) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool DataLoggingTask::isDeadbandActive() const {
+  return deadbandActive;
+}
+
+uint32_t DataLoggingTask::getSamplesOffered() const {
+  return samplesOffered;
+}
+
+uint32_t DataLoggingTask::getRecordsCommitted() const {
+  return recordsCommitted;
+}
+
+void DataLoggingTask::logFullRateSample(const SensorSample& sample) {
+  // Histograms are also kept while idle so /api/histogram works without a recording
+  uint8_t mode = recording ? activeLogMode : settings->logMode;
+  if (mode == LOG_MODE_HISTOGRAM) {
+    updateHistogram(sample);
+  } else {
+    histogramActive = false;
+  }
+  
+  if (!recording || activeLogMode != LOG_MODE_SUMMARY) {
+    return;
+  }
+  
+  // Close the window before adding a sample that belongs to the next one
+  const uint32_t windowMs = (uint32_t)settings->summaryWindowSec * 1000UL;
+  if (sample.timestamp - summary.getStartMillis() >= windowMs) {
+    uint32_t nextStart = summary.getStartMillis() + windowMs;
+    finishSummaryWindow(false);
+    
+    // Windows stay on a fixed grid unless the loop stalled for a whole window
+    if (sample.timestamp - nextStart >= windowMs) {
+      nextStart = sample.timestamp;
+    }
+    summary.reset(nextStart);
+  }
+  
+  summary.add(sample);
+}
+
+void DataLoggingTask::finishSummaryWindow(bool partial) {
+  MPUSummaryRecord& record = summaryBuffer[summaryCount++];
+  summary.toRecord(record);
+  if (partial) {
+    record.flags |= MPUSummaryRecord::FLAG_PARTIAL;
+  }
+  
+  if (summaryCount >= SUMMARY_BUFFER_SIZE) {
+    writeSummaryBufferToFlash();
+  }
+}
+
+void DataLoggingTask::writeSummaryBufferToFlash() {
+  if (summaryCount == 0) {
+    return;
+  }
+  
+  // Same reopen behaviour as writeRamBufferToFlash(); a closed file is only reopened while recording
+  if (!currentFile || !currentFile.isFile()) {
+    if (!recording || !createNewLogFile()) {
+      debugOutput.at(LOG_LEVEL_ERROR).println(F("Failed to create log file"));
+      return;
+    }
+  }
+  
+  size_t bytes = summaryCount * sizeof(MPUSummaryRecord);
+  if (currentFile.write(reinterpret_cast<const uint8_t*>(summaryBuffer), bytes) != bytes) {
+    Print& log = debugOutput.at(LOG_LEVEL_ERROR);
+    log.print(F("Failed to write summary records to '"));
+    log.print(currentFileName);
+    log.println(F("'."));
+  } else if (statusTask) {
+    statusTask->noteFlashWrite(bytes);
+  }
+  currentFile.flush();
+  
+  debugOutput.print(F("Wrote "));
+  debugOutput.print(summaryCount);
+  debugOutput.println(F(" summary records to log"));
+  summaryCount = 0;
+}
+
+void DataLoggingTask::updateHistogram(const SensorSample& sample) {
+  if (!histogramActive) {
+    histogram.reset();
+    histogramTotal.reset();
+    histogramStartMillis = sample.timestamp;
+    histogramActive = true;
+  }
+  
+  const uint32_t intervalMs = (uint32_t)settings->histogramIntervalMin * 60000UL;
+  if (sample.timestamp - histogramStartMillis >= intervalMs) {
+    finishHistogramInterval(intervalMs, false);
+    histogramStartMillis += intervalMs;
+    if (sample.timestamp - histogramStartMillis >= intervalMs) {
+      histogramStartMillis = sample.timestamp;
     }
   }
   
-  if(hasData) {
+  histogram.add(sample);
+}
+
+void DataLoggingTask::finishHistogramInterval(uint32_t durationMs, bool partial) {
+  if (recording && activeLogMode == LOG_MODE_HISTOGRAM) {
+    writeHistogramSnapshot(durationMs, partial);
+  }
+  histogramTotal.merge(histogram);
+  histogram.reset();
+}
+
+void DataLoggingTask::writeHistogramSnapshot(uint32_t durationMs, bool partial) {
+  if (!currentFile || !currentFile.isFile()) {
+    if (!createNewLogFile()) {
+      debugOutput.at(LOG_LEVEL_ERROR).println(F("Failed to create log file"));
+      return;
+    }
+  }
+  
+  MPUHistogramHeader header;
+  header.timestamp = histogramStartMillis;
+  header.durationMs = durationMs;
+  header.sampleCount = histogram.getSampleCount();
+  header.binCount = HISTOGRAM_BINS;
+  header.channelCount = SampleHistogram::CHANNELS;
+  header.flags = partial ? MPUHistogramHeader::FLAG_PARTIAL : 0;
+  header.accelBinMg = HISTOGRAM_ACCEL_BIN_WIDTH / 10;
+  header.gyroBinDeciDps = HISTOGRAM_GYRO_BIN_WIDTH / 10;
+  
+  // Under 1KB per snapshot and at most one a minute, so it is written straight through
+  const size_t countBytes = (size_t)SampleHistogram::CHANNELS * HISTOGRAM_BINS * sizeof(uint32_t);
+  bool ok = currentFile.write(reinterpret_cast<const uint8_t*>(&header), sizeof(header)) == sizeof(header);
+  ok = ok && currentFile.write(reinterpret_cast<const uint8_t*>(histogram.getCounts()), countBytes) == countBytes;
+  currentFile.flush();
+  
+  if (!ok) {
+    Print& log = debugOutput.at(LOG_LEVEL_ERROR);
+    log.print(F("Failed to write histogram to '"));
+    log.print(currentFileName);
+    log.println(F("'."));
+    return;
+  }
+  if (statusTask) {
+    statusTask->noteFlashWrite(sizeof(header) + countBytes);
+  }
+  debugOutput.print(F("Wrote histogram snapshot of "));
+  debugOutput.print(header.sampleCount);
+  debugOutput.println(F(" samples to log"));
+}
+
+void DataLoggingTask::writeHistogramJSON(JsonWriter& json) {
+  json.add("active", histogramActive);
+  json.add("recording", recording && activeLogMode == LOG_MODE_HISTOGRAM);
+  json.add("intervalMinutes", settings->histogramIntervalMin);
+  json.add("intervalAgeMs", histogramActive ? millis() - histogramStartMillis : 0UL);
+  json.add("intervalSamples", histogram.getSampleCount());
+  json.add("totalSamples", histogramTotal.getSampleCount() + histogram.getSampleCount());
+  json.add("binCount", HISTOGRAM_BINS);
+  json.add("accelBinMg", HISTOGRAM_ACCEL_BIN_WIDTH / 10);
+  json.add("gyroBinDps", HISTOGRAM_GYRO_BIN_WIDTH / 100.0f, 2);
+  json.beginArray("channels");
+  for (uint8_t c = 0; c < SampleHistogram::CHANNELS; c++) {
+    json.beginObject();
+    json.add("name", SampleHistogram::channelName(c));
+    // mG for accel and magnitude, deg/s for gyro
+    int32_t firstEdge = SampleHistogram::getFirstBinEdge(c);
+    if (c >= 3 && c < 6) {
+      json.add("firstBin", firstEdge / 10.0f, 1);
+    } else {
+      json.add("firstBin", firstEdge);
+    }
+    writeHistogramCounts(json, "interval", histogram, nullptr, c);
+    writeHistogramCounts(json, "total", histogramTotal, &histogram, c);
+    json.endObject();
+  }
+  json.endArray();
+}
+
+void DataLoggingTask::writeHistogramCounts(JsonWriter& json, const char* key, const SampleHistogram& histogram,
+                                           const SampleHistogram* extra, uint8_t channel) {
+  json.beginArray(key);
+  for (uint8_t b = 0; b < HISTOGRAM_BINS; b++) {
+    uint32_t count = histogram.getCount(channel, b);
+    if (extra) {
+      count += extra->getCount(channel, b);
+    }
+    json.value(count);
+  }
+  json.endArray();
+}
+
+void DataLoggingTask::logTemperature(float celsius) {
+  if (!recording) {
+    return;
+  }
+  
+  MPUTemperatureRecord& record = temperatureBuffer[temperatureCount++];
+  record.timestamp = millis();
+  record.centiCelsius = (int16_t)lroundf(celsius * 100);
+  record.reserved = 0;
+  
+  if (temperatureCount >= TEMPERATURE_BUFFER_SIZE) {
+    writeTemperatureBufferToFlash();
+  }
+}
+
+void DataLoggingTask::writeTemperatureBufferToFlash() {
+  if (temperatureCount == 0 || currentFileName.length() == 0) {
+    return;
+  }
+  
+  String sidecarName = getSidecarFileName(currentFileName, LOG_TEMPERATURE_SUFFIX);
+  File sidecar = SPIFFS.open(sidecarName, "a");
+  if (!sidecar) {
+    Print& log = debugOutput.at(LOG_LEVEL_ERROR);
+    log.print(F("Failed to open temperature log '"));
+    log.print(sidecarName);
+    log.println(F("'"));
+    return;
+  }
+  
+  size_t bytes = sidecar.write(reinterpret_cast<const uint8_t*>(temperatureBuffer),
+                               temperatureCount * sizeof(MPUTemperatureRecord));
+  sidecar.close();
+  if (statusTask) {
+    statusTask->noteFlashWrite(bytes);
+  }
+  temperatureCount = 0;
+}
+
+// Called before a page is written, while the file size is still the page's offset
+void DataLoggingTask::indexPage(uint32_t timestamp) {
+  if (pagesWritten++ % LOG_INDEX_PAGE_INTERVAL != 0) {
+    return;
+  }
+  
+  MPUIndexEntry& entry = indexBuffer[indexCount++];
+  entry.timestamp = timestamp;
+  entry.offset = currentFile.size();
+  
+  if (indexCount >= INDEX_BUFFER_SIZE) {
+    writeIndexBufferToFlash();
+  }
+}
+
+void DataLoggingTask::writeIndexBufferToFlash() {
+  if (indexCount == 0 || currentFileName.length() == 0) {
+    return;
+  }
+  
+  String sidecarName = getSidecarFileName(currentFileName, LOG_INDEX_SUFFIX);
+  File sidecar = SPIFFS.open(sidecarName, "a");
+  if (!sidecar) {
+    Print& log = debugOutput.at(LOG_LEVEL_ERROR);
+    log.print(F("Failed to open time index '"));
+    log.print(sidecarName);
+    log.println(F("'"));
+    return;
+  }
+  
+  size_t bytes = sidecar.write(reinterpret_cast<const uint8_t*>(indexBuffer), indexCount * sizeof(MPUIndexEntry));
+  sidecar.close();
+  if (statusTask) {
+    statusTask->noteFlashWrite(bytes);
+  }
+  indexCount = 0;
+}
+
+bool DataLoggingTask::readIndexEntry(File& index, uint32_t position, MPUIndexEntry& entry) {
+  return index.seek(position * sizeof(MPUIndexEntry), SeekSet) &&
+         index.read(reinterpret_cast<uint8_t*>(&entry), sizeof(entry)) == sizeof(entry);
+}
+
+bool DataLoggingTask::findTimeRange(const String& logFileName, uint32_t fromMs, uint32_t toMs,
+                                    uint32_t& startOffset, uint32_t& endOffset) {
+  File index = SPIFFS.open(getSidecarFileName(logFileName, LOG_INDEX_SUFFIX), "r");
+  if (!index) {
+    return false;
+  }
+  
+  const uint32_t entries = index.size() / sizeof(MPUIndexEntry);
+  MPUIndexEntry entry;
+  if (entries == 0 || !readIndexEntry(index, 0, entry)) {
+    index.close();
+    return false;
+  }
+  const uint32_t from = entry.timestamp + fromMs;
+  const uint32_t to = entry.timestamp + toMs;
+  
+  // Last entry at or before the start of the window
+  uint32_t low = 0;
+  uint32_t high = entries;
+  while (high - low > 1) {
+    uint32_t middle = (low + high) / 2;
+    if (readIndexEntry(index, middle, entry) && entry.timestamp <= from) {
+      low = middle;
+    } else {
+      high = middle;
+    }
+  }
+  readIndexEntry(index, low, entry);
+  startOffset = entry.offset;
+  
+  // First entry after the end of the window, or the end of the file
+  high = entries;
+  while (low < high) {
+    uint32_t middle = (low + high) / 2;
+    if (readIndexEntry(index, middle, entry) && entry.timestamp <= to) {
+      low = middle + 1;
+    } else {
+      high = middle;
+    }
+  }
+  bool bounded = high < entries && readIndexEntry(index, high, entry);
+  index.close();
+  
+  if (bounded) {
+    endOffset = entry.offset;
+  } else {
+    File log = SPIFFS.open(logFileName, "r");
+    endOffset = log ? log.size() : startOffset;
+    log.close();
+  }
+  return true;
+}
+
+void DataLoggingTask::storePyramidBuckets(uint8_t levels) {
+  for (uint8_t level = 0; level < PYRAMID_LEVELS; level++) {
+    if (levels & (1 << level)) {
+      pyramidBuffer[level][pyramidCount[level]++] = pyramid.getRecord(level);
+      if (pyramidCount[level] >= PYRAMID_BUFFER_RECORDS) {
+        writePyramidBufferToFlash(level);
+      }
+    }
+  }
+}
+
+void DataLoggingTask::writePyramidBufferToFlash(uint8_t level) {
+  if (pyramidCount[level] == 0 || currentFileName.length() == 0) {
+    return;
+  }
+  
+  String sidecarName = getSidecarFileName(currentFileName, MinMaxPyramid::suffix(level));
+  File sidecar = SPIFFS.open(sidecarName, "a");
+  if (!sidecar) {
+    Print& log = debugOutput.at(LOG_LEVEL_ERROR);
+    log.print(F("Failed to open pyramid level '"));
+    log.print(sidecarName);
+    log.println(F("'"));
+    return;
+  }
+  
+  size_t bytes = sidecar.write(reinterpret_cast<const uint8_t*>(pyramidBuffer[level]),
+                               pyramidCount[level] * sizeof(MPUPyramidRecord));
+  sidecar.close();
+  if (statusTask) {
+    statusTask->noteFlashWrite(bytes);
+  }
+  pyramidCount[level] = 0;
+}
+
+void DataLoggingTask::writeBurst(MPUSensorTask& sensor) {
+  burstSensor = &sensor;
+  burstWritten = 0;
+  runInterval = 0;  // Write the arena out as fast as the loop allows
+}
+
+// Writes BURST_WRITE_RECORDS calibrated, unfiltered records per run to a file of its own,
+// so a recording started meanwhile is not disturbed
+void DataLoggingTask::writeBurstRecords() {
+  BurstCapture& burst = burstSensor->getBurst();
+  
+  if (burst.getState() == BurstCapture::BURST_CAPTURED) {
+    String fileName = String(LOG_FILE_PREFIX) + String(findNextFileNumber()) + String(LOG_FILE_SUFFIX);
+    burstFile = SPIFFS.open(fileName, "w");
+    burst.setFileName(fileName);
+    burst.setState(burstFile ? BurstCapture::BURST_WRITING : BurstCapture::BURST_FAILED);
+  }
+  
+  bool failed = burst.getState() != BurstCapture::BURST_WRITING;
+  uint32_t start = burstWritten;
+  uint32_t end = burstWritten + BURST_WRITE_RECORDS;
+  if (end > burst.getSampleCount()) {
+    end = burst.getSampleCount();
+  }
+  
+  while (!failed && burstWritten < end) {
+    int16_t rawAccel[3], rawGyro[3];
+    int32_t fixedAccel[3], fixedGyro[3];
+    burst.getSample(burstWritten, rawAccel, rawGyro);
+    burstSensor->calibrateRawSample(rawAccel, rawGyro, fixedAccel, fixedGyro);
+    
+    MPULogRecord record;
+    record.timestamp = burst.getStartMillis() + burstWritten * 1000UL / BURST_RATE_HZ;
+    record.accel_x = fixedAccel[0] * (1.0f / ACCEL_FIXED_PER_G);
+    record.accel_y = fixedAccel[1] * (1.0f / ACCEL_FIXED_PER_G);
+    record.accel_z = fixedAccel[2] * (1.0f / ACCEL_FIXED_PER_G);
+    record.yaw = fixedGyro[0] * (1.0f / GYRO_FIXED_PER_DPS);
+    record.pitch = fixedGyro[1] * (1.0f / GYRO_FIXED_PER_DPS);
+    record.roll = fixedGyro[2] * (1.0f / GYRO_FIXED_PER_DPS);
+    record.flags = MPULogRecord::FLAG_BURST;
+    record.setCalibrated(burstSensor->isCalibrated);
+    failed = !record.writeToFile(burstFile);
+    burstWritten++;
+  }
+  if (statusTask) {
+    statusTask->noteFlashWrite((burstWritten - start) * sizeof(MPULogRecord));
+  }
+  
+  if (failed || burstWritten >= burst.getSampleCount()) {
+    if (burstFile) {
+      burstFile.close();
+    }
+    if (statusTask) {
+      statusTask->noteFlashChanged();
+    }
+    burst.release();
+    burst.setState(failed ? BurstCapture::BURST_FAILED : BurstCapture::BURST_COMMITTED);
+    burstSensor = nullptr;
+    runInterval = 500;
+    
+    Print& log = debugOutput.at(failed ? LOG_LEVEL_ERROR : LOG_LEVEL_INFO);
+    log.print(failed ? F("Burst: failed writing ") : F("Burst: committed "));
+    log.print(burstWritten);
+    log.println(F(" records"));
+  }
+}
+
+void DataLoggingTask::logSpectrum(const MPUSpectrumHeader& header, const uint16_t* bins) {
+  if (!recording || currentFileName.length() == 0) {
+    return;
+  }
+  
+  // A frame is already several hundred bytes, so it is written straight through
+  String sidecarName = getSidecarFileName(currentFileName, LOG_SPECTRUM_SUFFIX);
+  File sidecar = SPIFFS.open(sidecarName, "a");
+  if (!sidecar) {
+    Print& log = debugOutput.at(LOG_LEVEL_ERROR);
+    log.print(F("Failed to open spectrum log '"));
+    log.print(sidecarName);
+    log.println(F("'"));
+    return;
+  }
+  
+  size_t bytes = sidecar.write(reinterpret_cast<const uint8_t*>(&header), sizeof(header));
+  bytes += sidecar.write(reinterpret_cast<const uint8_t*>(bins), (size_t)header.binCount * header.axisCount * sizeof(uint16_t));
+  sidecar.close();
+  if (statusTask) {
+    statusTask->noteFlashWrite(bytes);
+  }
+}
+
+const char* DataLoggingTask::getLogFileSuffix(const String& fileName) {
+  if (!fileName.startsWith(LOG_FILE_PREFIX)) {
+    return nullptr;
+  }
+  if (fileName.endsWith(LOG_FILE_SUFFIX)) {
+    return LOG_FILE_SUFFIX;
+  }
+  if (fileName.endsWith(LOG_SUMMARY_SUFFIX)) {
+    return LOG_SUMMARY_SUFFIX;
+  }
+  if (fileName.endsWith(LOG_HISTOGRAM_SUFFIX)) {
+    return LOG_HISTOGRAM_SUFFIX;
+  }
+  return nullptr;
+}
+
+String DataLoggingTask::getSidecarFileName(const String& logFileName, const char* suffix) {
+  const char* logSuffix = getLogFileSuffix(logFileName);
+  if (!logSuffix) {
+    return logFileName + suffix;
+  }
+  return logFileName.substring(0, logFileName.length() - strlen(logSuffix)) + suffix;
+}
+
+void DataLoggingTask::removeSidecarFiles(const String& logFileName) {
+  if (!getLogFileSuffix(logFileName)) {
+    return;
+  }
+  
+  String temperatureFile = getSidecarFileName(logFileName, LOG_TEMPERATURE_SUFFIX);
+  if (SPIFFS.exists(temperatureFile)) {
+    SPIFFS.remove(temperatureFile);
+  }
+  
+  String spectrumFile = getSidecarFileName(logFileName, LOG_SPECTRUM_SUFFIX);
+  if (SPIFFS.exists(spectrumFile)) {
+    SPIFFS.remove(spectrumFile);
+  }
+  
+  String indexFile = getSidecarFileName(logFileName, LOG_INDEX_SUFFIX);
+  if (SPIFFS.exists(indexFile)) {
+    SPIFFS.remove(indexFile);
+  }
+  
+  for (uint8_t level = 0; level < PYRAMID_LEVELS; level++) {
+    String pyramidFile = getSidecarFileName(logFileName, MinMaxPyramid::suffix(level));
+    if (SPIFFS.exists(pyramidFile)) {
+      SPIFFS.remove(pyramidFile);
+    }
+  }
+}
+
+void DataLoggingTask::inhibited() {
+  // ff_LogTask strategy: Flush ramBuffer when inhibited to prevent data loss
+  if(hasBufferedRecords()) {
+    writePageBufferToFlash();
     writeRamBufferToFlash();
   }
   
@@ -126,44 +802,45 @@ String DataLoggingTask::getCurrentLogFileName() const {
   return currentFileName;
 }
 
+void DataLoggingTask::setStatusTask(StatusTask* statusTask) {
+  this->statusTask = statusTask;
+}
+
 bool DataLoggingTask::deleteLogFile(const String& fileName) {
   if (SPIFFS.exists(fileName)) {
+    removeSidecarFiles(fileName);
+    if (statusTask) {
+      statusTask->noteFlashChanged();
+    }
     return SPIFFS.remove(fileName);
   }
   return false;
 }
 
-String DataLoggingTask::listLogFiles() {
-  String fileList = "[";
-  Dir dir = SPIFFS.openDir("/");
-  bool first = true;
-  
-  while (dir.next()) {
-    String fileName = dir.fileName();
-    if (fileName.startsWith(LOG_FILE_PREFIX) && fileName.endsWith(LOG_FILE_SUFFIX)) {
-      if (!first) {
-        fileList += ",";
-      }
-      fileList += "{\"name\":\"" + fileName + "\",\"size\":" + String(dir.fileSize()) + "}";
-      first = false;
-    }
+void DataLoggingTask::getNextFileName() {
+  currentFileNumber = findNextFileNumber();
+  // Use consistent naming without zero-padding to match existing files
+  const char* suffix = LOG_FILE_SUFFIX;
+  if (activeLogMode == LOG_MODE_SUMMARY) {
+    suffix = LOG_SUMMARY_SUFFIX;
+  } else if (activeLogMode == LOG_MODE_HISTOGRAM) {
+    suffix = LOG_HISTOGRAM_SUFFIX;
   }
-  
-  fileList += "]";
-  return fileList;
+  currentFileName = String(LOG_FILE_PREFIX) + String(currentFileNumber) + String(suffix);
 }
 
-
-void DataLoggingTask::getNextFileName() {
+uint16_t DataLoggingTask::findNextFileNumber() {
   uint16_t maxFileNum = 0;
   Dir dir = SPIFFS.openDir("/");
   
   while (dir.next()) {
     String fileName = dir.fileName();
-    if (fileName.startsWith(LOG_FILE_PREFIX) && fileName.endsWith(LOG_FILE_SUFFIX)) {
+    const char* suffix = getLogFileSuffix(fileName);
+    if (suffix) {
+      // All log modes share one numbering sequence so sidecars never collide
       // Extract number more robustly - handle both padded and unpadded
       int prefixLen = strlen(LOG_FILE_PREFIX);
-      int suffixLen = strlen(LOG_FILE_SUFFIX);
+      int suffixLen = strlen(suffix);
       int numStart = prefixLen;
       int numEnd = fileName.length() - suffixLen;
       
@@ -177,9 +854,7 @@ void DataLoggingTask::getNextFileName() {
     }
   }
   
-  currentFileNumber = maxFileNum + 1;
-  // Use consistent naming without zero-padding to match existing files
-  currentFileName = String(LOG_FILE_PREFIX) + String(currentFileNumber) + String(LOG_FILE_SUFFIX);
+  return maxFileNum + 1;
 }
 
 void DataLoggingTask::openLogFile() {
@@ -188,50 +863,60 @@ void DataLoggingTask::openLogFile() {
   }
   
   currentFile = SPIFFS.open(currentFileName, "w");
+  pagesWritten = 0;
   if (currentFile) {
-    Serial.print(F("Opened log file: "));
-    Serial.println(currentFileName);
+    if (usesPackedRecords()) {
+      MPULogHeader header;
+      header.magic = LOG_HEADER_MAGIC;
+      header.version = LOG_HEADER_VERSION;
+      header.channelMask = activeChannelMask;
+      header.recordSize = packedRecordSize;
+      header.layout = activeColumnar ? LOG_LAYOUT_COLUMNAR : LOG_LAYOUT_RECORDS;
+      currentFile.write(reinterpret_cast<const uint8_t*>(&header), sizeof(header));
+    }
+    debugOutput.print(F("Opened log file: "));
+    debugOutput.println(currentFileName);
   } else {
-    Serial.println(F("Failed to open log file"));
+    debugOutput.at(LOG_LEVEL_ERROR).println(F("Failed to open log file"));
   }
 }
 
 void DataLoggingTask::closeLogFile() {
+  writeTemperatureBufferToFlash();
+  writeIndexBufferToFlash();
+  for (uint8_t level = 0; level < PYRAMID_LEVELS; level++) {
+    writePyramidBufferToFlash(level);
+  }
+  
   if (currentFile && currentFile.isFile()) {
+    writeSummaryBufferToFlash();
     currentFile.close();
+    if (statusTask) {
+      statusTask->noteFlashChanged();
+    }
     if (currentFileName.length() > 0) {
-      Serial.print(F("Closed log file: "));
-      Serial.println(currentFileName);
+      debugOutput.print(F("Closed log file: "));
+      debugOutput.println(currentFileName);
     }
   }
 }
 
-String DataLoggingTask::formatFileSize(size_t bytes) {
-  if (bytes < 1024) {
-    return String(bytes) + " B";
-  } else if (bytes < 1024 * 1024) {
-    return String(bytes / 1024.0, 1) + " KB";
-  } else {
-    return String(bytes / (1024.0 * 1024.0), 1) + " MB";
-  }
-}
-
 // ff_LogTask strategy: Pushes a MPULogRecord onto the end of the ramBuffer array
 void DataLoggingTask::ramBufferPut(MPULogRecord rec) {
   uint16_t recCount = 0;
-
+  
   // Add record to ram buffer (circular shift like ff_LogTask)
   for(uint16_t i = 0; i < RAM_BUFFER_SIZE - 1; i++) {
     ramBuffer[i] = ramBuffer[i + 1];
     if(ramBuffer[i].timestamp > 0) recCount++;
   }
   ramBuffer[RAM_BUFFER_SIZE - 1] = rec;
-
+  
   // Count the number of records in the buffer
   for(uint16_t i = 0; i < RAM_BUFFER_SIZE; i++) {
     if(ramBuffer[i].timestamp > 0) recCount++;
   }
-
+  
   // ff_LogTask strategy: If the size of the records in the buffer + the size of an additional 
   // record would be greater than the page size of the SPIFFS file system (256 bytes), 
   // then it's time to flush the ram buffer onto flash.
@@ -250,19 +935,28 @@ void DataLoggingTask::writeRamBufferToFlash() {
   // Ensure file is open for writing
   if (!currentFile || !currentFile.isFile()) {
     if (!createNewLogFile()) {
-      Serial.println(F("Failed to create log file"));
+      debugOutput.at(LOG_LEVEL_ERROR).println(F("Failed to create log file"));
       return;
     }
   }
-
+  
   // File should already be open - verify it's valid for writing
   if(!currentFile) {
-    Serial.print(F("Log file '"));
-    Serial.print(currentFileName);
-    Serial.println(F("' is not available for writing."));
+    Print& log = debugOutput.at(LOG_LEVEL_ERROR);
+    log.print(F("Log file '"));
+    log.print(currentFileName);
+    log.println(F("' is not available for writing."));
     return;
   }
-
+  
+  // One index entry per page, from its first record, whether or not every write succeeds
+  for(uint16_t i = 0; i < RAM_BUFFER_SIZE; i++) {
+    if(ramBuffer[i].timestamp > 0) {
+      indexPage(ramBuffer[i].timestamp);
+      break;
+    }
+  }
+  
   uint16_t recordsWritten = 0;
   for(uint16_t i = 0; i < RAM_BUFFER_SIZE; i++) {
     if(ramBuffer[i].timestamp > 0) {
@@ -270,19 +964,24 @@ void DataLoggingTask::writeRamBufferToFlash() {
         ramBuffer[i].timestamp = 0; // Marks buffer record as empty
         recordsWritten++;
       } else {
-        Serial.print(F("Failed to write record to '"));
-        Serial.print(currentFileName);
-        Serial.println(F("'."));
+        Print& log = debugOutput.at(LOG_LEVEL_ERROR);
+        log.print(F("Failed to write record to '"));
+        log.print(currentFileName);
+        log.println(F("'."));
       }
     }
   }  
   
   currentFile.flush();
+  if (statusTask) {
+    statusTask->noteFlashWrite(recordsWritten * sizeof(MPULogRecord));
+  }
   
   if(recordsWritten > 0) {
     lastFlushTime = millis();
-    Serial.print(F("Wrote "));
-    Serial.print(recordsWritten);
-    Serial.println(F(" records to log (page-aligned)"));
+    Print& log = debugOutput.at(LOG_LEVEL_DEBUG);
+    log.print(F("Wrote "));
+    log.print(recordsWritten);
+    log.println(F(" records to log (page-aligned)"));
   }
 }
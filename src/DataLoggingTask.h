@@ -3,11 +3,18 @@
 
 #include "Task.h"
 #include "MPULogRecord.h"
+#include "SensorSample.h"
+#include "SummaryStatistics.h"
+#include "SampleHistogram.h"
+#include "MinMaxPyramid.h"
 #include "constants.h"
+#include "JsonWriter.h"
 #include <FS.h>
 
 // Forward declaration
 class Settings;
+class MPUSensorTask;
+class StatusTask;
 
 class DataLoggingTask : public Task {
   public:
@@ -26,7 +33,9 @@ class DataLoggingTask : public Task {
     bool createNewLogFile();
     String getCurrentLogFileName() const;
     bool deleteLogFile(const String& fileName);
-    String listLogFiles();
+    
+    // Told about bytes written and files closed or deleted, to keep free space current
+    void setStatusTask(StatusTask* statusTask);
     
     // Recording state management methods
     bool isRecording() const;
@@ -38,6 +47,38 @@ class DataLoggingTask : public Task {
     void logSensorData(float accel_x, float accel_y, float accel_z, 
                       float yaw, float pitch, float roll);
     
+    // Every acquired sample, used by the summary and histogram logging modes
+    void logFullRateSample(const SensorSample& sample);
+    
+    // Histogram mode: current interval and totals since the histograms were reset
+    void writeHistogramJSON(JsonWriter& json);
+    
+    // Raw mode write volume for the current or last recording
+    bool isDeadbandActive() const;
+    uint32_t getSamplesOffered() const;
+    uint32_t getRecordsCommitted() const;
+    
+    // Writes a completed burst capture of the sensor to a new raw log file over the following
+    // runs, then frees its arena and marks it committed
+    void writeBurst(MPUSensorTask& sensor);
+    
+    // Low-rate temperature side channel, written to a sidecar of the current log file
+    void logTemperature(float celsius);
+    
+    // Vibration spectrum frame, appended to a sidecar of the current log file
+    void logSpectrum(const MPUSpectrumHeader& header, const uint16_t* bins);
+    
+    // Remove the sidecar files that belong to a log file
+    static void removeSidecarFiles(const String& logFileName);
+    
+    // Byte range of a raw log covering fromMs..toMs after its first record, found by binary
+    // searching its time index. False when the log has no index.
+    static bool findTimeRange(const String& logFileName, uint32_t fromMs, uint32_t toMs,
+                              uint32_t& startOffset, uint32_t& endOffset);
+    
+    // LOG_FILE_SUFFIX or LOG_SUMMARY_SUFFIX for a log file name, nullptr for anything else
+    static const char* getLogFileSuffix(const String& fileName);
+    
     // File management for sensor task
     void openLogFile();
     void closeLogFile();
@@ -46,9 +87,28 @@ class DataLoggingTask : public Task {
     
   private:
     Settings* settings;
+    StatusTask* statusTask = nullptr;
     
     // Recording state
     bool recording = false;
+    uint8_t activeLogMode = LOG_MODE_RAW;  // Settings::logMode latched when recording starts
+    
+    // Deadband logging, latched when recording starts like the log mode
+    bool deadbandActive = false;
+    bool hasCommittedRecord = false;
+    MPULogRecord lastCommittedRecord;
+    uint32_t samplesOffered = 0;
+    uint32_t recordsCommitted = 0;
+    
+    // Channel mask and page layout, latched when recording starts. Anything but all channels
+    // in record layout writes an MPULogHeader and packs records into pageBuffer instead of
+    // using ramBuffer; columnar pages are transposed from pageBuffer when it is flushed.
+    uint8_t activeChannelMask = LOG_CHANNELS_ALL;
+    bool activeColumnar = false;
+    uint8_t packedRecordSize = 0;
+    uint8_t pageRecordCapacity = 0;
+    uint8_t pageBuffer[LOG_PAGE_SIZE];
+    uint16_t pageBytes = 0;
     
     // Constants for page-based buffering (ff_LogTask strategy)
     static const uint8_t MAX_LOG_FILES = 10;
@@ -64,11 +124,67 @@ class DataLoggingTask : public Task {
     MPULogRecord ramBuffer[RAM_BUFFER_SIZE];
     unsigned long lastFlushTime;
     
+    // Temperature side channel buffer, one flash page
+    static const uint8_t TEMPERATURE_BUFFER_SIZE = 256 / sizeof(MPUTemperatureRecord);
+    MPUTemperatureRecord temperatureBuffer[TEMPERATURE_BUFFER_SIZE];
+    uint8_t temperatureCount = 0;
+    
+    // Time index entries for the current raw log, one flash page
+    static const uint8_t INDEX_BUFFER_SIZE = 256 / sizeof(MPUIndexEntry);
+    MPUIndexEntry indexBuffer[INDEX_BUFFER_SIZE];
+    uint8_t indexCount = 0;
+    uint32_t pagesWritten = 0;
+    
+    // Min/max pyramid of the current raw log, latched when recording starts, and one page of
+    // finished buckets per level
+    bool pyramidActive = false;
+    MinMaxPyramid pyramid;
+    MPUPyramidRecord pyramidBuffer[PYRAMID_LEVELS][PYRAMID_BUFFER_RECORDS];
+    uint8_t pyramidCount[PYRAMID_LEVELS];
+    
+    // Summary mode window accumulator and one page of finished records
+    static const uint8_t SUMMARY_BUFFER_SIZE = 256 / sizeof(MPUSummaryRecord);
+    SummaryStatistics summary;
+    MPUSummaryRecord summaryBuffer[SUMMARY_BUFFER_SIZE];
+    uint8_t summaryCount = 0;
+    
+    // Histogram mode counts, kept live whenever the mode is selected and snapshotted per interval
+    SampleHistogram histogram;          // Current interval
+    SampleHistogram histogramTotal;     // Completed intervals
+    uint32_t histogramStartMillis = 0;
+    bool histogramActive = false;
+    
+    // Burst capture being written out, if any
+    MPUSensorTask* burstSensor = nullptr;
+    File burstFile;
+    uint32_t burstWritten = 0;
+    
     // Internal methods
     void ramBufferPut(MPULogRecord rec);  // Add record to buffer with page-size checking
     void writeRamBufferToFlash();          // Write full page to SPIFFS
+    bool usesPackedRecords() const;
+    bool hasBufferedRecords() const;
+    void packRecord(const MPULogRecord& record);
+    void writePageBufferToFlash();
+    uint16_t transposePageBuffer(uint8_t* columns) const;
+    void writeTemperatureBufferToFlash();
+    void indexPage(uint32_t timestamp);
+    void writeIndexBufferToFlash();
+    static bool readIndexEntry(File& index, uint32_t position, MPUIndexEntry& entry);
+    void storePyramidBuckets(uint8_t levels);
+    void writePyramidBufferToFlash(uint8_t level);
+    bool outsideDeadband(const MPULogRecord& record) const;
+    void finishSummaryWindow(bool partial);
+    void writeSummaryBufferToFlash();
+    void updateHistogram(const SensorSample& sample);
+    void finishHistogramInterval(uint32_t durationMs, bool partial);
+    void writeHistogramSnapshot(uint32_t durationMs, bool partial);
+    static void writeHistogramCounts(JsonWriter& json, const char* key, const SampleHistogram& histogram,
+                                     const SampleHistogram* extra, uint8_t channel);
     void getNextFileName();
-    String formatFileSize(size_t bytes);
+    uint16_t findNextFileNumber();
+    void writeBurstRecords();
+    static String getSidecarFileName(const String& logFileName, const char* suffix);
 };
 
 #endif
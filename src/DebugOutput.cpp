@@ -0,0 +1,138 @@
+#include "DebugOutput.h"
+#include "SerialStreamTask.h"
+
+size_t DebugOutput::write(uint8_t c) {
+  return write(&c, 1);
+}
+
+size_t DebugOutput::write(const uint8_t* buffer, size_t size) {
+  if (!isEnabled(LOG_LEVEL_INFO)) {
+    return size;
+  }
+  return append(buffer, size);
+}
+
+size_t DebugOutput::append(const uint8_t* buffer, size_t size) {
+  if (isStreaming()) {
+    serialStreamTask->addText(buffer, size);
+    return size;
+  }
+  
+  for (size_t i = 0; i < size; i++) {
+    uint8_t c = buffer[i];
+    if (dropping) {
+      dropping = c != '\n';
+      continue;
+    }
+    
+    // A cut-short line is ended first so the next message starts on its own line
+    if (truncated && used < LOG_RING_BYTES) {
+      ring[head] = '\n';
+      head = (head + 1) % LOG_RING_BYTES;
+      used++;
+      truncated = false;
+    }
+    if (used >= LOG_RING_BYTES) {
+      droppedMessages++;
+      dropping = c != '\n';
+      truncated = true;
+      continue;
+    }
+    
+    ring[head] = c;
+    head = (head + 1) % LOG_RING_BYTES;
+    used++;
+  }
+  if (used > highWater) {
+    highWater = used;
+  }
+  
+  drain();
+  return size;
+}
+
+Print& DebugOutput::at(uint8_t level) {
+  if (!isEnabled(level)) {
+    return nullOutput;
+  }
+  return levelOutput;
+}
+
+bool DebugOutput::isEnabled(uint8_t level) const {
+  return level <= this->level;
+}
+
+void DebugOutput::setLevel(uint8_t level) {
+  this->level = level > LOG_LEVEL_DEBUG ? LOG_LEVEL_DEBUG : level;
+}
+
+uint8_t DebugOutput::getLevel() const {
+  return level;
+}
+
+void DebugOutput::drain() {
+  writeRing(false);
+}
+
+void DebugOutput::flush() {
+  writeRing(true);
+  Serial.flush();
+}
+
+void DebugOutput::setSerialStreamTask(SerialStreamTask* serialStreamTask) {
+  this->serialStreamTask = serialStreamTask;
+}
+
+void DebugOutput::writeStatusJSON(JsonWriter& json) const {
+  json.add("level", levelName(level));
+  json.add("bufferUsed", (unsigned int)used);
+  json.add("bufferHighWater", (unsigned int)highWater);
+  json.add("bufferSize", LOG_RING_BYTES);
+  json.add("droppedMessages", (unsigned long)droppedMessages);
+}
+
+const char* DebugOutput::levelName(uint8_t level) {
+  switch (level) {
+    case LOG_LEVEL_ERROR: return "error";
+    case LOG_LEVEL_WARN: return "warn";
+    case LOG_LEVEL_DEBUG: return "debug";
+    default: return "info";
+  }
+}
+
+uint8_t DebugOutput::levelFromName(const char* name) {
+  if (name && strcmp(name, "error") == 0) return LOG_LEVEL_ERROR;
+  if (name && strcmp(name, "warn") == 0) return LOG_LEVEL_WARN;
+  if (name && strcmp(name, "debug") == 0) return LOG_LEVEL_DEBUG;
+  return LOG_LEVEL_INFO;
+}
+
+bool DebugOutput::isStreaming() const {
+  return serialStreamTask && serialStreamTask->isStreaming();
+}
+
+void DebugOutput::writeRing(bool blocking) {
+  // The UART belongs to the sample frames while streaming
+  if (isStreaming()) {
+    return;
+  }
+  
+  while (used > 0) {
+    uint16_t chunk = LOG_RING_BYTES - tail;
+    if (chunk > used) {
+      chunk = used;
+    }
+    if (!blocking) {
+      int room = Serial.availableForWrite();
+      if (room <= 0) {
+        return;
+      }
+      if (chunk > room) {
+        chunk = room;
+      }
+    }
+    Serial.write(ring + tail, chunk);
+    tail = (tail + chunk) % LOG_RING_BYTES;
+    used -= chunk;
+  }
+}
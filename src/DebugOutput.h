@@ -0,0 +1,84 @@
+#ifndef DEBUG_OUTPUT_H
+#define DEBUG_OUTPUT_H
+
+#include <Arduino.h>
+#include "constants.h"
+#include "JsonWriter.h"
+
+// Forward declaration
+class SerialStreamTask;
+
+// Destination of all debug text. Text is formatted into a fixed RAM ring and drained to Serial
+// only as fast as the UART FIFO accepts it, after each write and from loop(), so printing never
+// waits on the baud rate. When the ring is full the rest of the line is dropped and counted.
+// While the binary serial stream is running the text goes to SerialStreamTask as text frames.
+//
+// Plain print() is LOG_LEVEL_INFO and is dropped when Settings::logLevel is below it. Errors and
+// warnings use at(LOG_LEVEL_ERROR) / at(LOG_LEVEL_WARN).print(...), chatty messages
+// at(LOG_LEVEL_DEBUG); each goes nowhere unless the level allows it.
+class DebugOutput : public Print {
+  public:
+    virtual size_t write(uint8_t c) override;
+    virtual size_t write(const uint8_t* buffer, size_t size) override;
+    using Print::write;
+    
+    // Output for a message at level; a sink that discards everything if the level is disabled
+    Print& at(uint8_t level);
+    bool isEnabled(uint8_t level) const;
+    void setLevel(uint8_t level);
+    uint8_t getLevel() const;
+    
+    // Writes as much of the ring as the UART can take without waiting
+    void drain();
+    
+    // Waits until the ring has been written out
+    virtual void flush() override;
+    
+    void setSerialStreamTask(SerialStreamTask* serialStreamTask);
+    
+    void writeStatusJSON(JsonWriter& json) const;
+    
+    static const char* levelName(uint8_t level);
+    static uint8_t levelFromName(const char* name);
+  
+  private:
+    class NullOutput : public Print {
+      public:
+        virtual size_t write(uint8_t) override { return 1; }
+        virtual size_t write(const uint8_t*, size_t size) override { return size; }
+    };
+    
+    // Returned by at() for an enabled level, so the text skips the LOG_LEVEL_INFO check
+    class LevelOutput : public Print {
+      public:
+        explicit LevelOutput(DebugOutput& owner) : owner(owner) {}
+        virtual size_t write(uint8_t c) override { return owner.append(&c, 1); }
+        virtual size_t write(const uint8_t* buffer, size_t size) override { return owner.append(buffer, size); }
+      
+      private:
+        DebugOutput& owner;
+    };
+    
+    SerialStreamTask* serialStreamTask = nullptr;
+    NullOutput nullOutput;
+    LevelOutput levelOutput{*this};
+    uint8_t level = LOG_LEVEL_INFO;
+    
+    uint8_t ring[LOG_RING_BYTES];
+    uint16_t head = 0;
+    uint16_t tail = 0;
+    uint16_t used = 0;
+    uint16_t highWater = 0;
+    bool dropping = false;      // Discarding the rest of a line that did not fit
+    bool truncated = false;     // A line was cut short; end it before the next one
+    uint32_t droppedMessages = 0;
+    
+    bool isStreaming() const;
+    size_t append(const uint8_t* buffer, size_t size);
+    void writeRing(bool blocking);
+};
+
+// Defined in MPULogger.ino ahead of settings, which prints from its constructor
+extern DebugOutput debugOutput;
+
+#endif
@@ -0,0 +1,69 @@
+#include "Decimator.h"
+#include <string.h>
+
+Decimator::Decimator() {
+  configure(1, 1);
+}
+
+void Decimator::configure(uint8_t order, uint16_t ratio) {
+  this->ratio = ratio < 1 ? 1 : ratio > DECIMATION_MAX_RATIO ? DECIMATION_MAX_RATIO : ratio;
+  this->order = order < 1 ? 1 : order > DECIMATION_MAX_ORDER ? DECIMATION_MAX_ORDER : order;
+  
+  // Drop stages until the DC gain (and so the register growth) fits
+  for (;;) {
+    int32_t g = 1;
+    for (uint8_t i = 0; i < this->order; i++) {
+      g *= this->ratio;
+    }
+    if (g <= DECIMATION_MAX_GAIN || this->order == 1) {
+      gain = g;
+      break;
+    }
+    this->order--;
+  }
+  
+  reset();
+}
+
+void Decimator::reset() {
+  phase = 0;
+  memset(integrator, 0, sizeof(integrator));
+  memset(combDelay, 0, sizeof(combDelay));
+}
+
+bool Decimator::push(const int32_t input[CHANNELS], int32_t output[CHANNELS]) {
+  for (uint8_t c = 0; c < CHANNELS; c++) {
+    uint32_t value = (uint32_t)input[c];
+    for (uint8_t s = 0; s < order; s++) {
+      integrator[s][c] += value;
+      value = integrator[s][c];
+    }
+  }
+  
+  if (++phase < ratio) {
+    return false;
+  }
+  phase = 0;
+  
+  for (uint8_t c = 0; c < CHANNELS; c++) {
+    uint32_t value = integrator[order - 1][c];
+    for (uint8_t s = 0; s < order; s++) {
+      uint32_t previous = combDelay[s][c];
+      combDelay[s][c] = value;
+      value -= previous;
+    }
+    
+    // Remove the DC gain with rounding
+    int32_t sum = (int32_t)value;
+    output[c] = (sum >= 0 ? sum + gain / 2 : sum - gain / 2) / gain;
+  }
+  return true;
+}
+
+uint8_t Decimator::getOrder() const {
+  return order;
+}
+
+uint16_t Decimator::getRatio() const {
+  return ratio;
+}
@@ -0,0 +1,45 @@
+#ifndef DECIMATOR_H
+#define DECIMATOR_H
+
+#include <stdint.h>
+#include "constants.h"
+
+/**
+ * Cascaded integrator-comb (CIC) decimator for the six fixed-point sensor channels.
+ *
+ * Integrators run at the acquisition rate and combs at the output rate, so each input
+ * sample costs only order additions per channel with no multiplies. The response is
+ * sinc^order with nulls at every multiple of the output rate, which is where the
+ * energy that would alias onto DC and the low bins sits.
+ *
+ * Registers use wrapping 32-bit arithmetic, which is exact for a CIC as long as the
+ * output fits, so ratio^order is limited to DECIMATION_MAX_GAIN.
+ *
+ * Nothing here needs the Arduino core, so tools/decimator_benchmark.cpp builds it on the host.
+ */
+class Decimator {
+  public:
+    static const uint8_t CHANNELS = 6;
+    
+    Decimator();
+    
+    // Order is reduced if ratio^order would exceed DECIMATION_MAX_GAIN
+    void configure(uint8_t order, uint16_t ratio);
+    void reset();
+    
+    // Feed one sample. Returns true and fills output once every ratio samples.
+    bool push(const int32_t input[CHANNELS], int32_t output[CHANNELS]);
+    
+    uint8_t getOrder() const;
+    uint16_t getRatio() const;
+    
+  private:
+    uint8_t order;
+    uint16_t ratio;
+    uint16_t phase;
+    int32_t gain;                                             // ratio^order
+    uint32_t integrator[DECIMATION_MAX_ORDER][CHANNELS];
+    uint32_t combDelay[DECIMATION_MAX_ORDER][CHANNELS];
+};
+
+#endif
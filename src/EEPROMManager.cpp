@@ -1,5 +1,10 @@
 #include "EEPROMManager.h"
 
+static_assert(EEPROM_CAL_BASE_ADDR + sizeof(CalibrationData) <= EEPROM_TEMPCOMP_BASE_ADDR,
+              "Calibration data overlaps the temperature compensation block");
+static_assert(EEPROM_TEMPCOMP_BASE_ADDR + sizeof(TemperatureCompData) <= EEPROM_SIZE,
+              "Temperature compensation block does not fit in EEPROM");
+
 EEPROMManager::EEPROMManager() : initialized(false) {
 }
 
@@ -21,6 +26,11 @@ bool EEPROMManager::loadCalibrationData(CalibrationData& data) {
         return false;
     }
     
+    // Older firmware stored offsets only - migrate that layout in memory
+    if (data.magicNumber == EEPROM_CAL_MAGIC_NUMBER && data.version == EEPROM_CAL_VERSION_LEGACY) {
+        return readLegacyCalibrationStruct(data);
+    }
+    
     // Validate the loaded data
     if (!isCalibrationDataValid(data)) {
         return false;
@@ -45,6 +55,37 @@ bool EEPROMManager::saveCalibrationData(const CalibrationData& data) {
     return writeCalibrationStruct(dataWithChecksum);
 }
 
+bool EEPROMManager::loadTemperatureCompData(TemperatureCompData& data) {
+    if (!initialized) {
+        return false;
+    }
+    
+    EEPROM.get(EEPROM_TEMPCOMP_BASE_ADDR, data);
+    
+    if (data.magicNumber != EEPROM_TEMPCOMP_MAGIC_NUMBER || data.version != EEPROM_TEMPCOMP_VERSION) {
+        return false;
+    }
+    
+    uint32_t expectedChecksum = calculateChecksum(reinterpret_cast<const uint8_t*>(&data),
+                                                  offsetof(TemperatureCompData, checksum));
+    return data.checksum == expectedChecksum && data.pointCount <= TEMPCOMP_MAX_POINTS;
+}
+
+bool EEPROMManager::saveTemperatureCompData(const TemperatureCompData& data) {
+    if (!initialized) {
+        return false;
+    }
+    
+    TemperatureCompData dataWithChecksum = data;
+    dataWithChecksum.magicNumber = EEPROM_TEMPCOMP_MAGIC_NUMBER;
+    dataWithChecksum.version = EEPROM_TEMPCOMP_VERSION;
+    dataWithChecksum.checksum = calculateChecksum(reinterpret_cast<const uint8_t*>(&dataWithChecksum),
+                                                  offsetof(TemperatureCompData, checksum));
+    
+    EEPROM.put(EEPROM_TEMPCOMP_BASE_ADDR, dataWithChecksum);
+    return EEPROM.commit();
+}
+
 bool EEPROMManager::isCalibrationDataValid(const CalibrationData& data) {
     // Check magic number
     if (!isValidMagicNumber(data.magicNumber)) {
@@ -85,13 +126,14 @@ size_t EEPROMManager::getCalibrationDataSize() const {
 }
 
 uint32_t EEPROMManager::calculateChecksum(const CalibrationData& data) const {
-    uint32_t checksum = 0;
-    const uint8_t* ptr = reinterpret_cast<const uint8_t*>(&data);
-    
     // Calculate checksum over all fields except the checksum itself
-    size_t checksumOffset = offsetof(CalibrationData, checksum);
+    return calculateChecksum(reinterpret_cast<const uint8_t*>(&data), offsetof(CalibrationData, checksum));
+}
+
+uint32_t EEPROMManager::calculateChecksum(const uint8_t* ptr, size_t length) const {
+    uint32_t checksum = 0;
     
-    for (size_t i = 0; i < checksumOffset; i++) {
+    for (size_t i = 0; i < length; i++) {
         checksum += ptr[i];
         checksum = (checksum << 1) | (checksum >> 31); // Rotate left
     }
@@ -112,6 +154,33 @@ bool EEPROMManager::readCalibrationStruct(CalibrationData& data) {
     return true;
 }
 
+bool EEPROMManager::readLegacyCalibrationStruct(CalibrationData& data) {
+    CalibrationDataV1 legacy;
+    EEPROM.get(EEPROM_CAL_BASE_ADDR, legacy);
+    
+    uint32_t expectedChecksum = calculateChecksum(reinterpret_cast<const uint8_t*>(&legacy),
+                                                  offsetof(CalibrationDataV1, checksum));
+    if (legacy.checksum != expectedChecksum || !(legacy.flags & EEPROM_CAL_FLAG_VALID)) {
+        return false;
+    }
+    
+    data = CalibrationData();
+    data.magicNumber = legacy.magicNumber;
+    data.version = EEPROM_CAL_VERSION;
+    data.flags = legacy.flags;
+    data.accelOffsetX = legacy.accelOffsetX;
+    data.accelOffsetY = legacy.accelOffsetY;
+    data.accelOffsetZ = legacy.accelOffsetZ;
+    data.gyroOffsetX = legacy.gyroOffsetX;
+    data.gyroOffsetY = legacy.gyroOffsetY;
+    data.gyroOffsetZ = legacy.gyroOffsetZ;
+    data.accelScaleX = 1.0;
+    data.accelScaleY = 1.0;
+    data.accelScaleZ = 1.0;
+    data.checksum = calculateChecksum(data);
+    return true;
+}
+
 bool EEPROMManager::writeCalibrationStruct(const CalibrationData& data) {
     EEPROM.put(EEPROM_CAL_BASE_ADDR, data);
     if (EEPROM.commit()) {
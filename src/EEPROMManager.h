@@ -10,12 +10,45 @@ struct __attribute__((packed)) CalibrationData {
     uint32_t magicNumber;      // 0x43414C45 ("CALE")
     uint8_t version;           // Data structure version
     uint8_t flags;             // Validity flags
-    float accelOffsetX;        // Accelerometer X offset
-    float accelOffsetY;        // Accelerometer Y offset  
-    float accelOffsetZ;        // Accelerometer Z offset
-    float gyroOffsetX;         // Gyroscope X offset
-    float gyroOffsetY;         // Gyroscope Y offset
-    float gyroOffsetZ;         // Gyroscope Z offset
+    float accelOffsetX;        // Accelerometer X offset (m/s^2)
+    float accelOffsetY;        // Accelerometer Y offset (m/s^2)
+    float accelOffsetZ;        // Accelerometer Z offset (m/s^2)
+    float gyroOffsetX;         // Gyroscope X offset (rad/s)
+    float gyroOffsetY;         // Gyroscope Y offset (rad/s)
+    float gyroOffsetZ;         // Gyroscope Z offset (rad/s)
+    float accelScaleX;         // Accelerometer X scale (measured / true, 1.0 = ideal)
+    float accelScaleY;         // Accelerometer Y scale
+    float accelScaleZ;         // Accelerometer Z scale
+    uint32_t checksum;         // Data integrity checksum
+};
+
+// Version 1 layout (offsets only). Read once and migrated to CalibrationData with unity scale.
+struct __attribute__((packed)) CalibrationDataV1 {
+    uint32_t magicNumber;
+    uint8_t version;
+    uint8_t flags;
+    float accelOffsetX;
+    float accelOffsetY;
+    float accelOffsetZ;
+    float gyroOffsetX;
+    float gyroOffsetY;
+    float gyroOffsetZ;
+    uint32_t checksum;
+};
+
+// Temperature compensation model, stored after the calibration block.
+// bias(T) = c0 + c1 * dT + c2 * dT^2 with dT = T - referenceTemp, per channel.
+struct __attribute__((packed)) TemperatureCompData {
+    uint32_t magicNumber;      // 0x54434D50 ("TCMP")
+    uint8_t version;           // Data structure version
+    uint8_t flags;             // EEPROM_TEMPCOMP_FLAG_* bits
+    uint8_t pointCount;        // Valid entries in pointTemp/pointBias
+    uint8_t order;             // Fitted polynomial order (0 = no fit)
+    float calibrationTemp;     // Die temperature of the active calibration (C)
+    float referenceTemp;       // Polynomial expansion point (C)
+    float pointTemp[TEMPCOMP_MAX_POINTS];                    // Calibration session temperatures (C)
+    float pointBias[TEMPCOMP_MAX_POINTS][TEMPCOMP_CHANNELS]; // Accel (m/s^2) and gyro (rad/s) offsets
+    float coefficients[TEMPCOMP_CHANNELS][TEMPCOMP_COEFFS];
     uint32_t checksum;         // Data integrity checksum
 };
 
@@ -30,6 +63,10 @@ class EEPROMManager {
     bool loadCalibrationData(CalibrationData& data);
     bool saveCalibrationData(const CalibrationData& data);
     
+    // Temperature compensation model operations
+    bool loadTemperatureCompData(TemperatureCompData& data);
+    bool saveTemperatureCompData(const TemperatureCompData& data);
+    
     // Validation operations
     bool isCalibrationDataValid(const CalibrationData& data);
     void clearCalibrationData();
@@ -42,6 +79,7 @@ class EEPROMManager {
     
     // Checksum calculation
     uint32_t calculateChecksum(const CalibrationData& data) const;
+    uint32_t calculateChecksum(const uint8_t* ptr, size_t length) const;
     
     // Data validation helpers
     bool isValidMagicNumber(uint32_t magic) const;
@@ -49,6 +87,7 @@ class EEPROMManager {
     
     // EEPROM operations
     bool readCalibrationStruct(CalibrationData& data);
+    bool readLegacyCalibrationStruct(CalibrationData& data);
     bool writeCalibrationStruct(const CalibrationData& data);
 };
 
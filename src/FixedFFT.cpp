@@ -0,0 +1,179 @@
+#include "FixedFFT.h"
+#include <stdlib.h>
+
+#ifdef ARDUINO
+#include <pgmspace.h>
+#else
+// Host build: the table is ordinary const data
+#define PROGMEM
+#define pgm_read_word(address) (*(const uint16_t*)(address))
+#endif
+
+// Largest component magnitude that cannot overflow int16 in one butterfly: 32767 / (1 + sqrt(2))
+static const uint16_t STAGE_HEADROOM = 13573;
+
+// Quarter wave of sin(2*pi*i/1024) in Q15, 257 entries so the table includes pi/2
+static const int16_t SINE_TABLE[FixedFFT::MAX_SIZE / 4 + 1] PROGMEM = {
+  0, 201, 402, 603, 804, 1005, 1206, 1407, 1608, 1809, 2009, 2210,
+  2411, 2611, 2811, 3012, 3212, 3412, 3612, 3812, 4011, 4211, 4410, 4609,
+  4808, 5007, 5205, 5404, 5602, 5800, 5998, 6195, 6393, 6590, 6787, 6983,
+  7180, 7376, 7571, 7767, 7962, 8157, 8351, 8546, 8740, 8933, 9127, 9319,
+  9512, 9704, 9896, 10088, 10279, 10469, 10660, 10850, 11039, 11228, 11417, 11605,
+  11793, 11980, 12167, 12354, 12540, 12725, 12910, 13095, 13279, 13463, 13646, 13828,
+  14010, 14192, 14373, 14553, 14733, 14912, 15091, 15269, 15447, 15624, 15800, 15976,
+  16151, 16326, 16500, 16673, 16846, 17018, 17190, 17361, 17531, 17700, 17869, 18037,
+  18205, 18372, 18538, 18703, 18868, 19032, 19195, 19358, 19520, 19681, 19841, 20001,
+  20160, 20318, 20475, 20632, 20788, 20943, 21097, 21251, 21403, 21555, 21706, 21856,
+  22006, 22154, 22302, 22449, 22595, 22740, 22884, 23028, 23170, 23312, 23453, 23593,
+  23732, 23870, 24008, 24144, 24279, 24414, 24548, 24680, 24812, 24943, 25073, 25202,
+  25330, 25457, 25583, 25708, 25833, 25956, 26078, 26199, 26320, 26439, 26557, 26674,
+  26791, 26906, 27020, 27133, 27246, 27357, 27467, 27576, 27684, 27791, 27897, 28002,
+  28106, 28209, 28311, 28411, 28511, 28610, 28707, 28803, 28899, 28993, 29086, 29178,
+  29269, 29359, 29448, 29535, 29622, 29707, 29792, 29875, 29957, 30038, 30118, 30196,
+  30274, 30350, 30425, 30499, 30572, 30644, 30715, 30784, 30853, 30920, 30986, 31050,
+  31114, 31177, 31238, 31298, 31357, 31415, 31471, 31527, 31581, 31634, 31686, 31737,
+  31786, 31834, 31881, 31927, 31972, 32015, 32058, 32099, 32138, 32177, 32214, 32251,
+  32286, 32319, 32352, 32383, 32413, 32442, 32470, 32496, 32522, 32546, 32568, 32590,
+  32610, 32629, 32647, 32664, 32679, 32693, 32706, 32718, 32729, 32738, 32746, 32753,
+  32758, 32762, 32766, 32767, 32767
+};
+
+bool FixedFFT::isValidSize(uint16_t n) {
+  return n >= MIN_SIZE && n <= MAX_SIZE && (n & (n - 1)) == 0;
+}
+
+int16_t FixedFFT::sinQ15(uint16_t index) {
+  const uint16_t quarter = MAX_SIZE / 4;
+  index &= (MAX_SIZE - 1);
+  
+  if (index <= quarter) {
+    return (int16_t)pgm_read_word(&SINE_TABLE[index]);
+  } else if (index <= 2 * quarter) {
+    return (int16_t)pgm_read_word(&SINE_TABLE[2 * quarter - index]);
+  } else if (index <= 3 * quarter) {
+    return -(int16_t)pgm_read_word(&SINE_TABLE[index - 2 * quarter]);
+  }
+  return -(int16_t)pgm_read_word(&SINE_TABLE[MAX_SIZE - index]);
+}
+
+int16_t FixedFFT::cosQ15(uint16_t index) {
+  return sinQ15(index + MAX_SIZE / 4);
+}
+
+void FixedFFT::applyHannWindow(int16_t* data, uint16_t n) {
+  const uint16_t stride = MAX_SIZE / n;
+  
+  for (uint16_t i = 0; i < n; i++) {
+    // w = 0.5 - 0.5 * cos(2*pi*i/n) in Q15
+    int32_t window = (32767 - (int32_t)cosQ15(i * stride)) >> 1;
+    data[i] = (int16_t)(((int32_t)data[i] * window) >> 15);
+  }
+}
+
+int8_t FixedFFT::normalize(int16_t* data, uint16_t n) {
+  uint16_t maxValue = 0;
+  for (uint16_t i = 0; i < n; i++) {
+    uint16_t value = abs(data[i]);
+    if (value > maxValue) {
+      maxValue = value;
+    }
+  }
+  if (maxValue == 0) {
+    return 0;
+  }
+  
+  int8_t shift = 0;
+  while ((uint32_t)maxValue << (shift + 1) <= STAGE_HEADROOM) {
+    shift++;
+  }
+  if (shift > 0) {
+    for (uint16_t i = 0; i < n; i++) {
+      data[i] = data[i] << shift;
+    }
+  }
+  return -shift;
+}
+
+uint16_t FixedFFT::peak(const int16_t* re, const int16_t* im, uint16_t n) {
+  uint16_t maxValue = 0;
+  for (uint16_t i = 0; i < n; i++) {
+    uint16_t r = abs(re[i]);
+    uint16_t m = abs(im[i]);
+    if (r > maxValue) maxValue = r;
+    if (m > maxValue) maxValue = m;
+  }
+  return maxValue;
+}
+
+int8_t FixedFFT::transform(int16_t* re, int16_t* im, uint16_t n) {
+  // Bit-reversal permutation
+  for (uint16_t i = 1, j = 0; i < n; i++) {
+    uint16_t bit = n >> 1;
+    for (; j & bit; bit >>= 1) {
+      j ^= bit;
+    }
+    j ^= bit;
+    if (i < j) {
+      int16_t t = re[i]; re[i] = re[j]; re[j] = t;
+      t = im[i]; im[i] = im[j]; im[j] = t;
+    }
+  }
+  
+  int8_t exponent = 0;
+  for (uint16_t len = 2; len <= n; len <<= 1) {
+    // Block floating point: halve everything only when this stage could overflow
+    if (peak(re, im, n) > STAGE_HEADROOM) {
+      for (uint16_t i = 0; i < n; i++) {
+        re[i] >>= 1;
+        im[i] >>= 1;
+      }
+      exponent++;
+    }
+    
+    const uint16_t half = len >> 1;
+    const uint16_t step = MAX_SIZE / len;
+    for (uint16_t k = 0; k < half; k++) {
+      // W = exp(-2*pi*i*k/len)
+      const int32_t wr = cosQ15(k * step);
+      const int32_t wi = -(int32_t)sinQ15(k * step);
+      
+      for (uint16_t i = k; i < n; i += len) {
+        const uint16_t j = i + half;
+        const int32_t tr = (wr * re[j] - wi * im[j]) >> 15;
+        const int32_t ti = (wr * im[j] + wi * re[j]) >> 15;
+        re[j] = (int16_t)(re[i] - tr);
+        im[j] = (int16_t)(im[i] - ti);
+        re[i] = (int16_t)(re[i] + tr);
+        im[i] = (int16_t)(im[i] + ti);
+      }
+    }
+  }
+  
+  return exponent;
+}
+
+void FixedFFT::magnitude(const int16_t* re, const int16_t* im, uint16_t* out, uint16_t n) {
+  for (uint16_t k = 0; k < n / 2; k++) {
+    uint32_t power = (uint32_t)((int32_t)re[k] * re[k]) + (uint32_t)((int32_t)im[k] * im[k]);
+    out[k] = isqrt(power);
+  }
+}
+
+uint16_t FixedFFT::isqrt(uint32_t value) {
+  uint32_t result = 0;
+  uint32_t bit = 1UL << 30;
+  
+  while (bit > value) {
+    bit >>= 2;
+  }
+  while (bit != 0) {
+    if (value >= result + bit) {
+      value -= result + bit;
+      result = (result >> 1) + bit;
+    } else {
+      result >>= 1;
+    }
+    bit >>= 2;
+  }
+  return (uint16_t)result;
+}
@@ -0,0 +1,48 @@
+#ifndef FIXED_FFT_H
+#define FIXED_FFT_H
+
+#include <stdint.h>
+
+/**
+ * In-place radix-2 FFT on int16 data for the ESP8266, which has no FPU.
+ *
+ * Twiddle factors come from a quarter-wave Q15 sine table in PROGMEM and every
+ * butterfly is 32-bit integer arithmetic. Overflow is handled with block floating
+ * point: the data is halved before a stage only when its peak could overflow, and
+ * the number of shifts is returned as an exponent so magnitudes can be rescaled.
+ *
+ * Only the sine table needs the Arduino core (PROGMEM), so tools/fft_benchmark.cpp builds the
+ * same code on the host.
+ */
+class FixedFFT {
+  public:
+    static const uint16_t MIN_SIZE = 16;
+    static const uint16_t MAX_SIZE = 1024;
+    
+    // True for powers of two between MIN_SIZE and MAX_SIZE
+    static bool isValidSize(uint16_t n);
+    
+    // Multiply by a periodic Hann window (coherent gain 0.5)
+    static void applyHannWindow(int16_t* data, uint16_t n);
+    
+    // Shift the input up to use the available headroom. Returns the (negative) exponent.
+    static int8_t normalize(int16_t* data, uint16_t n);
+    
+    // Forward transform. Output is X[k] * 2^-exponent for the returned exponent.
+    static int8_t transform(int16_t* re, int16_t* im, uint16_t n);
+    
+    // Magnitude of the first n/2 bins. out may alias re.
+    static void magnitude(const int16_t* re, const int16_t* im, uint16_t* out, uint16_t n);
+    
+    // Q15 sine/cosine of 2*pi*index/MAX_SIZE
+    static int16_t sinQ15(uint16_t index);
+    static int16_t cosQ15(uint16_t index);
+    
+    // Integer square root, rounded down
+    static uint16_t isqrt(uint32_t value);
+    
+  private:
+    static uint16_t peak(const int16_t* re, const int16_t* im, uint16_t n);
+};
+
+#endif
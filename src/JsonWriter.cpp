@@ -0,0 +1,241 @@
+#include "JsonWriter.h"
+#include <math.h>
+
+BufferPrint::BufferPrint(char* buffer, size_t size)
+  : buffer(buffer),
+    size(size) {
+  clear();
+}
+
+size_t BufferPrint::write(uint8_t c) {
+  return write(&c, 1);
+}
+
+size_t BufferPrint::write(const uint8_t* data, size_t length) {
+  size_t room = size - 1 - used;
+  if (length > room) {
+    overflow = true;
+    length = room;
+  }
+  memcpy(buffer + used, data, length);
+  used += length;
+  buffer[used] = '\0';
+  return length;
+}
+
+void BufferPrint::clear() {
+  used = 0;
+  overflow = false;
+  buffer[0] = '\0';
+}
+
+const char* BufferPrint::c_str() const {
+  return buffer;
+}
+
+size_t BufferPrint::length() const {
+  return used;
+}
+
+bool BufferPrint::overflowed() const {
+  return overflow;
+}
+
+JsonWriter::JsonWriter(Print& out)
+  : out(out) {
+}
+
+JsonWriter& JsonWriter::beginObject(const char* name) {
+  key(name);
+  out.write('{');
+  if (depth < MAX_DEPTH - 1) {
+    depth++;
+  }
+  hasMembers &= ~(1 << depth);
+  return *this;
+}
+
+JsonWriter& JsonWriter::endObject() {
+  out.write('}');
+  if (depth > 0) {
+    depth--;
+  }
+  return *this;
+}
+
+JsonWriter& JsonWriter::beginArray(const char* name) {
+  key(name);
+  out.write('[');
+  if (depth < MAX_DEPTH - 1) {
+    depth++;
+  }
+  hasMembers &= ~(1 << depth);
+  return *this;
+}
+
+JsonWriter& JsonWriter::endArray() {
+  out.write(']');
+  if (depth > 0) {
+    depth--;
+  }
+  return *this;
+}
+
+JsonWriter& JsonWriter::add(const char* name, bool value) {
+  key(name);
+  out.print(value ? F("true") : F("false"));
+  return *this;
+}
+
+JsonWriter& JsonWriter::add(const char* name, int value) {
+  key(name);
+  out.print(value);
+  return *this;
+}
+
+JsonWriter& JsonWriter::add(const char* name, unsigned int value) {
+  key(name);
+  out.print(value);
+  return *this;
+}
+
+JsonWriter& JsonWriter::add(const char* name, long value) {
+  key(name);
+  out.print(value);
+  return *this;
+}
+
+JsonWriter& JsonWriter::add(const char* name, unsigned long value) {
+  key(name);
+  out.print(value);
+  return *this;
+}
+
+JsonWriter& JsonWriter::add(const char* name, double value, uint8_t decimals) {
+  key(name);
+  number(value, decimals);
+  return *this;
+}
+
+JsonWriter& JsonWriter::add(const char* name, const char* value) {
+  key(name);
+  string(value);
+  return *this;
+}
+
+JsonWriter& JsonWriter::add(const char* name, const String& value) {
+  key(name);
+  string(value.c_str());
+  return *this;
+}
+
+JsonWriter& JsonWriter::add(const char* name, const __FlashStringHelper* value) {
+  key(name);
+  string(value);
+  return *this;
+}
+
+JsonWriter& JsonWriter::addNull(const char* name) {
+  key(name);
+  out.print(F("null"));
+  return *this;
+}
+
+JsonWriter& JsonWriter::value(bool value) {
+  return add(nullptr, value);
+}
+
+JsonWriter& JsonWriter::value(int value) {
+  return add(nullptr, value);
+}
+
+JsonWriter& JsonWriter::value(unsigned int value) {
+  return add(nullptr, value);
+}
+
+JsonWriter& JsonWriter::value(long value) {
+  return add(nullptr, value);
+}
+
+JsonWriter& JsonWriter::value(unsigned long value) {
+  return add(nullptr, value);
+}
+
+JsonWriter& JsonWriter::value(double value, uint8_t decimals) {
+  return add(nullptr, value, decimals);
+}
+
+JsonWriter& JsonWriter::value(const char* value) {
+  return add(nullptr, value);
+}
+
+JsonWriter& JsonWriter::valueNull() {
+  return addNull(nullptr);
+}
+
+Print& JsonWriter::addRaw(const char* name) {
+  key(name);
+  return out;
+}
+
+Print& JsonWriter::getOutput() {
+  return out;
+}
+
+void JsonWriter::separator() {
+  if (hasMembers & (1 << depth)) {
+    out.write(',');
+  }
+  hasMembers |= 1 << depth;
+}
+
+void JsonWriter::key(const char* name) {
+  separator();
+  if (name) {
+    string(name);
+    out.write(':');
+  }
+}
+
+void JsonWriter::number(double value, uint8_t decimals) {
+  if (isnan(value) || isinf(value)) {
+    out.print(F("null"));
+  } else {
+    out.print(value, decimals);
+  }
+}
+
+void JsonWriter::string(const char* value) {
+  if (!value) {
+    out.print(F("null"));
+    return;
+  }
+  out.write('"');
+  while (*value) {
+    character(*value++);
+  }
+  out.write('"');
+}
+
+void JsonWriter::string(const __FlashStringHelper* value) {
+  PGM_P p = reinterpret_cast<PGM_P>(value);
+  out.write('"');
+  for (char c = pgm_read_byte(p); c != '\0'; c = pgm_read_byte(++p)) {
+    character(c);
+  }
+  out.write('"');
+}
+
+void JsonWriter::character(char c) {
+  if (c == '"' || c == '\\') {
+    out.write('\\');
+    out.write(c);
+  } else if ((uint8_t)c < 0x20) {
+    static const char hex[] = "0123456789abcdef";
+    out.print(F("\\u00"));
+    out.write(hex[(c >> 4) & 0x0F]);
+    out.write(hex[c & 0x0F]);
+  } else {
+    out.write(c);
+  }
+}
@@ -0,0 +1,89 @@
+#ifndef JSON_WRITER_H
+#define JSON_WRITER_H
+
+#include <Arduino.h>
+
+// Fixed buffer that collects printed text, e.g. an SSE message built on the stack or in a
+// task member. Always NUL-terminated; text that does not fit is dropped and flagged.
+class BufferPrint : public Print {
+  public:
+    BufferPrint(char* buffer, size_t size);
+    
+    virtual size_t write(uint8_t c) override;
+    virtual size_t write(const uint8_t* data, size_t size) override;
+    using Print::write;
+    
+    void clear();
+    const char* c_str() const;
+    size_t length() const;
+    bool overflowed() const;
+  
+  private:
+    char* buffer;
+    size_t size;
+    size_t used = 0;
+    bool overflow = false;
+};
+
+// Streaming JSON writer. Values go straight to a Print (an AsyncResponseStream, a BufferPrint,
+// Serial) as they are added, so building a response needs no String concatenation and no heap.
+// The writer only tracks where commas go; callers are trusted to balance begin/end calls.
+//
+//   JsonWriter json(*response);
+//   json.beginObject().add("uptime", millis()).beginArray("bins");
+//   json.value(1).value(2).endArray().endObject();
+//
+// Non-finite floating point values are written as null.
+class JsonWriter {
+  public:
+    static const uint8_t MAX_DEPTH = 16;
+    
+    JsonWriter(Print& out);
+    
+    // Objects and arrays; the key is used when nested inside an object
+    JsonWriter& beginObject(const char* key = nullptr);
+    JsonWriter& endObject();
+    JsonWriter& beginArray(const char* key = nullptr);
+    JsonWriter& endArray();
+    
+    // Object members
+    JsonWriter& add(const char* key, bool value);
+    JsonWriter& add(const char* key, int value);
+    JsonWriter& add(const char* key, unsigned int value);
+    JsonWriter& add(const char* key, long value);
+    JsonWriter& add(const char* key, unsigned long value);
+    JsonWriter& add(const char* key, double value, uint8_t decimals = 2);
+    JsonWriter& add(const char* key, const char* value);
+    JsonWriter& add(const char* key, const String& value);
+    JsonWriter& add(const char* key, const __FlashStringHelper* value);
+    JsonWriter& addNull(const char* key);
+    
+    // Array elements
+    JsonWriter& value(bool value);
+    JsonWriter& value(int value);
+    JsonWriter& value(unsigned int value);
+    JsonWriter& value(long value);
+    JsonWriter& value(unsigned long value);
+    JsonWriter& value(double value, uint8_t decimals = 2);
+    JsonWriter& value(const char* value);
+    JsonWriter& valueNull();
+    
+    // Key of a member whose value the caller prints to getOutput() itself, e.g. JSON
+    // serialised by another library
+    Print& addRaw(const char* key);
+    Print& getOutput();
+  
+  private:
+    Print& out;
+    uint8_t depth = 0;
+    uint16_t hasMembers = 0;   // Bit per nesting level: a comma is due before the next item
+    
+    void separator();
+    void key(const char* key);
+    void number(double value, uint8_t decimals);
+    void string(const char* value);
+    void string(const __FlashStringHelper* value);
+    void character(char c);
+};
+
+#endif
@@ -3,11 +3,14 @@
 
 #include <Arduino.h>
 #include <FS.h>
+#include "constants.h"
 
 class MPULogRecord {
   public:
     static const uint8_t FLAG_RECORDING = 1;
     static const uint8_t FLAG_CALIBRATED = 2;
+    static const uint8_t FLAG_DEADBAND = 4;     // Written by deadband logging; the values held until the next record
+    static const uint8_t FLAG_BURST = 8;        // Unfiltered 1kHz sample from a RAM burst capture
   
     unsigned long timestamp = 0;     // Millis since boot (4 bytes)
     float accel_x = 0;            // X acceleration in G (4 bytes)
@@ -76,4 +79,113 @@ class MPULogRecord {
     }
 };
 
+// Optional header at the start of a raw log file, written when the recording does not use the
+// legacy MPULogRecord layout. With LOG_LAYOUT_RECORDS the records that follow are packed:
+// uint32_t timestamp, one float per channel set in channelMask (accel X/Y/Z in G, then
+// yaw/pitch/roll in deg/s), uint8_t flags and uint8_t padding, recordSize bytes in total.
+// With LOG_LAYOUT_COLUMNAR the file is a run of pages, each a uint16_t record count and a
+// reserved uint16_t followed by that many timestamps, then each selected channel's floats,
+// then the flags bytes.
+struct __attribute__((packed)) MPULogHeader {
+  uint32_t magic;           // LOG_HEADER_MAGIC (4 bytes)
+  uint8_t version;          // LOG_HEADER_VERSION (1 byte)
+  uint8_t channelMask;      // Bits 0-2 accel X/Y/Z, bits 3-5 gyro X/Y/Z (1 byte)
+  uint8_t recordSize;       // Bytes per packed record (1 byte)
+  uint8_t layout;           // LOG_LAYOUT_RECORDS or LOG_LAYOUT_COLUMNAR (1 byte)
+  
+  // Packed record size for a channel mask
+  static uint8_t recordSizeFor(uint8_t channelMask) {
+    uint8_t channels = 0;
+    for (uint8_t i = 0; i < 6; i++) {
+      if (channelMask & (1 << i)) {
+        channels++;
+      }
+    }
+    return sizeof(uint32_t) + channels * sizeof(float) + 2;
+  }
+  
+  // Records per columnar page; the page is transposed from packed records, so both must fit
+  static uint8_t columnarPageRecords(uint8_t recordSize) {
+    uint8_t columnar = (LOG_PAGE_SIZE - LOG_COLUMNAR_PAGE_HEADER) / (recordSize - 1);
+    uint8_t packed = LOG_PAGE_SIZE / recordSize;
+    return columnar < packed ? columnar : packed;
+  }
+};
+
+// Temperature side channel record, written at ~1Hz to a LOG_TEMPERATURE_SUFFIX sidecar
+// so the die temperature is available without adding bytes to every MPULogRecord.
+struct __attribute__((packed)) MPUTemperatureRecord {
+  uint32_t timestamp;       // Millis since boot, same clock as MPULogRecord (4 bytes)
+  int16_t centiCelsius;     // Die temperature in 0.01C (2 bytes)
+  uint16_t reserved;        // Padding to 8 bytes (2 bytes)
+};
+
+// Time index entry in a LOG_INDEX_SUFFIX sidecar, written for every LOG_INDEX_PAGE_INTERVAL
+// pages of a raw log. Entries are in file order, so they can be binary searched by timestamp.
+struct __attribute__((packed)) MPUIndexEntry {
+  uint32_t timestamp;       // First record timestamp in the page (4 bytes)
+  uint32_t offset;          // Byte offset of the page in the log file (4 bytes)
+};
+
+// Header of one frame in a LOG_SPECTRUM_SUFFIX sidecar. It is followed by three blocks of
+// binCount uint16_t amplitudes (X, Y, Z) in milli-G, bin k centred on k * sampleRateHz / frameSize.
+struct __attribute__((packed)) MPUSpectrumHeader {
+  uint32_t timestamp;       // Millis since boot at the start of the frame (4 bytes)
+  uint16_t sampleRateHz;    // Acquisition rate (2 bytes)
+  uint16_t frameSize;       // FFT length (2 bytes)
+  uint16_t binCount;        // frameSize / 2 (2 bytes)
+  uint8_t axisCount;        // Always 3 (1 byte)
+  uint8_t reserved;         // Padding to 12 bytes (1 byte)
+};
+
+// One channel of an MPUSummaryRecord. Peak-to-peak is maximum - minimum.
+struct __attribute__((packed)) MPUSummaryChannel {
+  int16_t minimum;          // Accel in mG, gyro in 0.1 deg/s (2 bytes)
+  int16_t maximum;          // (2 bytes)
+  int16_t mean;             // (2 bytes)
+  uint16_t rms;             // RMS including the mean, same units (2 bytes)
+};
+
+// Summary logging mode record, one per window in a LOG_SUMMARY_SUFFIX file instead of one
+// MPULogRecord per sample. Statistics cover every acquired sample, not just logged ones.
+struct __attribute__((packed)) MPUSummaryRecord {
+  static const uint16_t FLAG_PARTIAL = 1;   // Window cut short by the end of the recording
+  
+  uint32_t timestamp;       // Millis since boot at the start of the window (4 bytes)
+  uint16_t sampleCount;     // Samples in the window (2 bytes)
+  uint16_t flags;           // (2 bytes)
+  MPUSummaryChannel channels[6];  // Accel X/Y/Z, gyro X/Y/Z (48 bytes)
+  
+  // Total: 56 bytes per record
+};
+
+// Bucket of a min/max pyramid sidecar. Level L of a raw log holds one record per
+// PYRAMID_FACTOR^(L+1) logged samples, in the same units as MPUSummaryChannel.
+struct __attribute__((packed)) MPUPyramidRecord {
+  uint32_t timestamp;       // Millis since boot of the first sample in the bucket (4 bytes)
+  uint16_t sampleCount;     // Samples in the bucket, short only for the last one (2 bytes)
+  uint16_t reserved;        // (2 bytes)
+  int16_t minimum[6];       // Accel X/Y/Z in mG, gyro X/Y/Z in 0.1 deg/s (12 bytes)
+  int16_t maximum[6];       // (12 bytes)
+  
+  // Total: 32 bytes per record
+};
+
+// Histogram logging mode snapshot header, one per interval in a LOG_HISTOGRAM_SUFFIX file. It is
+// followed by channelCount * binCount uint32_t counts, channel-major: accel X/Y/Z, gyro X/Y/Z and
+// accel magnitude. Axis bins are centred on zero (bin k starts at (k - binCount / 2) * width);
+// magnitude bin k starts at k * accelBinMg. The outer bins also count out-of-range values.
+struct __attribute__((packed)) MPUHistogramHeader {
+  static const uint8_t FLAG_PARTIAL = 1;    // Interval cut short by the end of the recording
+  
+  uint32_t timestamp;       // Millis since boot at the start of the interval (4 bytes)
+  uint32_t durationMs;      // Interval length (4 bytes)
+  uint32_t sampleCount;     // Samples counted in the interval (4 bytes)
+  uint16_t binCount;        // Bins per channel (2 bytes)
+  uint8_t channelCount;     // Always 7 (1 byte)
+  uint8_t flags;            // (1 byte)
+  uint16_t accelBinMg;      // Accel and magnitude bin width in mG (2 bytes)
+  uint16_t gyroBinDeciDps;  // Gyro bin width in 0.1 deg/s (2 bytes)
+};
+
 #endif
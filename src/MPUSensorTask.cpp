@@ -1,7 +1,12 @@
 #include "MPUSensorTask.h"
+#include "DebugOutput.h"
 #include "DataLoggingTask.h"
 #include "BuzzerFeedbackTask.h"
+#include "RainflowTask.h"
+#include "SerialStreamTask.h"
+#include "UdpStreamTask.h"
 #include "Settings.h"
+#include <Wire.h>
 
 // Global settings instance
 extern Settings settings;
@@ -9,44 +14,84 @@ extern Settings settings;
 MPUSensorTask::MPUSensorTask(DataLoggingTask* dataLogger) 
   : dataLogger(dataLogger) {
   setName(F("MPUSensorTask"));
-  runInterval = 100;  // 10Hz = 100ms
+  runInterval = 100;  // Replaced by the acquisition interval in configureAcquisition()
+  updateFixedPointCalibration();
 }
 
 void MPUSensorTask::run() {
+  // Pick up acquisition or logging rate changes made through /api/settings
+  if (settings.acquisitionRateHz != configuredAcquisitionRateHz || settings.sampleRateMs != configuredSampleRateMs ||
+      settings.decimationOrder != configuredDecimationOrder || filterSettingsChanged()) {
+    configureAcquisition();
+  }
+  
   // Check for calibration completion
     if (isCalibrating) {
-    if (isCalibrationComplete()) {
+    if (isCalibrationComplete() && calibrationMode == CAL_MODE_SIXPOS) {
+      isCalibrating = false;
+      finishSixPositionCapture();
+    } else if (isCalibrationComplete() && calibrationMode == CAL_MODE_BOOT) {
+      isCalibrating = false;
+      finishBootCalibration();
+    } else if (isCalibrationComplete()) {
       calculateOffsets();
       applyOffsets();
       isCalibrating = false;
       isCalibrated = true;
       calibrationStatus = CALIBRATED;
+      updateFixedPointCalibration();
       
       // Save calibration to EEPROM
       saveCalibration();
+      recordTemperaturePoint(temperature_sum / calibrationSampleTarget / MPU6050_TEMP_LSB_PER_C + MPU6050_TEMP_OFFSET_C);
       
-      Serial.println(F("Calibration complete"));
+      debugOutput.println(F("Calibration complete"));
       
       // Play calibration complete tone
       if (buzzerTask) {
         buzzerTask->playCalibrationCompleteTone();
       }
     } else {
-      // Collect calibration sample and accumulate values
-      accumulateCalibrationSample();
-      fifoCount++;
+      // Collect calibration sample and accumulate values; a failed read is not counted, as the
+      // sums are divided by the sample target
+      if (accumulateCalibrationSample()) {
+        fifoCount++;
+      }
     }
     return;
   }
   
+  // A burst capture replaces normal acquisition until its arena is full
+  if (burst.getState() == BurstCapture::BURST_ARMED) {
+    startBurst();
+  }
+  if (burst.getState() == BurstCapture::BURST_CAPTURING) {
+    drainBurstFIFO();
+    return;
+  }
+  
   // Normal operation - read from FIFO
   readFIFO();
   
   // Update current sensor data for other tasks
   updateSensorData();
+  
+  if (bootCalibrationState == BOOT_CAL_WAITING) {
+    updateBootCalibration();
+  }
 }
 
 void MPUSensorTask::startCalibration() {
+  // A level calibration abandons any six-position session in progress
+  sixPosActive = false;
+  beginSampleAccumulation(CAL_MODE_LEVEL);
+  
+  debugOutput.println(F("Starting calibration..."));
+}
+
+void MPUSensorTask::beginSampleAccumulation(CalibrationMode mode, uint16_t samples) {
+  calibrationMode = mode;
+  calibrationSampleTarget = samples;
   isCalibrating = true;
   resetSensorData();
   fifoCount = 0;
@@ -58,94 +103,535 @@ void MPUSensorTask::startCalibration() {
   gyro_sum_x = 0;
   gyro_sum_y = 0;
   gyro_sum_z = 0;
+  temperature_sum = 0;
   
   // Reset FIFO to start fresh calibration
   // Note: Adafruit MPU6050 doesn't have resetFIFO method
   // We'll work with available methods
-  
-  Serial.println(F("Starting calibration..."));
 }
 
 bool MPUSensorTask::isCalibrationComplete() const {
-  return fifoCount >= CALIBRATION_SAMPLES;
+  return fifoCount >= calibrationSampleTarget;
 }
 
-void MPUSensorTask::accumulateCalibrationSample() {
-  sensors_event_t a, g, temp;
-  mpu.getEvent(&a, &g, &temp);
+bool MPUSensorTask::accumulateCalibrationSample() {
+  int16_t accel[3], gyro[3], temperature;
+  if (!readRawSample(accel, gyro, temperature)) {
+    return false;
+  }
   
-  // Accumulate raw sensor values for calibration
-  accel_sum_x += a.acceleration.x;
-  accel_sum_y += a.acceleration.y;
-  accel_sum_z += a.acceleration.z;
-  gyro_sum_x += g.gyro.x;
-  gyro_sum_y += g.gyro.y;
-  gyro_sum_z += g.gyro.z;
+  // Accumulate raw sensor counts for calibration
+  accel_sum_x += accel[0];
+  accel_sum_y += accel[1];
+  accel_sum_z += accel[2];
+  gyro_sum_x += gyro[0];
+  gyro_sum_y += gyro[1];
+  gyro_sum_z += gyro[2];
+  temperature_sum += temperature;
+  return true;
 }
 
 void MPUSensorTask::calculateOffsets() {
-  // Calculate average offsets from accumulated samples
+  // Calculate average offsets from accumulated samples, converted from counts to m/s^2 and rad/s
+  const float accelCountsToMs2 = SENSORS_GRAVITY_STANDARD / MPU6050_ACCEL_LSB_PER_G;
+  const float gyroCountsToRads = DEG_TO_RAD / MPU6050_GYRO_LSB_PER_DPS;
   
-  // For accelerometer: when the sensor is level, Z should read +9.81 m/s² (gravity)
-  // So we subtract the expected gravity from the Z axis average
-  accel_offset_x = accel_sum_x / CALIBRATION_SAMPLES;
-  accel_offset_y = accel_sum_y / CALIBRATION_SAMPLES;
-  accel_offset_z = (accel_sum_z / CALIBRATION_SAMPLES) - 9.81;  // Subtract gravity
+  // For accelerometer: when the sensor is level, Z should read +1G (gravity)
+  // So we subtract the expected gravity, as seen through the Z scale factor, from the Z axis average
+  accel_offset_x = (accel_sum_x / calibrationSampleTarget) * accelCountsToMs2;
+  accel_offset_y = (accel_sum_y / calibrationSampleTarget) * accelCountsToMs2;
+  accel_offset_z = (accel_sum_z / calibrationSampleTarget) * accelCountsToMs2 - accel_scale_z * SENSORS_GRAVITY_STANDARD;
   
   // For gyroscope: when stationary, all axes should read 0
-  gyro_offset_x = gyro_sum_x / CALIBRATION_SAMPLES;
-  gyro_offset_y = gyro_sum_y / CALIBRATION_SAMPLES;
-  gyro_offset_z = gyro_sum_z / CALIBRATION_SAMPLES;
+  gyro_offset_x = (gyro_sum_x / calibrationSampleTarget) * gyroCountsToRads;
+  gyro_offset_y = (gyro_sum_y / calibrationSampleTarget) * gyroCountsToRads;
+  gyro_offset_z = (gyro_sum_z / calibrationSampleTarget) * gyroCountsToRads;
   
-  Serial.print(F("Calculated offsets - Accel: "));
-  Serial.print(accel_offset_x); Serial.print(F(", "));
-  Serial.print(accel_offset_y); Serial.print(F(", "));
-  Serial.print(accel_offset_z);
-  Serial.print(F(" | Gyro: "));
-  Serial.print(gyro_offset_x); Serial.print(F(", "));
-  Serial.print(gyro_offset_y); Serial.print(F(", "));
-  Serial.println(gyro_offset_z);
+  debugOutput.print(F("Calculated offsets - Accel: "));
+  debugOutput.print(accel_offset_x); debugOutput.print(F(", "));
+  debugOutput.print(accel_offset_y); debugOutput.print(F(", "));
+  debugOutput.print(accel_offset_z);
+  debugOutput.print(F(" | Gyro: "));
+  debugOutput.print(gyro_offset_x); debugOutput.print(F(", "));
+  debugOutput.print(gyro_offset_y); debugOutput.print(F(", "));
+  debugOutput.println(gyro_offset_z);
 }
 
 void MPUSensorTask::applyOffsets() {
   // Calibration offsets are now applied in updateSensorData()
   // This method can be used for any hardware-level calibration if needed
-  Serial.println(F("Applied calibration offsets"));
+  debugOutput.println(F("Applied calibration offsets"));
+}
+
+void MPUSensorTask::startSixPositionCalibration() {
+  sixPosActive = true;
+  sixPosCapturedMask = 0;
+  sixPosGyroSum[0] = sixPosGyroSum[1] = sixPosGyroSum[2] = 0;
+  sixPosTemperatureSum = 0;
+  
+  debugOutput.println(F("Six-position calibration started - rest the sensor on each face and capture"));
+}
+
+bool MPUSensorTask::captureSixPosition() {
+  if (!sixPosActive || isCalibrating) {
+    return false;
+  }
+  
+  beginSampleAccumulation(CAL_MODE_SIXPOS);
+  debugOutput.println(F("Six-position: capturing orientation..."));
+  return true;
+}
+
+void MPUSensorTask::cancelSixPositionCalibration() {
+  if (isCalibrating && calibrationMode == CAL_MODE_SIXPOS) {
+    isCalibrating = false;
+  }
+  sixPosActive = false;
+  debugOutput.println(F("Six-position calibration cancelled"));
+}
+
+bool MPUSensorTask::isSixPositionActive() const {
+  return sixPosActive;
+}
+
+uint8_t MPUSensorTask::getSixPositionCapturedMask() const {
+  return sixPosCapturedMask;
+}
+
+void MPUSensorTask::finishSixPositionCapture() {
+  float mean[3] = {
+    accel_sum_x / CALIBRATION_SAMPLES,
+    accel_sum_y / CALIBRATION_SAMPLES,
+    accel_sum_z / CALIBRATION_SAMPLES
+  };
+  
+  // The axis carrying gravity identifies which face the sensor is resting on
+  uint8_t axis = 0;
+  for (uint8_t i = 1; i < 3; i++) {
+    if (fabs(mean[i]) > fabs(mean[axis])) {
+      axis = i;
+    }
+  }
+  
+  if (fabs(mean[axis]) < SIXPOS_MIN_AXIS_G * MPU6050_ACCEL_LSB_PER_G) {
+    debugOutput.at(LOG_LEVEL_WARN).println(F("Six-position: orientation not recognised, hold the sensor square and retry"));
+    return;
+  }
+  
+  uint8_t position = axis * 2 + (mean[axis] < 0 ? 1 : 0);
+  if (sixPosCapturedMask & (1 << position)) {
+    debugOutput.println(F("Six-position: orientation already captured, turn the sensor to a new face"));
+    return;
+  }
+  
+  for (uint8_t i = 0; i < 3; i++) {
+    sixPosAccelMean[position][i] = mean[i];
+  }
+  sixPosGyroSum[0] += gyro_sum_x / CALIBRATION_SAMPLES;
+  sixPosGyroSum[1] += gyro_sum_y / CALIBRATION_SAMPLES;
+  sixPosGyroSum[2] += gyro_sum_z / CALIBRATION_SAMPLES;
+  sixPosTemperatureSum += temperature_sum / CALIBRATION_SAMPLES;
+  sixPosCapturedMask |= (1 << position);
+  
+  debugOutput.print(F("Six-position: captured orientation "));
+  debugOutput.print(position);
+  debugOutput.print(F(", mask 0x"));
+  debugOutput.println(sixPosCapturedMask, HEX);
+  
+  if (sixPosCapturedMask != (1 << SIXPOS_POSITION_COUNT) - 1) {
+    if (buzzerTask) {
+      buzzerTask->playCalibrationCompleteTone();
+    }
+    return;
+  }
+  
+  sixPosActive = false;
+  if (solveSixPosition()) {
+    isCalibrated = true;
+    calibrationStatus = CALIBRATED;
+    hasSixPositionScale = true;
+    updateFixedPointCalibration();
+    saveCalibration();
+    recordTemperaturePoint(sixPosTemperatureSum / SIXPOS_POSITION_COUNT / MPU6050_TEMP_LSB_PER_C + MPU6050_TEMP_OFFSET_C);
+    
+    debugOutput.println(F("Six-position calibration complete"));
+    if (buzzerTask) {
+      buzzerTask->playCalibrationCompleteTone();
+    }
+  }
+}
+
+bool MPUSensorTask::solveSixPosition() {
+  // Per axis the model is measured = scale * true + offset, with true = +1G, -1G and
+  // four 0G readings across the six faces. Because the true values sum to zero the
+  // least-squares solution decouples: scale = (up - down) / 2G, offset = mean of all six.
+  float scale[3];
+  float offsetCounts[3];
+  
+  for (uint8_t axis = 0; axis < 3; axis++) {
+    float up = sixPosAccelMean[axis * 2][axis];
+    float down = sixPosAccelMean[axis * 2 + 1][axis];
+    scale[axis] = (up - down) / (2.0 * MPU6050_ACCEL_LSB_PER_G);
+    
+    float sum = 0;
+    for (uint8_t position = 0; position < SIXPOS_POSITION_COUNT; position++) {
+      sum += sixPosAccelMean[position][axis];
+    }
+    offsetCounts[axis] = sum / SIXPOS_POSITION_COUNT;
+    
+    if (fabs(scale[axis] - 1.0) > SIXPOS_MAX_SCALE_ERROR) {
+      debugOutput.print(F("Six-position: implausible scale on axis "));
+      debugOutput.print(axis);
+      debugOutput.print(F(": "));
+      debugOutput.println(scale[axis], 4);
+      return false;
+    }
+  }
+  
+  const float accelCountsToMs2 = SENSORS_GRAVITY_STANDARD / MPU6050_ACCEL_LSB_PER_G;
+  const float gyroCountsToRads = DEG_TO_RAD / MPU6050_GYRO_LSB_PER_DPS;
+  
+  accel_offset_x = offsetCounts[0] * accelCountsToMs2;
+  accel_offset_y = offsetCounts[1] * accelCountsToMs2;
+  accel_offset_z = offsetCounts[2] * accelCountsToMs2;
+  accel_scale_x = scale[0];
+  accel_scale_y = scale[1];
+  accel_scale_z = scale[2];
+  
+  // The sensor was stationary for every capture, so the gyro bias is the mean over all faces
+  gyro_offset_x = (sixPosGyroSum[0] / SIXPOS_POSITION_COUNT) * gyroCountsToRads;
+  gyro_offset_y = (sixPosGyroSum[1] / SIXPOS_POSITION_COUNT) * gyroCountsToRads;
+  gyro_offset_z = (sixPosGyroSum[2] / SIXPOS_POSITION_COUNT) * gyroCountsToRads;
+  
+  debugOutput.print(F("Six-position scales: "));
+  debugOutput.print(accel_scale_x, 4); debugOutput.print(F(", "));
+  debugOutput.print(accel_scale_y, 4); debugOutput.print(F(", "));
+  debugOutput.println(accel_scale_z, 4);
+  return true;
+}
+
+void MPUSensorTask::updateFixedPointCalibration() {
+  const float accelOffsets[3] = { accel_offset_x, accel_offset_y, accel_offset_z };
+  const float accelScales[3] = { accel_scale_x, accel_scale_y, accel_scale_z };
+  const float gyroOffsets[3] = { gyro_offset_x, gyro_offset_y, gyro_offset_z };
+  
+  for (uint8_t i = 0; i < 3; i++) {
+    float scale = (isCalibrated && accelScales[i] > 0) ? accelScales[i] : 1.0;
+    float accelOffsetCounts = isCalibrated ? accelOffsets[i] / SENSORS_GRAVITY_STANDARD * MPU6050_ACCEL_LSB_PER_G : 0;
+    float gyroOffsetCounts = isCalibrated ? gyroOffsets[i] * RAD_TO_DEG * MPU6050_GYRO_LSB_PER_DPS : 0;
+    
+    accelOffsetQ4[i] = lroundf(accelOffsetCounts * 16);
+    accelGainQ16[i] = lroundf(65536.0 * ACCEL_FIXED_PER_G / (MPU6050_ACCEL_LSB_PER_G * scale));
+    gyroOffsetQ4[i] = lroundf(gyroOffsetCounts * 16);
+  }
+  gyroGainQ16 = lroundf(65536.0 * GYRO_FIXED_PER_DPS / MPU6050_GYRO_LSB_PER_DPS);
+  
+  // Restart bias tracking and drift measurement from the new offsets
+  for (uint8_t i = 0; i < 3; i++) {
+    gyroBiasQ12[i] = gyroOffsetQ4[i] << 8;
+    driftWindowStartBias[i] = gyroOffsets[i] * RAD_TO_DEG;
+    persistedGyroBias[i] = driftWindowStartBias[i];
+  }
+  driftWindowStart = millis();
+}
+
+const TemperatureModel& MPUSensorTask::getTemperatureModel() const {
+  return temperatureModel;
+}
+
+bool MPUSensorTask::isTemperatureCompensationActive() const {
+  return settings.temperatureCompensation && isCalibrated && temperatureModel.isFitted();
+}
+
+void MPUSensorTask::clearTemperatureModel() {
+  temperatureModel.clear();
+  settings.saveTemperatureCompToEEPROM(temperatureModel.getData());
+  updateTemperatureCompensation();
+}
+
+void MPUSensorTask::updateTemperatureCompensation() {
+  if (temperatureRawCount > 0) {
+    temperature = (float)temperatureRawSum / temperatureRawCount / MPU6050_TEMP_LSB_PER_C + MPU6050_TEMP_OFFSET_C;
+  }
+  temperatureRawSum = 0;
+  temperatureRawCount = 0;
+  lastTemperatureUpdate = millis();
+  
+  // Offset change since the calibration was taken, converted from m/s^2 and rad/s to counts
+  bool active = isTemperatureCompensationActive();
+  for (uint8_t i = 0; i < 3; i++) {
+    float accelCorrection = active ? temperatureModel.correction(i, temperature) : 0;
+    float gyroCorrection = active ? temperatureModel.correction(3 + i, temperature) : 0;
+    accelTempQ4[i] = lroundf(accelCorrection / SENSORS_GRAVITY_STANDARD * MPU6050_ACCEL_LSB_PER_G * 16);
+    gyroTempQ4[i] = lroundf(gyroCorrection * RAD_TO_DEG * MPU6050_GYRO_LSB_PER_DPS * 16);
+  }
+  
+  if (dataLogger) {
+    dataLogger->logTemperature(temperature);
+  }
+}
+
+void MPUSensorTask::recordTemperaturePoint(float calibrationTemperature) {
+  const float bias[TEMPCOMP_CHANNELS] = {
+    accel_offset_x, accel_offset_y, accel_offset_z,
+    gyro_offset_x, gyro_offset_y, gyro_offset_z
+  };
+  
+  temperatureModel.addPoint(calibrationTemperature, bias);
+  temperatureModel.setCalibrationTemperature(calibrationTemperature);
+  settings.saveTemperatureCompToEEPROM(temperatureModel.getData());
+  
+  // The new offsets are exact at this temperature, so restart from zero correction
+  temperature = calibrationTemperature;
+  temperatureRawSum = 0;
+  temperatureRawCount = 0;
+  updateTemperatureCompensation();
+  
+  debugOutput.print(F("Temperature point recorded at "));
+  debugOutput.print(calibrationTemperature, 2);
+  debugOutput.print(F("C, model order "));
+  debugOutput.println(temperatureModel.getOrder());
+}
+
+void MPUSensorTask::startBootCalibration() {
+  // Sample quickly while waiting so stillness is detected and the calibration finishes sooner
+  normalRunInterval = runInterval;
+  if (runInterval > BOOT_CALIBRATION_INTERVAL_MS) {
+    runInterval = BOOT_CALIBRATION_INTERVAL_MS;
+  }
+  stillnessDetector.reset();
+  bootCalibrationStart = millis();
+  bootCalibrationState = BOOT_CAL_WAITING;
+  
+  debugOutput.println(F("Auto calibration: waiting for the sensor to be still"));
+}
+
+void MPUSensorTask::updateBootCalibration() {
+  if (stillnessDetector.isStill()) {
+    bootCalibrationState = BOOT_CAL_RUNNING;
+    beginSampleAccumulation(CAL_MODE_BOOT, BOOT_CALIBRATION_SAMPLES);
+    return;
+  }
+  
+  if (millis() - bootCalibrationStart >= BOOT_CALIBRATION_TIMEOUT_MS) {
+    runInterval = normalRunInterval;
+    bootCalibrationState = BOOT_CAL_TIMEOUT;
+    readyTimeMs = millis();
+    debugOutput.println(F("Auto calibration: sensor never still, keeping saved calibration"));
+  }
+}
+
+void MPUSensorTask::finishBootCalibration() {
+  runInterval = normalRunInterval;
+  
+  const float accelCountsToMs2 = SENSORS_GRAVITY_STANDARD / MPU6050_ACCEL_LSB_PER_G;
+  const float gyroCountsToRads = DEG_TO_RAD / MPU6050_GYRO_LSB_PER_DPS;
+  const float samples = calibrationSampleTarget;
+  
+  // Stillness guarantees the gyro reads pure bias. The accelerometer only yields offsets when
+  // resting Z-up, so with a saved calibration the accel offsets are kept as they are.
+  float newGyro[3] = { gyro_sum_x / samples * gyroCountsToRads,
+                       gyro_sum_y / samples * gyroCountsToRads,
+                       gyro_sum_z / samples * gyroCountsToRads };
+  const float levelTolerance = BOOT_CALIBRATION_LEVEL_TOLERANCE_G * MPU6050_ACCEL_LSB_PER_G;
+  bool level = fabs(accel_sum_x / samples) < levelTolerance && fabs(accel_sum_y / samples) < levelTolerance &&
+               accel_sum_z > 0;
+  
+  // With no saved calibration the accel offsets can only come from a Z-up rest. Saving the
+  // gyro alone would store default accel offsets as a valid calibration, so nothing is kept
+  // and the device stays uncalibrated.
+  if (!isCalibrated && !level) {
+    bootCalibrationState = BOOT_CAL_NOT_LEVEL;
+    debugOutput.at(LOG_LEVEL_WARN).println(F("Auto calibration: no saved calibration and not level, nothing saved"));
+  } else {
+    applyBootCalibration(newGyro);
+  }
+  
+  readyTimeMs = millis();
+  debugOutput.print(F("Ready to record after "));
+  debugOutput.print(readyTimeMs);
+  debugOutput.println(F(" ms"));
+  
+  if (buzzerTask) {
+    buzzerTask->playCalibrationCompleteTone();
+  }
+}
+
+// Takes the boot gyro bias, and the accel offsets too if there were none; only called
+// with a saved calibration or a Z-up rest
+void MPUSensorTask::applyBootCalibration(const float newGyro[3]) {
+  bool moved = !isCalibrated;
+  const float oldGyro[3] = { gyro_offset_x, gyro_offset_y, gyro_offset_z };
+  for (uint8_t i = 0; i < 3; i++) {
+    if (fabs(newGyro[i] - oldGyro[i]) * RAD_TO_DEG > BOOT_CALIBRATION_GYRO_THRESHOLD_DPS) {
+      moved = true;
+    }
+  }
+  
+  if (!isCalibrated) {
+    calculateOffsets();
+  }
+  gyro_offset_x = newGyro[0];
+  gyro_offset_y = newGyro[1];
+  gyro_offset_z = newGyro[2];
+  isCalibrated = true;
+  updateFixedPointCalibration();
+  
+  if (moved) {
+    saveCalibration();
+    calibrationStatus = CALIBRATED;
+    bootCalibrationState = BOOT_CAL_SAVED;
+    debugOutput.println(F("Auto calibration: offsets moved, saved to EEPROM"));
+  } else {
+    bootCalibrationState = BOOT_CAL_UNCHANGED;
+    debugOutput.println(F("Auto calibration: offsets within threshold, EEPROM unchanged"));
+  }
+}
+
+bool MPUSensorTask::isReady() const {
+  return bootCalibrationState != BOOT_CAL_WAITING && bootCalibrationState != BOOT_CAL_RUNNING;
+}
+
+unsigned long MPUSensorTask::getReadyTimeMs() const {
+  return readyTimeMs;
+}
+
+const __FlashStringHelper* MPUSensorTask::getBootCalibrationResult() const {
+  switch (bootCalibrationState) {
+    case BOOT_CAL_WAITING:
+      return F("waiting");
+    case BOOT_CAL_RUNNING:
+      return F("running");
+    case BOOT_CAL_SAVED:
+      return F("saved");
+    case BOOT_CAL_UNCHANGED:
+      return F("unchanged");
+    case BOOT_CAL_TIMEOUT:
+      return F("timeout");
+    case BOOT_CAL_NOT_LEVEL:
+      return F("notLevel");
+    default:
+      return F("disabled");
+  }
+}
+
+bool MPUSensorTask::isStationary() const {
+  return stillnessDetector.isStill();
+}
+
+void MPUSensorTask::trackGyroBias(const int16_t rawGyro[3]) {
+  // While stationary the raw gyro reading is pure bias plus noise, so the offset
+  // follows it through a slow exponential filter. Q12 keeps the small steps from truncating.
+  // The temperature correction is removed first so the tracked bias stays at calibration temperature.
+  for (uint8_t i = 0; i < 3; i++) {
+    int32_t compensatedQ12 = ((int32_t)rawGyro[i] << 12) - (gyroTempQ4[i] << 8);
+    gyroBiasQ12[i] += (compensatedQ12 - gyroBiasQ12[i]) >> GYRO_BIAS_TRACK_SHIFT;
+    gyroOffsetQ4[i] = gyroBiasQ12[i] >> 8;
+  }
+  
+  const float countsQ12ToRads = DEG_TO_RAD / (MPU6050_GYRO_LSB_PER_DPS * 4096.0);
+  gyro_offset_x = gyroBiasQ12[0] * countsQ12ToRads;
+  gyro_offset_y = gyroBiasQ12[1] * countsQ12ToRads;
+  gyro_offset_z = gyroBiasQ12[2] * countsQ12ToRads;
+}
+
+void MPUSensorTask::updateGyroDrift() {
+  unsigned long elapsed = millis() - driftWindowStart;
+  if (elapsed < GYRO_DRIFT_WINDOW_MS) {
+    return;
+  }
+  
+  const float bias[3] = { gyro_offset_x * (float)RAD_TO_DEG, gyro_offset_y * (float)RAD_TO_DEG, gyro_offset_z * (float)RAD_TO_DEG };
+  const float perMinute = 60000.0 / elapsed;
+  gyro_drift_x = (bias[0] - driftWindowStartBias[0]) * perMinute;
+  gyro_drift_y = (bias[1] - driftWindowStartBias[1]) * perMinute;
+  gyro_drift_z = (bias[2] - driftWindowStartBias[2]) * perMinute;
+  
+  bool biasMoved = false;
+  for (uint8_t i = 0; i < 3; i++) {
+    driftWindowStartBias[i] = bias[i];
+    if (fabs(bias[i] - persistedGyroBias[i]) > GYRO_BIAS_PERSIST_THRESHOLD_DPS) {
+      biasMoved = true;
+    }
+  }
+  driftWindowStart = millis();
+  
+  // Optionally persist the tracked bias. EEPROM commits stall the CPU, so never while recording.
+  bool recording = dataLogger && dataLogger->isRecording();
+  if (settings.gyroBiasPersist && biasMoved && !recording &&
+      millis() - lastBiasPersist >= GYRO_BIAS_PERSIST_INTERVAL_MS) {
+    if (saveCalibration()) {
+      for (uint8_t i = 0; i < 3; i++) {
+        persistedGyroBias[i] = bias[i];
+      }
+    }
+    lastBiasPersist = millis();
+  }
 }
 
 bool MPUSensorTask::loadSavedCalibration() {
-  if (settings.isCalibrationDataAvailable()) {
-    settings.getCalibrationData(accel_offset_x, accel_offset_y, accel_offset_z,
-                                gyro_offset_x, gyro_offset_y, gyro_offset_z);
+  CalibrationData calData;
+  if (settings.getCalibrationData(calData)) {
+    accel_offset_x = calData.accelOffsetX;
+    accel_offset_y = calData.accelOffsetY;
+    accel_offset_z = calData.accelOffsetZ;
+    gyro_offset_x = calData.gyroOffsetX;
+    gyro_offset_y = calData.gyroOffsetY;
+    gyro_offset_z = calData.gyroOffsetZ;
+    accel_scale_x = calData.accelScaleX;
+    accel_scale_y = calData.accelScaleY;
+    accel_scale_z = calData.accelScaleZ;
+    hasSixPositionScale = calData.flags & EEPROM_CAL_FLAG_SIXPOS;
     
     isCalibrated = true;
     calibrationStatus = USING_SAVED;
+    updateFixedPointCalibration();
+    
+    TemperatureCompData tempData;
+    if (settings.loadTemperatureCompFromEEPROM(tempData)) {
+      temperatureModel.load(tempData);
+    }
     
-    Serial.println(F("Loaded saved calibration from EEPROM"));
-    Serial.print(F("Loaded offsets - Accel: "));
-    Serial.print(accel_offset_x); Serial.print(F(", "));
-    Serial.print(accel_offset_y); Serial.print(F(", "));
-    Serial.print(accel_offset_z);
-    Serial.print(F(" | Gyro: "));
-    Serial.print(gyro_offset_x); Serial.print(F(", "));
-    Serial.print(gyro_offset_y); Serial.print(F(", "));
-    Serial.println(gyro_offset_z);
+    debugOutput.println(F("Loaded saved calibration from EEPROM"));
+    debugOutput.print(F("Loaded offsets - Accel: "));
+    debugOutput.print(accel_offset_x); debugOutput.print(F(", "));
+    debugOutput.print(accel_offset_y); debugOutput.print(F(", "));
+    debugOutput.print(accel_offset_z);
+    debugOutput.print(F(" | Gyro: "));
+    debugOutput.print(gyro_offset_x); debugOutput.print(F(", "));
+    debugOutput.print(gyro_offset_y); debugOutput.print(F(", "));
+    debugOutput.println(gyro_offset_z);
+    debugOutput.print(F("Loaded scales - Accel: "));
+    debugOutput.print(accel_scale_x, 4); debugOutput.print(F(", "));
+    debugOutput.print(accel_scale_y, 4); debugOutput.print(F(", "));
+    debugOutput.println(accel_scale_z, 4);
     
     return true;
   }
   
-  Serial.println(F("No saved calibration found in EEPROM"));
+  debugOutput.println(F("No saved calibration found in EEPROM"));
   return false;
 }
 
 bool MPUSensorTask::saveCalibration() {
-  if (settings.saveCalibrationToEEPROM(accel_offset_x, accel_offset_y, accel_offset_z,
-                                       gyro_offset_x, gyro_offset_y, gyro_offset_z)) {
-    Serial.println(F("Calibration saved to EEPROM"));
+  CalibrationData calData = CalibrationData();
+  calData.flags = hasSixPositionScale ? EEPROM_CAL_FLAG_SIXPOS : 0;
+  calData.accelOffsetX = accel_offset_x;
+  calData.accelOffsetY = accel_offset_y;
+  calData.accelOffsetZ = accel_offset_z;
+  calData.gyroOffsetX = gyro_offset_x;
+  calData.gyroOffsetY = gyro_offset_y;
+  calData.gyroOffsetZ = gyro_offset_z;
+  calData.accelScaleX = accel_scale_x;
+  calData.accelScaleY = accel_scale_y;
+  calData.accelScaleZ = accel_scale_z;
+  
+  if (settings.saveCalibrationToEEPROM(calData)) {
+    debugOutput.println(F("Calibration saved to EEPROM"));
     return true;
   }
   
-  Serial.println(F("Failed to save calibration to EEPROM"));
+  debugOutput.at(LOG_LEVEL_ERROR).println(F("Failed to save calibration to EEPROM"));
   return false;
 }
 
@@ -154,34 +640,93 @@ CalibrationStatus MPUSensorTask::getCalibrationStatus() const {
 }
 
 void MPUSensorTask::updateSensorData() {
-  sensors_event_t a, g, temp;
-  mpu.getEvent(&a, &g, &temp);
-  
-  // Apply calibration offsets if calibrated
-  if (isCalibrated) {
-    accel_x = (a.acceleration.x - accel_offset_x) / 9.81;
-    accel_y = (a.acceleration.y - accel_offset_y) / 9.81;
-    accel_z = (a.acceleration.z - accel_offset_z) / 9.81;
-    
-    // Convert gyro to degrees and apply offsets
-    yaw = (g.gyro.x - gyro_offset_x) * 57.2958;
-    pitch = (g.gyro.y - gyro_offset_y) * 57.2958;
-    roll = (g.gyro.z - gyro_offset_z) * 57.2958;
-  } else {
-    accel_x = a.acceleration.x / 9.81;
-    accel_y = a.acceleration.y / 9.81;
-    accel_z = a.acceleration.z / 9.81;
-    
-    // Convert gyro to degrees
-    yaw = g.gyro.x * 57.2958;
-    pitch = g.gyro.y * 57.2958;
-    roll = g.gyro.z * 57.2958;
+  int16_t rawAccel[3], rawGyro[3], rawTemperature;
+  if (!readRawSample(rawAccel, rawGyro, rawTemperature)) {
+    return;
   }
   
+  int32_t fixedAccel[3];
+  int32_t fixedGyro[3];
+  calibrateRawSample(rawAccel, rawGyro, fixedAccel, fixedGyro);
+  
+  // Temperature moves slowly, so corrections are refreshed from an average at 1Hz
+  temperatureRawSum += rawTemperature;
+  temperatureRawCount++;
+  if (millis() - lastTemperatureUpdate >= TEMPCOMP_UPDATE_MS) {
+    updateTemperatureCompensation();
+  }
+  
+  // Follow slow gyro bias changes whenever the sensor is at rest
+  if (stillnessDetector.update(fixedAccel, fixedGyro, isCalibrated) && isCalibrated && settings.gyroBiasTracking) {
+    trackGyroBias(rawGyro);
+  }
+  updateGyroDrift();
+  
+  // Filter chain then decimation to the logging rate. Stillness detection above sees the
+  // unfiltered samples, since a high-pass section would hide gravity from it.
+  int32_t channels[Decimator::CHANNELS] = { fixedAccel[0], fixedAccel[1], fixedAccel[2],
+                                            fixedGyro[0], fixedGyro[1], fixedGyro[2] };
+  int32_t decimated[Decimator::CHANNELS];
+  unsigned long filterStart = micros();
+  filterChain.process(channels);
+  bool outputReady = decimator.push(channels, decimated);
+  filterMicrosTotal += micros() - filterStart;
+  if (++filterTimedSamples >= DECIMATION_TIMING_SAMPLES) {
+    filterMicrosPerSample = (float)filterMicrosTotal / filterTimedSamples;
+    filterMicrosTotal = 0;
+    filterTimedSamples = 0;
+  }
+  
+  // Publish the full-rate sample for consumers that need more than the logging rate
+  fullRateSample.timestamp = millis();
+  for (uint8_t i = 0; i < 3; i++) {
+    fullRateSample.accel[i] = channels[i];
+    fullRateSample.gyro[i] = channels[3 + i];
+  }
+  fullRateSampleCount++;
+  if (dataLogger) {
+    dataLogger->logFullRateSample(fullRateSample);
+  }
+  if (rainflowTask) {
+    rainflowTask->addSample(fullRateSample);
+  }
+  
+  // Everything below runs once per logged sample
+  if (!outputReady) {
+    return;
+  }
+  
+  accel_x = decimated[0] * (1.0f / ACCEL_FIXED_PER_G);
+  accel_y = decimated[1] * (1.0f / ACCEL_FIXED_PER_G);
+  accel_z = decimated[2] * (1.0f / ACCEL_FIXED_PER_G);
+  
+  // Gyro rates in degrees/sec
+  yaw = decimated[3] * (1.0f / GYRO_FIXED_PER_DPS);
+  pitch = decimated[4] * (1.0f / GYRO_FIXED_PER_DPS);
+  roll = decimated[5] * (1.0f / GYRO_FIXED_PER_DPS);
+  
   // Always pass sensor data to data logger - DataLoggingTask will decide whether to log
   if (dataLogger) {
     dataLogger->logSensorData(accel_x, accel_y, accel_z, yaw, pitch, roll);
   }
+  if (serialStreamTask) {
+    serialStreamTask->addSample(accel_x, accel_y, accel_z, yaw, pitch, roll);
+  }
+  if (udpStreamTask) {
+    udpStreamTask->addSample(accel_x, accel_y, accel_z, yaw, pitch, roll);
+  }
+}
+
+void MPUSensorTask::calibrateRawSample(const int16_t rawAccel[3], const int16_t rawGyro[3],
+                                       int32_t fixedAccel[3], int32_t fixedGyro[3]) const {
+  // Apply the calibration model in integer arithmetic: (counts - offset) * gain.
+  // Offsets are Q4 counts and gains Q16, so the product is shifted down by 20 bits.
+  for (uint8_t i = 0; i < 3; i++) {
+    int32_t accelCountsQ4 = ((int32_t)rawAccel[i] << 4) - accelOffsetQ4[i] - accelTempQ4[i];
+    int32_t gyroCountsQ4 = ((int32_t)rawGyro[i] << 4) - gyroOffsetQ4[i] - gyroTempQ4[i];
+    fixedAccel[i] = (int32_t)(((int64_t)accelCountsQ4 * accelGainQ16[i]) >> 20);
+    fixedGyro[i] = (int32_t)(((int64_t)gyroCountsQ4 * gyroGainQ16) >> 20);
+  }
 }
 
 void MPUSensorTask::resetSensorData() {
@@ -193,9 +738,36 @@ void MPUSensorTask::resetSensorData() {
   roll = 0;
 }
 
+// Burst read of the accel, temperature and gyro output registers (big-endian int16 pairs)
+bool MPUSensorTask::readRawSample(int16_t accel[3], int16_t gyro[3], int16_t& temperature) {
+  uint8_t buffer[MPU6050_RAW_SAMPLE_BYTES];
+  
+  Wire.beginTransmission(MPU6050_ADDR);
+  Wire.write(MPU6050_REG_ACCEL_XOUT_H);
+  if (Wire.endTransmission(false) != 0) {
+    return false;
+  }
+  
+  if (Wire.requestFrom((uint8_t)MPU6050_ADDR, (size_t)MPU6050_RAW_SAMPLE_BYTES) != MPU6050_RAW_SAMPLE_BYTES) {
+    return false;
+  }
+  for (uint8_t i = 0; i < MPU6050_RAW_SAMPLE_BYTES; i++) {
+    buffer[i] = Wire.read();
+  }
+  
+  accel[0] = (int16_t)((buffer[0] << 8) | buffer[1]);
+  accel[1] = (int16_t)((buffer[2] << 8) | buffer[3]);
+  accel[2] = (int16_t)((buffer[4] << 8) | buffer[5]);
+  temperature = (int16_t)((buffer[6] << 8) | buffer[7]);
+  gyro[0] = (int16_t)((buffer[8] << 8) | buffer[9]);
+  gyro[1] = (int16_t)((buffer[10] << 8) | buffer[11]);
+  gyro[2] = (int16_t)((buffer[12] << 8) | buffer[13]);
+  return true;
+}
+
 bool MPUSensorTask::initFIFO() {
   if (!mpu.begin()) {
-    Serial.println(F("Failed to find MPU6050 chip"));
+    debugOutput.at(LOG_LEVEL_ERROR).println(F("Failed to find MPU6050 chip"));
     return false;
   }
   
@@ -206,11 +778,19 @@ bool MPUSensorTask::initFIFO() {
   
   // Try to load saved calibration on initialization
   loadSavedCalibration();
+  configureAcquisition();
+  
+  // Optionally refresh it once the sensor is still; otherwise ready immediately
+  if (settings.autoCalibration) {
+    startBootCalibration();
+  } else {
+    readyTimeMs = millis();
+  }
   
   // Note: Adafruit MPU6050 library has limited FIFO support
   // We'll use direct sensor reading instead
   
-  Serial.println(F("MPU6050 initialized"));
+  debugOutput.println(F("MPU6050 initialized"));
   return true;
 }
 
@@ -228,6 +808,121 @@ void MPUSensorTask::flushFIFO() {
   // No action needed for now
 }
 
+void MPUSensorTask::configureAcquisition() {
+  uint16_t rateHz = constrain(settings.acquisitionRateHz, (uint16_t)ACQUISITION_MIN_RATE_HZ, (uint16_t)ACQUISITION_MAX_RATE_HZ);
+  acquisitionIntervalMs = 1000 / rateHz;
+  
+  // One logged sample per sampleRateMs, rounded to a whole number of acquisitions
+  uint16_t ratio = (settings.sampleRateMs + acquisitionIntervalMs / 2) / acquisitionIntervalMs;
+  decimator.configure(settings.decimationOrder, ratio);
+  
+  // Biquad coefficients depend on the acquisition rate, so they are designed here too
+  memcpy(configuredFilters, settings.filters, sizeof(configuredFilters));
+  configuredFilterCount = settings.filterCount;
+  filterChain.configure(configuredFilters, configuredFilterCount, getAcquisitionRateHz());
+  for (uint8_t i = 0; i < configuredFilterCount; i++) {
+    if (filterChain.getRejectedSections() & (1 << i)) {
+      Print& log = debugOutput.at(LOG_LEVEL_WARN);
+      log.print(F("Filter section "));
+      log.print(i);
+      log.println(F(" rejected: frequency must be between 0 and half the acquisition rate"));
+    }
+  }
+  
+  configuredAcquisitionRateHz = settings.acquisitionRateHz;
+  configuredSampleRateMs = settings.sampleRateMs;
+  configuredDecimationOrder = settings.decimationOrder;
+  filterMicrosTotal = 0;
+  filterTimedSamples = 0;
+  
+  // The task runner starts a task once strictly more than runInterval ms have passed
+  normalRunInterval = acquisitionIntervalMs - 1;
+  if (isReady()) {
+    runInterval = normalRunInterval;
+  }
+  
+  debugOutput.print(F("Acquisition: "));
+  debugOutput.print(getAcquisitionRateHz());
+  debugOutput.print(F("Hz, CIC order "));
+  debugOutput.print(decimator.getOrder());
+  debugOutput.print(F(" decimating by "));
+  debugOutput.print(decimator.getRatio());
+  debugOutput.print(F(", "));
+  debugOutput.print(filterChain.getActiveSections());
+  debugOutput.println(F(" filter sections"));
+}
+
+bool MPUSensorTask::filterSettingsChanged() const {
+  return settings.filterCount != configuredFilterCount ||
+         memcmp(settings.filters, configuredFilters, sizeof(configuredFilters)) != 0;
+}
+
+uint16_t MPUSensorTask::getAcquisitionRateHz() const {
+  return 1000 / acquisitionIntervalMs;
+}
+
+uint16_t MPUSensorTask::getDecimationRatio() const {
+  return decimator.getRatio();
+}
+
+uint8_t MPUSensorTask::getDecimationOrder() const {
+  return decimator.getOrder();
+}
+
+float MPUSensorTask::getFilterMicrosPerSample() const {
+  return filterMicrosPerSample;
+}
+
+const BiquadFilter& MPUSensorTask::getFilterChain() const {
+  return filterChain;
+}
+
+void MPUSensorTask::writeFiltersJSON(JsonWriter& json, bool measure) {
+  static const float ratios[] = { 0.25f, 0.5f, 1.0f, 2.0f, 4.0f };
+  const float nyquist = getAcquisitionRateHz() / 2.0f;
+  
+  json.add("sampleRate", getAcquisitionRateHz());
+  json.add("filterMicrosPerSample", filterMicrosPerSample, 2);
+  json.beginArray("sections");
+  for (uint8_t s = 0; s < filterChain.getActiveSections(); s++) {
+    const FilterSectionConfig& config = filterChain.getSectionConfig(s);
+    json.beginObject();
+    json.add("type", BiquadFilter::typeName(config.type));
+    json.add("frequencyHz", config.frequencyHz, 3);
+    json.add("q", config.q, 3);
+    json.add("channels", config.channelMask);
+    json.beginArray("response");
+    for (uint8_t r = 0; r < sizeof(ratios) / sizeof(ratios[0]); r++) {
+      float frequency = config.frequencyHz * ratios[r];
+      if (frequency >= nyquist) {
+        continue;
+      }
+      json.beginObject();
+      json.add("hz", frequency, 3);
+      json.add("design", filterChain.designResponse(s, frequency), 5);
+      if (measure) {
+        json.add("measured", filterChain.measuredResponse(s, frequency), 5);
+      }
+      json.endObject();
+    }
+    json.endArray();
+    json.endObject();
+  }
+  json.endArray();
+}
+
+const SensorSample& MPUSensorTask::getFullRateSample() const {
+  return fullRateSample;
+}
+
+uint32_t MPUSensorTask::getFullRateSampleCount() const {
+  return fullRateSampleCount;
+}
+
+void MPUSensorTask::setFilterBandwidth(mpu6050_bandwidth_t bandwidth) {
+  mpu.setFilterBandwidth(bandwidth);
+}
+
 void MPUSensorTask::setDataLoggingTask(DataLoggingTask* dataLogger) {
   this->dataLogger = dataLogger;
 }
@@ -235,3 +930,139 @@ void MPUSensorTask::setDataLoggingTask(DataLoggingTask* dataLogger) {
 void MPUSensorTask::setBuzzerFeedbackTask(BuzzerFeedbackTask* buzzerTask) {
   this->buzzerTask = buzzerTask;
 }
+
+bool MPUSensorTask::armBurst(uint32_t durationMs) {
+  // Calibration and a running recording both need the normal acquisition path
+  if (isCalibrating || (dataLogger && dataLogger->isRecording())) {
+    return false;
+  }
+  return burst.arm(durationMs);
+}
+
+BurstCapture& MPUSensorTask::getBurst() {
+  return burst;
+}
+
+void MPUSensorTask::applyInhibitMask(uint16_t &currentMask) {
+  // Nothing may write flash or hold the loop while the FIFO is draining
+  BurstCapture::State state = burst.getState();
+  if (state == BurstCapture::BURST_CAPTURING) {
+    currentMask |= DATA_LOGGING_TASK_MASK | SPECTRUM_TASK_MASK | RAINFLOW_TASK_MASK;
+  }
+  
+  // Queued commands (file I/O, self-tests, starting a recording) wait until the burst is committed
+  if (state == BurstCapture::BURST_ARMED || state == BurstCapture::BURST_CAPTURING ||
+      state == BurstCapture::BURST_CAPTURED || state == BurstCapture::BURST_WRITING) {
+    currentMask |= COMMAND_TASK_MASK;
+  }
+}
+
+void MPUSensorTask::startBurst() {
+  if (!burst.allocate()) {
+    debugOutput.at(LOG_LEVEL_ERROR).println(F("Burst: not enough heap for the capture arena"));
+    burst.setState(BurstCapture::BURST_FAILED);
+    return;
+  }
+  
+  // 1kHz output needs the DLPF on and no rate divider. Only accel and gyro go to the FIFO.
+  Wire.setClock(BURST_I2C_CLOCK_HZ);
+  mpu.setFilterBandwidth(BURST_BANDWIDTH);
+  writeRegister(MPU6050_REG_SMPLRT_DIV, 0);
+  writeRegister(MPU6050_REG_USER_CTRL, MPU6050_USER_CTRL_FIFO_RESET);
+  writeRegister(MPU6050_REG_FIFO_EN, MPU6050_FIFO_EN_ACCEL_GYRO);
+  writeRegister(MPU6050_REG_USER_CTRL, MPU6050_USER_CTRL_FIFO_EN);
+  
+  burst.setStartMillis(millis());
+  burst.setState(BurstCapture::BURST_CAPTURING);
+  runInterval = 0;
+  
+  debugOutput.print(F("Burst: capturing "));
+  debugOutput.print(burst.getCapacity());
+  debugOutput.println(F(" samples"));
+}
+
+void MPUSensorTask::drainBurstFIFO() {
+  uint16_t available = readFIFOCount();
+  if (available >= MPU6050_FIFO_SIZE) {
+    // Samples were lost and the FIFO may be out of step, so start it again
+    burst.markOverflow();
+    writeRegister(MPU6050_REG_USER_CTRL, MPU6050_USER_CTRL_FIFO_RESET | MPU6050_USER_CTRL_FIFO_EN);
+    return;
+  }
+  
+  uint8_t buffer[BURST_FIFO_READ_BYTES];
+  available -= available % BURST_SAMPLE_BYTES;
+  while (available > 0 && !burst.isFull()) {
+    uint8_t length = available < BURST_FIFO_READ_BYTES ? available : BURST_FIFO_READ_BYTES;
+    Wire.beginTransmission(MPU6050_ADDR);
+    Wire.write(MPU6050_REG_FIFO_R_W);
+    if (Wire.endTransmission(false) != 0 ||
+        Wire.requestFrom((uint8_t)MPU6050_ADDR, (size_t)length) != length) {
+      break;
+    }
+    for (uint8_t i = 0; i < length; i++) {
+      buffer[i] = Wire.read();
+    }
+    for (uint8_t offset = 0; offset < length; offset += BURST_SAMPLE_BYTES) {
+      burst.add(buffer + offset);
+    }
+    available -= length;
+  }
+  
+  // A sensor that stops producing samples must not hold the burst open for ever
+  if (burst.isFull() || millis() - burst.getStartMillis() > 2 * burst.getCapacity() * 1000 / BURST_RATE_HZ + 1000) {
+    finishBurst();
+  }
+}
+
+void MPUSensorTask::finishBurst() {
+  writeRegister(MPU6050_REG_USER_CTRL, 0);
+  writeRegister(MPU6050_REG_FIFO_EN, 0);
+  writeRegister(MPU6050_REG_USER_CTRL, MPU6050_USER_CTRL_FIFO_RESET);
+  mpu.setFilterBandwidth(MPU6050_BANDWIDTH);
+  Wire.setClock(I2C_DEFAULT_CLOCK_HZ);
+  runInterval = normalRunInterval;
+  
+  debugOutput.print(F("Burst: captured "));
+  debugOutput.print(burst.getSampleCount());
+  debugOutput.print(F(" samples in "));
+  debugOutput.print(millis() - burst.getStartMillis());
+  debugOutput.println(F("ms"));
+  
+  burst.setState(BurstCapture::BURST_CAPTURED);
+  if (dataLogger) {
+    dataLogger->writeBurst(*this);
+  } else {
+    burst.release();
+    burst.setState(BurstCapture::BURST_FAILED);
+  }
+}
+
+void MPUSensorTask::writeRegister(uint8_t reg, uint8_t value) {
+  Wire.beginTransmission(MPU6050_ADDR);
+  Wire.write(reg);
+  Wire.write(value);
+  Wire.endTransmission();
+}
+
+uint16_t MPUSensorTask::readFIFOCount() {
+  Wire.beginTransmission(MPU6050_ADDR);
+  Wire.write(MPU6050_REG_FIFO_COUNT_H);
+  if (Wire.endTransmission(false) != 0 || Wire.requestFrom((uint8_t)MPU6050_ADDR, (size_t)2) != 2) {
+    return 0;
+  }
+  uint16_t high = Wire.read();
+  return (high << 8) | Wire.read();
+}
+
+void MPUSensorTask::setRainflowTask(RainflowTask* rainflowTask) {
+  this->rainflowTask = rainflowTask;
+}
+
+void MPUSensorTask::setSerialStreamTask(SerialStreamTask* serialStreamTask) {
+  this->serialStreamTask = serialStreamTask;
+}
+
+void MPUSensorTask::setUdpStreamTask(UdpStreamTask* udpStreamTask) {
+  this->udpStreamTask = udpStreamTask;
+}
@@ -3,12 +3,22 @@
 
 #include "Task.h"
 #include "constants.h"
+#include "StillnessDetector.h"
+#include "TemperatureModel.h"
+#include "Decimator.h"
+#include "BiquadFilter.h"
+#include "SensorSample.h"
+#include "BurstCapture.h"
+#include "JsonWriter.h"
 #include <Adafruit_MPU6050.h>
 #include <Adafruit_Sensor.h>
 
 // Forward declarations
 class DataLoggingTask;
 class BuzzerFeedbackTask;
+class RainflowTask;
+class SerialStreamTask;
+class UdpStreamTask;
 
 class MPUSensorTask : public Task {
   public:
@@ -33,6 +43,19 @@ class MPUSensorTask : public Task {
     float gyro_offset_y = 0;
     float gyro_offset_z = 0;
     
+    // Accelerometer scale factors (measured / true) from six-position calibration
+    float accel_scale_x = 1;
+    float accel_scale_y = 1;
+    float accel_scale_z = 1;
+    
+    // Gyro bias drift rate in deg/s per minute, measured by online bias tracking
+    float gyro_drift_x = 0;
+    float gyro_drift_y = 0;
+    float gyro_drift_z = 0;
+    
+    // Die temperature in C, averaged over TEMPCOMP_UPDATE_MS
+    float temperature = 0;
+    
     // Calibration state
     bool isCalibrated = false;
     bool isCalibrating = false;
@@ -50,7 +73,48 @@ class MPUSensorTask : public Task {
     // Calibration methods
     void startCalibration();
     bool isCalibrationComplete() const;
-    void accumulateCalibrationSample();
+    bool accumulateCalibrationSample();  // False if the sample could not be read
+    
+    // Six-position calibration: the sensor is rested on each of its six faces in turn
+    // and one capture is taken per face (button short press or /api/calibrate/sixpos)
+    void startSixPositionCalibration();
+    bool captureSixPosition();
+    void cancelSixPositionCalibration();
+    bool isSixPositionActive() const;
+    uint8_t getSixPositionCapturedMask() const;
+    
+    // Online gyro bias tracking while the sensor is stationary
+    bool isStationary() const;
+    
+    // Acquisition at acquisitionRateHz, CIC-decimated down to the sampleRateMs logging rate
+    void configureAcquisition();
+    uint16_t getAcquisitionRateHz() const;
+    uint16_t getDecimationRatio() const;
+    uint8_t getDecimationOrder() const;
+    float getFilterMicrosPerSample() const;
+    const BiquadFilter& getFilterChain() const;
+    
+    // Active sections and their design response at 1/4-4x the section frequency. With measure,
+    // the fixed-point gain at each point too, which takes tens of milliseconds.
+    void writeFiltersJSON(JsonWriter& json, bool measure);
+    
+    // Latest full-rate sample, before decimation. The count increments with every new sample.
+    const SensorSample& getFullRateSample() const;
+    uint32_t getFullRateSampleCount() const;
+    
+    // Sensor low-pass filter, widened while spectra are acquired
+    void setFilterBandwidth(mpu6050_bandwidth_t bandwidth);
+    
+    // Boot-time auto calibration and startup timing
+    void startBootCalibration();
+    bool isReady() const;
+    unsigned long getReadyTimeMs() const;
+    const __FlashStringHelper* getBootCalibrationResult() const;
+    
+    // Temperature compensation model built from calibration sessions
+    const TemperatureModel& getTemperatureModel() const;
+    bool isTemperatureCompensationActive() const;
+    void clearTemperatureModel();
     
     // EEPROM calibration methods
     bool loadSavedCalibration();
@@ -60,6 +124,7 @@ class MPUSensorTask : public Task {
     // Sensor data methods
     void updateSensorData();
     void resetSensorData();
+    bool readRawSample(int16_t accel[3], int16_t gyro[3], int16_t& temperature);
     
     // FIFO methods
     bool initFIFO();
@@ -72,22 +137,137 @@ class MPUSensorTask : public Task {
     // Buzzer feedback integration
     void setBuzzerFeedbackTask(BuzzerFeedbackTask* buzzerTask);
     
+    // Rainflow counting integration, fed with every full-rate sample
+    void setRainflowTask(RainflowTask* rainflowTask);
+    
+    // Binary serial streaming, fed with every logged sample
+    void setSerialStreamTask(SerialStreamTask* serialStreamTask);
+    
+    // UDP streaming, fed with every logged sample
+    void setUdpStreamTask(UdpStreamTask* udpStreamTask);
+    
+    // RAM burst capture: arms a capture of durationMs at BURST_RATE_HZ from the sensor FIFO.
+    // Normal acquisition pauses and flash users are inhibited until it completes, then
+    // DataLoggingTask writes it out. CommandTask is held off until the burst is committed.
+    bool armBurst(uint32_t durationMs);
+    BurstCapture& getBurst();
+    
+    // Raw counts to ACCEL_FIXED_PER_G / GYRO_FIXED_PER_DPS units with the current calibration
+    void calibrateRawSample(const int16_t rawAccel[3], const int16_t rawGyro[3],
+                            int32_t fixedAccel[3], int32_t fixedGyro[3]) const;
+    
+    virtual void applyInhibitMask(uint16_t &currentMask) override;
+    
   private:
+    enum CalibrationMode {
+      CAL_MODE_LEVEL,          // Sensor level with Z up, offsets only
+      CAL_MODE_SIXPOS,         // One face of a six-position calibration
+      CAL_MODE_BOOT            // Fast stillness-gated calibration at startup
+    };
+    
+    enum BootCalibrationState {
+      BOOT_CAL_DISABLED,       // autoCalibration off, ready immediately
+      BOOT_CAL_WAITING,        // Waiting for the sensor to be still
+      BOOT_CAL_RUNNING,        // Accumulating fast calibration samples
+      BOOT_CAL_SAVED,          // Offsets moved beyond threshold and were written to EEPROM
+      BOOT_CAL_UNCHANGED,      // Offsets within threshold, EEPROM left alone
+      BOOT_CAL_TIMEOUT,        // Never still within the timeout, using saved calibration
+      BOOT_CAL_NOT_LEVEL       // No saved calibration and not resting Z-up, left uncalibrated
+    };
+    
     Adafruit_MPU6050 mpu;
     DataLoggingTask* dataLogger;
     BuzzerFeedbackTask* buzzerTask;
+    RainflowTask* rainflowTask = nullptr;
+    SerialStreamTask* serialStreamTask = nullptr;
+    UdpStreamTask* udpStreamTask = nullptr;
     
-    // Calibration accumulation variables
+    // Calibration accumulation variables (raw sensor counts)
+    CalibrationMode calibrationMode = CAL_MODE_LEVEL;
+    uint16_t calibrationSampleTarget = CALIBRATION_SAMPLES;
     float accel_sum_x = 0;
     float accel_sum_y = 0;
     float accel_sum_z = 0;
     float gyro_sum_x = 0;
     float gyro_sum_y = 0;
     float gyro_sum_z = 0;
+    float temperature_sum = 0;
+    
+    // Six-position capture state. Orientation index is axis * 2 + (pointing down ? 1 : 0)
+    bool sixPosActive = false;
+    bool hasSixPositionScale = false;
+    uint8_t sixPosCapturedMask = 0;
+    float sixPosAccelMean[SIXPOS_POSITION_COUNT][3];
+    float sixPosGyroSum[3];
+    float sixPosTemperatureSum = 0;
+    
+    // Integer calibration model used by updateSensorData(), derived from the float offsets/scales
+    int32_t accelOffsetQ4[3];    // Raw counts * 16
+    int32_t accelGainQ16[3];     // Raw counts -> ACCEL_FIXED_PER_G units, Q16
+    int32_t gyroOffsetQ4[3];     // Raw counts * 16
+    int32_t gyroGainQ16;         // Raw counts -> GYRO_FIXED_PER_DPS units, Q16
+    
+    // Online gyro bias tracking
+    StillnessDetector stillnessDetector;
+    int32_t gyroBiasQ12[3];              // Tracked gyro bias, raw counts * 4096
+    float driftWindowStartBias[3];       // Bias at the start of the drift window (deg/s)
+    float persistedGyroBias[3];          // Bias last written to EEPROM (deg/s)
+    unsigned long driftWindowStart = 0;
+    unsigned long lastBiasPersist = 0;
+    
+    // Boot calibration state
+    BootCalibrationState bootCalibrationState = BOOT_CAL_DISABLED;
+    unsigned long bootCalibrationStart = 0;
+    unsigned long readyTimeMs = 0;
+    unsigned long normalRunInterval = 100;
+    
+    // Acquisition and decimation state
+    BiquadFilter filterChain;
+    FilterSectionConfig configuredFilters[FILTER_MAX_SECTIONS];
+    uint8_t configuredFilterCount = 0;
+    Decimator decimator;
+    SensorSample fullRateSample;
+    uint32_t fullRateSampleCount = 0;
+    uint16_t acquisitionIntervalMs = 10;
+    uint16_t configuredAcquisitionRateHz = 0;
+    uint16_t configuredSampleRateMs = 0;
+    uint8_t configuredDecimationOrder = 0;
+    uint32_t filterMicrosTotal = 0;
+    uint16_t filterTimedSamples = 0;
+    float filterMicrosPerSample = 0;
+    
+    // Temperature compensation, applied on the hot path as extra integer offsets
+    TemperatureModel temperatureModel;
+    int32_t accelTempQ4[3] = {0, 0, 0};   // Raw counts * 16
+    int32_t gyroTempQ4[3] = {0, 0, 0};    // Raw counts * 16
+    int32_t temperatureRawSum = 0;
+    uint16_t temperatureRawCount = 0;
+    unsigned long lastTemperatureUpdate = 0;
+    
+    // RAM burst capture
+    BurstCapture burst;
+    
+    void startBurst();
+    void drainBurstFIFO();
+    void finishBurst();
+    void writeRegister(uint8_t reg, uint8_t value);
+    uint16_t readFIFOCount();
     
     // Internal methods
+    void beginSampleAccumulation(CalibrationMode mode, uint16_t samples = CALIBRATION_SAMPLES);
     void calculateOffsets();
     void applyOffsets();
+    void finishSixPositionCapture();
+    bool solveSixPosition();
+    void updateFixedPointCalibration();
+    void trackGyroBias(const int16_t rawGyro[3]);
+    void updateGyroDrift();
+    void updateTemperatureCompensation();
+    void recordTemperaturePoint(float calibrationTemperature);
+    void updateBootCalibration();
+    void finishBootCalibration();
+    void applyBootCalibration(const float newGyro[3]);
+    bool filterSettingsChanged() const;
 };
 
 #endif
@@ -0,0 +1,94 @@
+#include "MinMaxPyramid.h"
+
+MinMaxPyramid::MinMaxPyramid() {
+  reset();
+}
+
+void MinMaxPyramid::reset() {
+  for (uint8_t level = 0; level < LEVELS; level++) {
+    current[level].sampleCount = 0;
+    merged[level] = 0;
+  }
+}
+
+uint8_t MinMaxPyramid::add(uint32_t timestamp, const float* values) {
+  MPUPyramidRecord sample;
+  sample.timestamp = timestamp;
+  sample.sampleCount = 1;
+  sample.reserved = 0;
+  for (uint8_t i = 0; i < CHANNELS; i++) {
+    sample.minimum[i] = sample.maximum[i] = toRecordUnits(values[i], i);
+  }
+  
+  merge(current[0], sample);
+  if (++merged[0] < PYRAMID_FACTOR) {
+    return 0;
+  }
+  return complete(0);
+}
+
+uint8_t MinMaxPyramid::finish() {
+  uint8_t levels = 0;
+  for (uint8_t level = 0; level < LEVELS; level++) {
+    if (merged[level] > 0) {
+      // Completing a level merges into the one above, which is then completed in turn
+      levels |= complete(level);
+    }
+  }
+  reset();
+  return levels;
+}
+
+const MPUPyramidRecord& MinMaxPyramid::getRecord(uint8_t level) const {
+  return completed[level];
+}
+
+const char* MinMaxPyramid::suffix(uint8_t level) {
+  static const char* const suffixes[LEVELS] = { ".p16", ".p256", ".p4096" };
+  return suffixes[level];
+}
+
+// Moves a bucket to completed, merges it into the next level and completes that level too
+// if it is now full. Returns the mask of completed levels.
+uint8_t MinMaxPyramid::complete(uint8_t level) {
+  uint8_t levels = 1 << level;
+  completed[level] = current[level];
+  current[level].sampleCount = 0;
+  merged[level] = 0;
+  
+  if (level + 1 < LEVELS) {
+    merge(current[level + 1], completed[level]);
+    if (++merged[level + 1] >= PYRAMID_FACTOR) {
+      levels |= complete(level + 1);
+    }
+  }
+  return levels;
+}
+
+void MinMaxPyramid::merge(MPUPyramidRecord& into, const MPUPyramidRecord& bucket) {
+  if (into.sampleCount == 0) {
+    into = bucket;
+    return;
+  }
+  
+  for (uint8_t i = 0; i < CHANNELS; i++) {
+    if (bucket.minimum[i] < into.minimum[i]) {
+      into.minimum[i] = bucket.minimum[i];
+    }
+    if (bucket.maximum[i] > into.maximum[i]) {
+      into.maximum[i] = bucket.maximum[i];
+    }
+  }
+  into.sampleCount += bucket.sampleCount;
+}
+
+int16_t MinMaxPyramid::toRecordUnits(float value, uint8_t channel) {
+  float scaled = value * (channel < 3 ? PYRAMID_ACCEL_PER_G : PYRAMID_GYRO_PER_DPS);
+  if (scaled >= INT16_MAX) {
+    return INT16_MAX;
+  }
+  if (scaled <= INT16_MIN) {
+    return INT16_MIN;
+  }
+  return (int16_t)lroundf(scaled);
+}
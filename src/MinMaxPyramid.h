@@ -0,0 +1,43 @@
+#ifndef MIN_MAX_PYRAMID_H
+#define MIN_MAX_PYRAMID_H
+
+#include <Arduino.h>
+#include "MPULogRecord.h"
+#include "constants.h"
+
+// Incremental min/max downsampling of a raw recording at PYRAMID_LEVELS resolutions.
+// Level 0 merges PYRAMID_FACTOR samples per bucket and each higher level merges
+// PYRAMID_FACTOR buckets of the level below as they complete, so a sample costs one
+// bucket update plus, amortized, 1/(PYRAMID_FACTOR - 1) of a merge.
+class MinMaxPyramid {
+  public:
+    static const uint8_t LEVELS = PYRAMID_LEVELS;
+    static const uint8_t CHANNELS = 6;  // Accel X/Y/Z, gyro X/Y/Z
+    
+    MinMaxPyramid();
+    
+    void reset();
+    
+    // Adds a sample (accel in G, gyro in deg/s). Returns a bit mask of the levels that
+    // completed a bucket, readable with getRecord() until the next call.
+    uint8_t add(uint32_t timestamp, const float* values);
+    
+    // Completes every partly filled bucket, as at the end of a recording, then resets
+    uint8_t finish();
+    
+    const MPUPyramidRecord& getRecord(uint8_t level) const;
+    
+    // Sidecar suffix of a level
+    static const char* suffix(uint8_t level);
+    
+  private:
+    MPUPyramidRecord current[LEVELS];
+    MPUPyramidRecord completed[LEVELS];
+    uint8_t merged[LEVELS];           // Samples or buckets merged into current
+    
+    uint8_t complete(uint8_t level);
+    static void merge(MPUPyramidRecord& into, const MPUPyramidRecord& bucket);
+    static int16_t toRecordUnits(float value, uint8_t channel);
+};
+
+#endif
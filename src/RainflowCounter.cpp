@@ -0,0 +1,146 @@
+#include "RainflowCounter.h"
+#include <stdlib.h>
+#include <string.h>
+
+RainflowCounter::RainflowCounter() {
+  reset();
+}
+
+void RainflowCounter::reset() {
+  memset(matrix, 0, sizeof(matrix));
+  totalHalfCycles = 0;
+  stackOverflows = 0;
+  residualCount = 0;
+  residualPeak = 0;
+  started = false;
+  direction = 0;
+  extreme = 0;
+}
+
+void RainflowCounter::add(int32_t value) {
+  if (!started) {
+    // The first sample starts the history
+    started = true;
+    extreme = value;
+    pushTurningPoint(value);
+    return;
+  }
+  
+  if (direction > 0) {
+    if (value > extreme) {
+      extreme = value;
+    } else if (value < extreme - RAINFLOW_HYSTERESIS) {
+      pushTurningPoint(extreme);
+      direction = -1;
+      extreme = value;
+    }
+  } else if (direction < 0) {
+    if (value < extreme) {
+      extreme = value;
+    } else if (value > extreme + RAINFLOW_HYSTERESIS) {
+      pushTurningPoint(extreme);
+      direction = 1;
+      extreme = value;
+    }
+  } else if (value > extreme + RAINFLOW_HYSTERESIS) {
+    direction = 1;
+    extreme = value;
+  } else if (value < extreme - RAINFLOW_HYSTERESIS) {
+    direction = -1;
+    extreme = value;
+  }
+}
+
+void RainflowCounter::pushTurningPoint(int32_t value) {
+  if (residualCount == RAINFLOW_STACK_SIZE) {
+    // Close the oldest reversal as a half cycle rather than grow the stack
+    countCycle(residual[0], residual[1], 1);
+    memmove(residual, residual + 1, (RAINFLOW_STACK_SIZE - 1) * sizeof(residual[0]));
+    residualCount--;
+    stackOverflows++;
+  }
+  
+  residual[residualCount++] = value;
+  
+  // Four-point method: extract every closed cycle the new point completes
+  while (residualCount >= 4) {
+    int32_t s1 = residual[residualCount - 4];
+    int32_t s2 = residual[residualCount - 3];
+    int32_t s3 = residual[residualCount - 2];
+    int32_t s4 = residual[residualCount - 1];
+    int32_t inner = abs(s3 - s2);
+    if (inner > abs(s2 - s1) || inner > abs(s4 - s3)) {
+      break;
+    }
+    
+    countCycle(s2, s3, 2);
+    residual[residualCount - 3] = s4;
+    residualCount -= 2;
+  }
+  
+  if (residualCount > residualPeak) {
+    residualPeak = residualCount;
+  }
+}
+
+void RainflowCounter::countCycle(int32_t from, int32_t to, uint8_t halfCycles) {
+  int32_t range = abs(to - from);
+  int32_t mean = (from + to) / 2;
+  
+  int32_t rangeBin = range / RAINFLOW_RANGE_BIN_WIDTH;
+  if (rangeBin >= RAINFLOW_RANGE_BINS) {
+    rangeBin = RAINFLOW_RANGE_BINS - 1;
+  }
+  
+  // Mean bins are centred on zero; division rounds towards minus infinity
+  int32_t meanBin = (mean >= 0 ? mean / RAINFLOW_MEAN_BIN_WIDTH : (mean - RAINFLOW_MEAN_BIN_WIDTH + 1) / RAINFLOW_MEAN_BIN_WIDTH)
+                    + RAINFLOW_MEAN_BINS / 2;
+  if (meanBin < 0) {
+    meanBin = 0;
+  } else if (meanBin >= RAINFLOW_MEAN_BINS) {
+    meanBin = RAINFLOW_MEAN_BINS - 1;
+  }
+  
+  matrix[rangeBin][meanBin] += halfCycles;
+  totalHalfCycles += halfCycles;
+}
+
+uint32_t RainflowCounter::getHalfCycles(uint8_t rangeBin, uint8_t meanBin) const {
+  return matrix[rangeBin][meanBin];
+}
+
+const uint32_t* RainflowCounter::getMatrix() const {
+  return &matrix[0][0];
+}
+
+void RainflowCounter::setMatrix(const uint32_t* halfCycles) {
+  memcpy(matrix, halfCycles, sizeof(matrix));
+  totalHalfCycles = 0;
+  for (uint16_t i = 0; i < RAINFLOW_RANGE_BINS * RAINFLOW_MEAN_BINS; i++) {
+    totalHalfCycles += halfCycles[i];
+  }
+}
+
+uint32_t RainflowCounter::getTotalHalfCycles() const {
+  return totalHalfCycles;
+}
+
+uint8_t RainflowCounter::getResidualCount() const {
+  return residualCount;
+}
+
+uint8_t RainflowCounter::getResidualPeak() const {
+  return residualPeak;
+}
+
+uint32_t RainflowCounter::getStackOverflows() const {
+  return stackOverflows;
+}
+
+int32_t RainflowCounter::rangeBinEdge(uint8_t bin) {
+  return (int32_t)bin * RAINFLOW_RANGE_BIN_WIDTH;
+}
+
+int32_t RainflowCounter::meanBinEdge(uint8_t bin) {
+  return ((int32_t)bin - RAINFLOW_MEAN_BINS / 2) * RAINFLOW_MEAN_BIN_WIDTH;
+}
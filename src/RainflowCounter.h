@@ -0,0 +1,64 @@
+#ifndef RAINFLOW_COUNTER_H
+#define RAINFLOW_COUNTER_H
+
+#include <stdint.h>
+#include "constants.h"
+
+/**
+ * Streaming rainflow cycle counter for one channel of fixed-point samples.
+ *
+ * Samples are reduced to turning points with a hysteresis of RAINFLOW_HYSTERESIS, so
+ * sensor noise does not register as cycles. Each turning point is pushed onto a residual
+ * stack and the four-point method extracts closed cycles: for the last four points
+ * S1..S4, if |S2 - S3| is no larger than |S1 - S2| and |S3 - S4|, S2-S3 is a full cycle
+ * and both points are removed. Cycles are binned by range and mean into a fixed matrix
+ * of half-cycle counts (a full cycle counts two).
+ *
+ * Memory is fixed: the matrix (RAINFLOW_RANGE_BINS x RAINFLOW_MEAN_BINS uint32) plus a
+ * RAINFLOW_STACK_SIZE residual. If the residual fills, its oldest point is closed as a
+ * half cycle so the stack never grows; getStackOverflows() reports how often that happened.
+ * Per sample the work is a comparison unless a turning point is confirmed, and each
+ * turning point is removed at most once, so the four-point loop is O(1) amortised.
+ * Nothing here needs the Arduino core, so tools/rainflow_benchmark.cpp builds it on the host.
+ */
+class RainflowCounter {
+  public:
+    RainflowCounter();
+    
+    // Clear the matrix, the residual and the turning point detector
+    void reset();
+    
+    void add(int32_t value);
+    
+    uint32_t getHalfCycles(uint8_t rangeBin, uint8_t meanBin) const;
+    const uint32_t* getMatrix() const;    // RAINFLOW_RANGE_BINS * RAINFLOW_MEAN_BINS, range-major
+    void setMatrix(const uint32_t* halfCycles);
+    
+    uint32_t getTotalHalfCycles() const;
+    uint8_t getResidualCount() const;
+    uint8_t getResidualPeak() const;      // Deepest the residual has been since reset()
+    uint32_t getStackOverflows() const;
+    
+    // Lower bin edges in fixed-point units
+    static int32_t rangeBinEdge(uint8_t bin);
+    static int32_t meanBinEdge(uint8_t bin);
+    
+  private:
+    uint32_t matrix[RAINFLOW_RANGE_BINS][RAINFLOW_MEAN_BINS];
+    uint32_t totalHalfCycles;
+    uint32_t stackOverflows;
+    
+    int32_t residual[RAINFLOW_STACK_SIZE];
+    uint8_t residualCount;
+    uint8_t residualPeak;
+    
+    // Turning point detection
+    bool started;
+    int8_t direction;       // +1 rising, -1 falling, 0 not yet moved by the hysteresis
+    int32_t extreme;        // Most extreme value since the last turning point
+    
+    void pushTurningPoint(int32_t value);
+    void countCycle(int32_t from, int32_t to, uint8_t halfCycles);
+};
+
+#endif
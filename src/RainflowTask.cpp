@@ -0,0 +1,221 @@
+#include "RainflowTask.h"
+#include "DebugOutput.h"
+#include "Settings.h"
+#include <FS.h>
+
+RainflowTask::RainflowTask(Settings& settings)
+  : Task(),
+    settings(settings) {
+  setName(F("RainflowTask"));
+  runInterval = 1000;  // Only settings changes and persistence; counting happens in addSample()
+}
+
+void RainflowTask::run() {
+  if (!settings.rainflowEnabled) {
+    if (active) {
+      stop();
+    }
+    return;
+  }
+  
+  if (active && channel != settings.rainflowChannel) {
+    stop();
+  }
+  if (!active) {
+    start();
+    return;
+  }
+  
+  const unsigned long persistMs = (unsigned long)settings.rainflowPersistMin * 60000UL;
+  if (samples != samplesAtPersist && millis() - lastPersistMillis >= persistMs) {
+    persist();
+  }
+}
+
+void RainflowTask::addSample(const SensorSample& sample) {
+  if (!active) {
+    return;
+  }
+  
+  int32_t value = channel < 3 ? sample.accel[channel] : sample.gyro[channel - 3];
+  
+  unsigned long start = micros();
+  counter.add(value);
+  microsTotal += micros() - start;
+  samples++;
+  
+  if (++timedSamples >= DECIMATION_TIMING_SAMPLES) {
+    microsPerSample = (float)microsTotal / timedSamples;
+    microsTotal = 0;
+    timedSamples = 0;
+  }
+}
+
+void RainflowTask::start() {
+  channel = settings.rainflowChannel;
+  counter.reset();
+  samples = 0;
+  restored = load();
+  samplesAtPersist = samples;
+  lastPersistMillis = millis();
+  active = true;
+  
+  debugOutput.print(F("Rainflow counting started on "));
+  debugOutput.print(channelName(channel));
+  debugOutput.println(restored ? F(" (restored saved counts)") : F(""));
+}
+
+void RainflowTask::stop() {
+  if (samples != samplesAtPersist) {
+    persist();
+  }
+  active = false;
+  debugOutput.println(F("Rainflow counting stopped"));
+}
+
+void RainflowTask::resetCounts() {
+  counter.reset();
+  samples = 0;
+  samplesAtPersist = 0;
+  restored = false;
+  if (SPIFFS.exists(RAINFLOW_FILE)) {
+    SPIFFS.remove(RAINFLOW_FILE);
+  }
+}
+
+bool RainflowTask::load() {
+  File file = SPIFFS.open(RAINFLOW_FILE, "r");
+  if (!file) {
+    return false;
+  }
+  
+  // Counts from another channel or bin layout are not comparable, so they are not restored
+  RainflowFileHeader header;
+  uint32_t matrix[RAINFLOW_RANGE_BINS * RAINFLOW_MEAN_BINS];
+  bool ok = file.read(reinterpret_cast<uint8_t*>(&header), sizeof(header)) == sizeof(header)
+            && header.magic == RAINFLOW_FILE_MAGIC && header.version == RAINFLOW_FILE_VERSION
+            && header.channel == channel
+            && header.rangeBins == RAINFLOW_RANGE_BINS && header.meanBins == RAINFLOW_MEAN_BINS
+            && header.rangeBinWidth == RAINFLOW_RANGE_BIN_WIDTH && header.meanBinWidth == RAINFLOW_MEAN_BIN_WIDTH
+            && file.read(reinterpret_cast<uint8_t*>(matrix), sizeof(matrix)) == sizeof(matrix);
+  file.close();
+  
+  if (ok) {
+    counter.setMatrix(matrix);
+    samples = header.samples;
+  }
+  return ok;
+}
+
+bool RainflowTask::persist() {
+  File file = SPIFFS.open(RAINFLOW_FILE, "w");
+  if (!file) {
+    debugOutput.at(LOG_LEVEL_ERROR).println(F("Failed to open rainflow file"));
+    return false;
+  }
+  
+  RainflowFileHeader header;
+  header.magic = RAINFLOW_FILE_MAGIC;
+  header.version = RAINFLOW_FILE_VERSION;
+  header.channel = channel;
+  header.rangeBins = RAINFLOW_RANGE_BINS;
+  header.meanBins = RAINFLOW_MEAN_BINS;
+  header.rangeBinWidth = RAINFLOW_RANGE_BIN_WIDTH;
+  header.meanBinWidth = RAINFLOW_MEAN_BIN_WIDTH;
+  header.samples = samples;
+  
+  const size_t matrixBytes = RAINFLOW_RANGE_BINS * RAINFLOW_MEAN_BINS * sizeof(uint32_t);
+  bool ok = file.write(reinterpret_cast<const uint8_t*>(&header), sizeof(header)) == sizeof(header)
+            && file.write(reinterpret_cast<const uint8_t*>(counter.getMatrix()), matrixBytes) == matrixBytes;
+  file.close();
+  
+  samplesAtPersist = samples;
+  lastPersistMillis = millis();
+  if (!ok) {
+    debugOutput.at(LOG_LEVEL_ERROR).println(F("Failed to write rainflow file"));
+  }
+  return ok;
+}
+
+void RainflowTask::writeStatusJSON(JsonWriter& json) {
+  // Bin edges are reported in G for accel channels and deg/s for gyro
+  const float unitScale = channel < 3 ? 1.0f / ACCEL_FIXED_PER_G : 1.0f / GYRO_FIXED_PER_DPS;
+  
+  json.add("enabled", settings.rainflowEnabled);
+  json.add("active", active);
+  json.add("channel", channelName(active ? channel : settings.rainflowChannel));
+  json.add("restored", restored);
+  json.add("samples", samples);
+  json.add("cycles", counter.getTotalHalfCycles() / 2.0f, 1);
+  json.add("residual", counter.getResidualCount());
+  json.add("residualPeak", counter.getResidualPeak());
+  json.add("stackOverflows", counter.getStackOverflows());
+  json.add("microsPerSample", microsPerSample, 2);
+  json.add("rangeBinWidth", RAINFLOW_RANGE_BIN_WIDTH * unitScale, 3);
+  json.add("meanBinWidth", RAINFLOW_MEAN_BIN_WIDTH * unitScale, 3);
+  json.add("firstMeanBin", RainflowCounter::meanBinEdge(0) * unitScale, 3);
+  
+  // Half-cycle counts, one row per range bin
+  json.beginArray("halfCycles");
+  for (uint8_t r = 0; r < RAINFLOW_RANGE_BINS; r++) {
+    json.beginArray();
+    for (uint8_t m = 0; m < RAINFLOW_MEAN_BINS; m++) {
+      json.value(counter.getHalfCycles(r, m));
+    }
+    json.endArray();
+  }
+  json.endArray();
+}
+
+void RainflowTask::runSelfTest(JsonWriter& json) {
+  // A 1G-mean carrier of 0.5G amplitude at 20 samples per period, with a 0.15G ripple
+  // after each peak. Every period is one 1G cycle plus two 0.15G cycles, so the counts are
+  // known; the last cycle of each size is still open in the residual when the input ends.
+  RainflowCounter* test = new RainflowCounter();
+  if (!test) {
+    json.add("error", F("Out of memory"));
+    return;
+  }
+  
+  const int32_t samplesPerPeriod = 20;
+  static const int8_t shape[samplesPerPeriod] = {
+    0, 3, 6, 8, 10, 8, 6, 9, 7, 3, 0, -3, -6, -8, -10, -8, -6, -9, -7, -3
+  };
+  const int32_t scale = ACCEL_FIXED_PER_G / 20;   // shape of +/-10 -> +/-0.5G
+  
+  unsigned long start = micros();
+  for (uint16_t i = 0; i < RAINFLOW_SELFTEST_SAMPLES; i++) {
+    test->add(ACCEL_FIXED_PER_G + shape[i % samplesPerPeriod] * scale);
+  }
+  unsigned long elapsed = micros() - start;
+  
+  // Split the matrix into the two cycle sizes (1G and 0.15G)
+  const uint32_t periods = RAINFLOW_SELFTEST_SAMPLES / samplesPerPeriod;
+  uint32_t largeCycles = 0;
+  uint32_t smallCycles = 0;
+  for (uint8_t r = 0; r < RAINFLOW_RANGE_BINS; r++) {
+    for (uint8_t m = 0; m < RAINFLOW_MEAN_BINS; m++) {
+      if (RainflowCounter::rangeBinEdge(r) >= ACCEL_FIXED_PER_G / 2) {
+        largeCycles += test->getHalfCycles(r, m);
+      } else {
+        smallCycles += test->getHalfCycles(r, m);
+      }
+    }
+  }
+  
+  json.add("samples", RAINFLOW_SELFTEST_SAMPLES);
+  json.add("expectedLargeCycles", periods);
+  json.add("largeCycles", largeCycles / 2.0f, 1);
+  json.add("expectedSmallCycles", 2 * periods);
+  json.add("smallCycles", smallCycles / 2.0f, 1);
+  json.add("residualPeak", test->getResidualPeak());
+  json.add("microsPerSample", (float)elapsed / RAINFLOW_SELFTEST_SAMPLES, 3);
+  json.add("counterBytes", sizeof(RainflowCounter));
+  
+  delete test;
+}
+
+const char* RainflowTask::channelName(uint8_t channel) {
+  static const char* const names[] = { "accelX", "accelY", "accelZ", "gyroX", "gyroY", "gyroZ" };
+  return channel < 6 ? names[channel] : "";
+}
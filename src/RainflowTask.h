@@ -0,0 +1,81 @@
+#ifndef RAINFLOW_TASK_H
+#define RAINFLOW_TASK_H
+
+#include "Task.h"
+#include "RainflowCounter.h"
+#include "SensorSample.h"
+#include "constants.h"
+#include "JsonWriter.h"
+
+// Forward declaration
+class Settings;
+
+// Header of RAINFLOW_FILE, followed by the RainflowCounter matrix
+struct __attribute__((packed)) RainflowFileHeader {
+  uint32_t magic;           // RAINFLOW_FILE_MAGIC
+  uint8_t version;          // RAINFLOW_FILE_VERSION
+  uint8_t channel;          // 0-2 accel X/Y/Z, 3-5 gyro X/Y/Z
+  uint8_t rangeBins;
+  uint8_t meanBins;
+  uint16_t rangeBinWidth;   // Fixed-point units
+  uint16_t meanBinWidth;
+  uint32_t samples;         // Samples counted into the matrix
+};
+
+/**
+ * On-device rainflow counting for fatigue analysis.
+ *
+ * While Settings::rainflowEnabled is set, MPUSensorTask hands every full-rate sample to
+ * addSample() and the selected channel is fed to a RainflowCounter. run() saves the
+ * range/mean matrix to RAINFLOW_FILE every rainflowPersistMin minutes and when counting
+ * stops, and restores it when counting starts on the same channel, so the matrix keeps
+ * accumulating across reboots until it is reset.
+ */
+class RainflowTask : public Task {
+  public:
+    static const uint16_t MASK { RAINFLOW_TASK_MASK };
+    
+    RainflowTask(Settings& settings);
+    
+    virtual uint16_t getMask() override {
+      return RainflowTask::MASK;
+    }
+    
+    virtual void run() override;
+    
+    // Called by MPUSensorTask at the acquisition rate
+    void addSample(const SensorSample& sample);
+    
+    // Clear the matrix in RAM and on flash
+    void resetCounts();
+    
+    void writeStatusJSON(JsonWriter& json);
+    
+    // Cycle counts for a known input, per-sample cost and memory use
+    static void runSelfTest(JsonWriter& json);
+    
+    static const char* channelName(uint8_t channel);
+    
+  private:
+    Settings& settings;
+    RainflowCounter counter;
+    
+    bool active = false;
+    uint8_t channel = 0;
+    uint32_t samples = 0;
+    uint32_t samplesAtPersist = 0;
+    unsigned long lastPersistMillis = 0;
+    bool restored = false;
+    
+    // Per-sample cost, averaged over DECIMATION_TIMING_SAMPLES
+    uint32_t microsTotal = 0;
+    uint16_t timedSamples = 0;
+    float microsPerSample = 0;
+    
+    void start();
+    void stop();
+    bool load();
+    bool persist();
+};
+
+#endif
@@ -0,0 +1,77 @@
+#include "SampleHistogram.h"
+#include "FixedFFT.h"
+
+SampleHistogram::SampleHistogram() {
+  reset();
+}
+
+void SampleHistogram::reset() {
+  memset(counts, 0, sizeof(counts));
+  sampleCount = 0;
+}
+
+void SampleHistogram::add(const SensorSample& sample) {
+  for (uint8_t i = 0; i < 3; i++) {
+    counts[i][signedBin(sample.accel[i], HISTOGRAM_ACCEL_BIN_WIDTH)]++;
+    counts[3 + i][signedBin(sample.gyro[i], HISTOGRAM_GYRO_BIN_WIDTH)]++;
+  }
+  
+  // Magnitude in mG keeps the sum of squares inside 32 bits for the +/-8G range
+  uint32_t magnitudeSq = 0;
+  for (uint8_t i = 0; i < 3; i++) {
+    int32_t mg = sample.accel[i] / 10;
+    magnitudeSq += (uint32_t)(mg * mg);
+  }
+  uint32_t bin = FixedFFT::isqrt(magnitudeSq) / (HISTOGRAM_ACCEL_BIN_WIDTH / 10);
+  counts[MAGNITUDE_CHANNEL][bin < HISTOGRAM_BINS ? bin : HISTOGRAM_BINS - 1]++;
+  
+  sampleCount++;
+}
+
+void SampleHistogram::merge(const SampleHistogram& other) {
+  for (uint8_t c = 0; c < CHANNELS; c++) {
+    for (uint8_t b = 0; b < HISTOGRAM_BINS; b++) {
+      counts[c][b] += other.counts[c][b];
+    }
+  }
+  sampleCount += other.sampleCount;
+}
+
+uint32_t SampleHistogram::getSampleCount() const {
+  return sampleCount;
+}
+
+uint32_t SampleHistogram::getCount(uint8_t channel, uint8_t bin) const {
+  return counts[channel][bin];
+}
+
+const uint32_t* SampleHistogram::getCounts() const {
+  return &counts[0][0];
+}
+
+int32_t SampleHistogram::getFirstBinEdge(uint8_t channel) {
+  if (channel == MAGNITUDE_CHANNEL) {
+    return 0;
+  }
+  int32_t width = channel < 3 ? HISTOGRAM_ACCEL_BIN_WIDTH : HISTOGRAM_GYRO_BIN_WIDTH;
+  return -(HISTOGRAM_BINS / 2) * width / 10;
+}
+
+const char* SampleHistogram::channelName(uint8_t channel) {
+  static const char* const names[CHANNELS] = {
+    "accelX", "accelY", "accelZ", "gyroX", "gyroY", "gyroZ", "accelMagnitude"
+  };
+  return channel < CHANNELS ? names[channel] : "";
+}
+
+// Bin index for a zero-centred channel; division rounds towards minus infinity
+uint8_t SampleHistogram::signedBin(int32_t value, int32_t width) {
+  int32_t bin = (value >= 0 ? value / width : (value - width + 1) / width) + HISTOGRAM_BINS / 2;
+  if (bin < 0) {
+    return 0;
+  }
+  if (bin >= HISTOGRAM_BINS) {
+    return HISTOGRAM_BINS - 1;
+  }
+  return (uint8_t)bin;
+}
@@ -0,0 +1,41 @@
+#ifndef SAMPLE_HISTOGRAM_H
+#define SAMPLE_HISTOGRAM_H
+
+#include <Arduino.h>
+#include "SensorSample.h"
+#include "constants.h"
+
+// Fixed-bin histograms of every channel plus the acceleration vector magnitude.
+// add() is a handful of integer operations per channel, so it can run on the
+// full-rate stream. Accel and gyro channels have HISTOGRAM_BINS bins centred on
+// zero; the magnitude channel starts at zero. The outer bins also count values
+// beyond the covered range.
+class SampleHistogram {
+  public:
+    static const uint8_t CHANNELS = 7;           // Accel X/Y/Z, gyro X/Y/Z, accel magnitude
+    static const uint8_t MAGNITUDE_CHANNEL = 6;
+    
+    SampleHistogram();
+    
+    void reset();
+    void add(const SensorSample& sample);
+    
+    // Add another histogram's counts into this one
+    void merge(const SampleHistogram& other);
+    
+    uint32_t getSampleCount() const;
+    uint32_t getCount(uint8_t channel, uint8_t bin) const;
+    const uint32_t* getCounts() const;           // CHANNELS * HISTOGRAM_BINS, channel-major
+    
+    // Lower edge of the first bin, in mG for accel and magnitude, 0.1 deg/s for gyro
+    static int32_t getFirstBinEdge(uint8_t channel);
+    static const char* channelName(uint8_t channel);
+    
+  private:
+    uint32_t counts[CHANNELS][HISTOGRAM_BINS];
+    uint32_t sampleCount;
+    
+    static uint8_t signedBin(int32_t value, int32_t width);
+};
+
+#endif
@@ -0,0 +1,15 @@
+#ifndef SENSOR_SAMPLE_H
+#define SENSOR_SAMPLE_H
+
+#include <stdint.h>
+
+// One calibrated sensor sample in fixed-point units (see ACCEL_FIXED_PER_G / GYRO_FIXED_PER_DPS).
+// MPUSensorTask publishes every sample at the acquisition rate so consumers such as triggers
+// can see the full-rate stream, while the logger only receives the decimated one.
+struct SensorSample {
+  uint32_t timestamp = 0;       // Millis since boot
+  int32_t accel[3] = {0, 0, 0}; // 0.1 mG
+  int32_t gyro[3] = {0, 0, 0};  // 0.01 deg/s
+};
+
+#endif
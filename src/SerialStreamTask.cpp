@@ -0,0 +1,191 @@
+#include "SerialStreamTask.h"
+#include "Settings.h"
+#include "DebugOutput.h"
+
+SerialStreamTask::SerialStreamTask(Settings& settings)
+  : Task(),
+    settings(settings) {
+  setName(F("SerialStreamTask"));
+  runInterval = 1000;  // Only watches the setting until streaming starts
+}
+
+void SerialStreamTask::run() {
+  if (!settings.serialStreamEnabled) {
+    if (streaming) {
+      stop();
+    }
+    return;
+  }
+  
+  if (streaming && baud != settings.serialStreamBaud) {
+    stop();
+  }
+  if (!streaming) {
+    start();
+  }
+  
+  if (batchCount > 0 && millis() - batchStartMillis >= STREAM_BATCH_MAX_MS) {
+    flushBatch();
+  }
+  drain(false);
+}
+
+bool SerialStreamTask::isStreaming() const {
+  return streaming;
+}
+
+void SerialStreamTask::addSample(float accel_x, float accel_y, float accel_z,
+                                 float yaw, float pitch, float roll) {
+  if (!streaming) {
+    return;
+  }
+  
+  if (batchCount == 0) {
+    batchStartMillis = millis();
+  }
+  MPULogRecord& record = batch[batchCount++];
+  record.clear();
+  record.timestamp = millis();
+  record.accel_x = accel_x;
+  record.accel_y = accel_y;
+  record.accel_z = accel_z;
+  record.yaw = yaw;
+  record.pitch = pitch;
+  record.roll = roll;
+  record.setRecording(true);
+  recordsQueued++;
+  
+  if (batchCount >= STREAM_BATCH_RECORDS) {
+    flushBatch();
+  }
+}
+
+void SerialStreamTask::addText(const uint8_t* text, size_t length) {
+  for (size_t i = 0; i < length; i++) {
+    textLine[textLength++] = text[i];
+    if (text[i] == '\n' || textLength >= STREAM_TEXT_MAX) {
+      flushText();
+    }
+  }
+}
+
+void SerialStreamTask::writeStatusJSON(JsonWriter& json) {
+  json.add("streaming", streaming);
+  json.add("baud", baud);
+  json.add("records", recordsQueued);
+  json.add("framesQueued", framesQueued);
+  json.add("framesDropped", framesDropped);
+  json.add("bufferUsed", txUsed);
+}
+
+void SerialStreamTask::start() {
+  baud = settings.serialStreamBaud;
+  debugOutput.print(F("Serial stream starting at "));
+  debugOutput.print(baud);
+  debugOutput.println(F(" baud, debug output follows in text frames"));
+  
+  debugOutput.flush();
+  Serial.updateBaudRate(baud);
+  
+  batchCount = 0;
+  textLength = 0;
+  txHead = 0;
+  txTail = 0;
+  txUsed = 0;
+  sequence = 0;
+  framesQueued = 0;
+  framesDropped = 0;
+  recordsQueued = 0;
+  streaming = true;
+  runInterval = 0;
+}
+
+void SerialStreamTask::stop() {
+  flushBatch();
+  flushText();
+  
+  // Let the host see the last frames before the baud rate changes under it
+  drain(true);
+  Serial.flush();
+  
+  streaming = false;
+  runInterval = 1000;
+  Serial.updateBaudRate(SERIAL_DEBUG_BAUD);
+  
+  debugOutput.print(F("Serial stream stopped: "));
+  debugOutput.print(framesQueued);
+  debugOutput.print(F(" frames, "));
+  debugOutput.print(framesDropped);
+  debugOutput.println(F(" dropped"));
+}
+
+void SerialStreamTask::flushBatch() {
+  if (batchCount == 0) {
+    return;
+  }
+  queueFrame(STREAM_FRAME_SAMPLES, reinterpret_cast<const uint8_t*>(batch),
+             batchCount * sizeof(MPULogRecord));
+  batchCount = 0;
+}
+
+void SerialStreamTask::flushText() {
+  if (textLength == 0) {
+    return;
+  }
+  queueFrame(STREAM_FRAME_TEXT, textLine, textLength);
+  textLength = 0;
+}
+
+bool SerialStreamTask::queueFrame(uint8_t type, const uint8_t* payload, uint16_t length) {
+  StreamFrameHeader header;
+  header.sync = STREAM_FRAME_SYNC;
+  header.type = type;
+  header.reserved = 0;
+  header.sequence = sequence++;
+  header.length = length;
+  framesQueued++;
+  
+  // Drop whole frames only, so the host never has to resynchronise mid-frame
+  uint16_t frameSize = sizeof(header) + length + sizeof(uint16_t);
+  if (STREAM_TX_BUFFER_BYTES - txUsed < frameSize) {
+    framesDropped++;
+    return false;
+  }
+  
+  uint16_t crc = streamFrameCRC(0xFFFF, reinterpret_cast<const uint8_t*>(&header), sizeof(header));
+  crc = streamFrameCRC(crc, payload, length);
+  queueBytes(reinterpret_cast<const uint8_t*>(&header), sizeof(header));
+  queueBytes(payload, length);
+  queueBytes(reinterpret_cast<const uint8_t*>(&crc), sizeof(crc));
+  return true;
+}
+
+void SerialStreamTask::queueBytes(const uint8_t* data, uint16_t length) {
+  for (uint16_t i = 0; i < length; i++) {
+    txBuffer[txHead] = data[i];
+    txHead = (txHead + 1) % STREAM_TX_BUFFER_BYTES;
+  }
+  txUsed += length;
+}
+
+void SerialStreamTask::drain(bool blocking) {
+  // Unless blocking, only write what the UART FIFO can take now; HardwareSerial waits beyond that
+  while (txUsed > 0) {
+    uint16_t chunk = STREAM_TX_BUFFER_BYTES - txTail;
+    if (chunk > txUsed) {
+      chunk = txUsed;
+    }
+    if (!blocking) {
+      int room = Serial.availableForWrite();
+      if (room <= 0) {
+        return;
+      }
+      if (chunk > room) {
+        chunk = room;
+      }
+    }
+    Serial.write(txBuffer + txTail, chunk);
+    txTail = (txTail + chunk) % STREAM_TX_BUFFER_BYTES;
+    txUsed -= chunk;
+  }
+}
@@ -0,0 +1,82 @@
+#ifndef SERIAL_STREAM_TASK_H
+#define SERIAL_STREAM_TASK_H
+
+#include "Task.h"
+#include "MPULogRecord.h"
+#include "StreamFrame.h"
+#include "constants.h"
+#include "JsonWriter.h"
+
+// Forward declaration
+class Settings;
+
+/**
+ * Binary sample streaming over the USB serial port.
+ *
+ * While Settings::serialStreamEnabled is set the UART runs at serialStreamBaud and every
+ * logged sample is sent as an MPULogRecord in CRC-checked frames (see StreamFrame.h), with
+ * debug output from DebugOutput wrapped into text frames between them. Flash is not touched,
+ * so a laptop running tools/serial_capture gets the same .bin records without a recording.
+ *
+ * Frames are queued in a fixed ring and drained only as far as the UART FIFO has room, so a
+ * slow or absent reader never blocks the loop. When the ring is full the new frame is dropped
+ * but its sequence number is still used, and the host sees the gap.
+ */
+class SerialStreamTask : public Task {
+  public:
+    static const uint16_t MASK { SERIAL_STREAM_TASK_MASK };
+    
+    SerialStreamTask(Settings& settings);
+    
+    virtual uint16_t getMask() override {
+      return SerialStreamTask::MASK;
+    }
+    
+    virtual void run() override;
+    
+    bool isStreaming() const;
+    
+    // Called by MPUSensorTask once per logged sample
+    void addSample(float accel_x, float accel_y, float accel_z, float yaw, float pitch, float roll);
+    
+    // Called by DebugOutput while streaming. Text is framed a line at a time.
+    void addText(const uint8_t* text, size_t length);
+    
+    void writeStatusJSON(JsonWriter& json);
+  
+  private:
+    Settings& settings;
+    bool streaming = false;
+    uint32_t baud = 0;
+    
+    // Samples batch being filled
+    MPULogRecord batch[STREAM_BATCH_RECORDS];
+    uint8_t batchCount = 0;
+    unsigned long batchStartMillis = 0;
+    
+    // Debug text line being filled
+    uint8_t textLine[STREAM_TEXT_MAX];
+    uint8_t textLength = 0;
+    
+    // Frames waiting for the UART
+    uint8_t txBuffer[STREAM_TX_BUFFER_BYTES];
+    uint16_t txHead = 0;
+    uint16_t txTail = 0;
+    uint16_t txUsed = 0;
+    
+    // Statistics
+    uint16_t sequence = 0;
+    uint32_t framesQueued = 0;
+    uint32_t framesDropped = 0;
+    uint32_t recordsQueued = 0;
+    
+    void start();
+    void stop();
+    void flushBatch();
+    void flushText();
+    bool queueFrame(uint8_t type, const uint8_t* payload, uint16_t length);
+    void queueBytes(const uint8_t* data, uint16_t length);
+    void drain(bool blocking);
+};
+
+#endif
@@ -1,4 +1,5 @@
 #include "Settings.h"
+#include "DebugOutput.h"
 #include "ArduinoJSON/ArduinoJson-v6.18.3.h"
 
 Settings::Settings() {
@@ -8,7 +9,7 @@ Settings::Settings() {
 bool Settings::readFromFile() {
   File file = SPIFFS.open(configFileName, "r");
   if (!file) {
-    Serial.println(F("Settings file not found, using defaults"));
+    debugOutput.at(LOG_LEVEL_WARN).println(F("Settings file not found, using defaults"));
     setDefaults();
     return false;
   }
@@ -22,36 +23,69 @@ bool Settings::readFromFile() {
 bool Settings::writeToFile() {
   File file = SPIFFS.open(configFileName, "w");
   if (!file) {
-    Serial.println(F("Failed to open settings file for writing"));
+    debugOutput.at(LOG_LEVEL_ERROR).println(F("Failed to open settings file for writing"));
     return false;
   }
   
-  String jsonStr = toJSON();
-  size_t bytesWritten = file.print(jsonStr);
+  DynamicJsonDocument doc(JSON_MEMORY_ALLOC);
+  fillJSON(doc);
+  size_t bytesWritten = serializeJson(doc, file);
   file.close();
   
-  return bytesWritten == jsonStr.length();
+  return bytesWritten == measureJson(doc);
 }
 
 void Settings::setDefaults() {
   strcpy(hostName, "MPULogger");
   sampleRateMs = 100;
+  acquisitionRateHz = ACQUISITION_DEFAULT_RATE_HZ;
+  decimationOrder = DECIMATION_DEFAULT_ORDER;
   maxLogFiles = 10;
   bufferSize = 32;
   autoCalibration = false;
   accelRange = 8.0;
   gyroRange = 500.0;
+  gyroBiasTracking = true;
+  gyroBiasPersist = false;
+  temperatureCompensation = true;
+  spectrumEnabled = false;
+  spectrumSize = SPECTRUM_DEFAULT_SIZE;
+  spectrumRateHz = SPECTRUM_DEFAULT_RATE_HZ;
+  spectrumLogging = false;
+  filterCount = 0;
+  logMode = LOG_MODE_RAW;
+  channelMask = LOG_CHANNELS_ALL;
+  columnarPages = false;
+  pyramidEnabled = true;
+  summaryWindowSec = SUMMARY_DEFAULT_WINDOW_SEC;
+  histogramIntervalMin = HISTOGRAM_DEFAULT_INTERVAL_MIN;
+  deadbandEnabled = false;
+  for (uint8_t i = 0; i < 6; i++) {
+    deadband[i] = i < 3 ? DEADBAND_DEFAULT_ACCEL_G : DEADBAND_DEFAULT_GYRO_DPS;
+  }
+  deadbandHeartbeatMs = DEADBAND_DEFAULT_HEARTBEAT_MS;
+  rainflowEnabled = false;
+  rainflowChannel = 2;
+  rainflowPersistMin = RAINFLOW_DEFAULT_PERSIST_MIN;
+  serialStreamEnabled = false;
+  serialStreamBaud = SERIAL_STREAM_DEFAULT_BAUD;
+  udpStreamEnabled = false;
+  strcpy(udpStreamHost, UDP_STREAM_DEFAULT_HOST);
+  udpStreamPort = UDP_STREAM_DEFAULT_PORT;
+  logLevel = LOG_LEVEL_INFO;
+  debugOutput.setLevel(logLevel);
   
-  Serial.println(F("Settings set to defaults"));
+  debugOutput.println(F("Settings set to defaults"));
 }
 
 bool Settings::applyFromJSON(const String& jsonStr) {
-  StaticJsonDocument<JSON_MEMORY_ALLOC> doc;
+  DynamicJsonDocument doc(JSON_MEMORY_ALLOC);
   
   DeserializationError error = deserializeJson(doc, jsonStr);
   if (error) {
-    Serial.print(F("JSON parse error: "));
-    Serial.println(error.c_str());
+    Print& log = debugOutput.at(LOG_LEVEL_ERROR);
+    log.print(F("JSON parse error: "));
+    log.println(error.c_str());
     return false;
   }
   
@@ -62,6 +96,12 @@ bool Settings::applyFromJSON(const String& jsonStr) {
   if (doc.containsKey("sampleRateMs")) {
     sampleRateMs = doc["sampleRateMs"];
   }
+  if (doc.containsKey("acquisitionRateHz")) {
+    acquisitionRateHz = constrain((int)doc["acquisitionRateHz"], ACQUISITION_MIN_RATE_HZ, ACQUISITION_MAX_RATE_HZ);
+  }
+  if (doc.containsKey("decimationOrder")) {
+    decimationOrder = constrain((int)doc["decimationOrder"], 1, DECIMATION_MAX_ORDER);
+  }
   if (doc.containsKey("maxLogFiles")) {
     maxLogFiles = doc["maxLogFiles"];
   }
@@ -77,25 +117,180 @@ bool Settings::applyFromJSON(const String& jsonStr) {
   if (doc.containsKey("gyroRange")) {
     gyroRange = doc["gyroRange"];
   }
+  if (doc.containsKey("gyroBiasTracking")) {
+    gyroBiasTracking = doc["gyroBiasTracking"];
+  }
+  if (doc.containsKey("gyroBiasPersist")) {
+    gyroBiasPersist = doc["gyroBiasPersist"];
+  }
+  if (doc.containsKey("temperatureCompensation")) {
+    temperatureCompensation = doc["temperatureCompensation"];
+  }
+  if (doc.containsKey("spectrumEnabled")) {
+    spectrumEnabled = doc["spectrumEnabled"];
+  }
+  if (doc.containsKey("spectrumSize")) {
+    uint16_t size = doc["spectrumSize"];
+    if (size == 256 || size == 512 || size == 1024) {
+      spectrumSize = size;
+    }
+  }
+  if (doc.containsKey("spectrumRateHz")) {
+    spectrumRateHz = constrain((int)doc["spectrumRateHz"], SPECTRUM_MIN_RATE_HZ, SPECTRUM_MAX_RATE_HZ);
+  }
+  if (doc.containsKey("spectrumLogging")) {
+    spectrumLogging = doc["spectrumLogging"];
+  }
+  if (doc.containsKey("logMode")) {
+    const char* mode = doc["logMode"] | "";
+    if (strcmp(mode, "summary") == 0) {
+      logMode = LOG_MODE_SUMMARY;
+    } else if (strcmp(mode, "histogram") == 0) {
+      logMode = LOG_MODE_HISTOGRAM;
+    } else if (strcmp(mode, "raw") == 0) {
+      logMode = LOG_MODE_RAW;
+    }
+  }
+  if (doc.containsKey("channelMask")) {
+    // At least one channel; an empty mask means all of them
+    channelMask = (uint8_t)doc["channelMask"] & LOG_CHANNELS_ALL;
+    if (channelMask == 0) {
+      channelMask = LOG_CHANNELS_ALL;
+    }
+  }
+  if (doc.containsKey("columnarPages")) {
+    columnarPages = doc["columnarPages"];
+  }
+  if (doc.containsKey("pyramidEnabled")) {
+    pyramidEnabled = doc["pyramidEnabled"];
+  }
+  if (doc.containsKey("summaryWindowSec")) {
+    summaryWindowSec = constrain((int)doc["summaryWindowSec"], SUMMARY_MIN_WINDOW_SEC, SUMMARY_MAX_WINDOW_SEC);
+  }
+  if (doc.containsKey("histogramIntervalMin")) {
+    histogramIntervalMin = constrain((int)doc["histogramIntervalMin"], HISTOGRAM_MIN_INTERVAL_MIN, HISTOGRAM_MAX_INTERVAL_MIN);
+  }
+  if (doc.containsKey("deadbandEnabled")) {
+    deadbandEnabled = doc["deadbandEnabled"];
+  }
+  if (doc.containsKey("deadband")) {
+    // Accel X/Y/Z then gyro X/Y/Z; a shorter list leaves the remaining thresholds unchanged
+    JsonArray list = doc["deadband"];
+    uint8_t i = 0;
+    for (JsonVariant value : list) {
+      if (i >= 6) {
+        break;
+      }
+      deadband[i++] = fabs(value.as<float>());
+    }
+  }
+  if (doc.containsKey("deadbandHeartbeatMs")) {
+    deadbandHeartbeatMs = doc["deadbandHeartbeatMs"];
+  }
+  if (doc.containsKey("rainflowEnabled")) {
+    rainflowEnabled = doc["rainflowEnabled"];
+  }
+  if (doc.containsKey("rainflowChannel")) {
+    rainflowChannel = constrain((int)doc["rainflowChannel"], 0, 5);
+  }
+  if (doc.containsKey("rainflowPersistMin")) {
+    rainflowPersistMin = constrain((int)doc["rainflowPersistMin"], 1, 255);
+  }
+  if (doc.containsKey("serialStreamEnabled")) {
+    serialStreamEnabled = doc["serialStreamEnabled"];
+  }
+  if (doc.containsKey("serialStreamBaud")) {
+    serialStreamBaud = constrain((uint32_t)doc["serialStreamBaud"], (uint32_t)SERIAL_STREAM_MIN_BAUD, (uint32_t)SERIAL_STREAM_MAX_BAUD);
+  }
+  if (doc.containsKey("udpStreamEnabled")) {
+    udpStreamEnabled = doc["udpStreamEnabled"];
+  }
+  if (doc.containsKey("udpStreamHost")) {
+    strlcpy(udpStreamHost, doc["udpStreamHost"], sizeof(udpStreamHost));
+  }
+  if (doc.containsKey("udpStreamPort")) {
+    udpStreamPort = constrain((int)doc["udpStreamPort"], 1, 65535);
+  }
+  if (doc.containsKey("logLevel")) {
+    logLevel = DebugOutput::levelFromName(doc["logLevel"] | "");
+    debugOutput.setLevel(logLevel);
+  }
+  if (doc.containsKey("filters")) {
+    // The list replaces the whole chain; unknown types are dropped
+    JsonArray list = doc["filters"];
+    filterCount = 0;
+    for (JsonObject item : list) {
+      if (filterCount >= FILTER_MAX_SECTIONS) {
+        break;
+      }
+      FilterSectionConfig& section = filters[filterCount];
+      section.type = BiquadFilter::typeFromName(item["type"]);
+      section.frequencyHz = item["frequencyHz"] | 0.0f;
+      section.q = item["q"] | 0.7071f;
+      section.channelMask = (item["channels"] | FILTER_ALL_CHANNELS) & FILTER_ALL_CHANNELS;
+      if (section.type != FILTER_NONE) {
+        filterCount++;
+      }
+    }
+  }
   
-  Serial.println(F("Settings loaded from JSON"));
+  debugOutput.println(F("Settings loaded from JSON"));
   return true;
 }
 
-String Settings::toJSON() {
-  StaticJsonDocument<JSON_MEMORY_ALLOC> doc;
-  
+size_t Settings::printJSON(Print& out) {
+  DynamicJsonDocument doc(JSON_MEMORY_ALLOC);
+  fillJSON(doc);
+  return serializeJson(doc, out);
+}
+
+void Settings::fillJSON(JsonDocument& doc) {
   doc["hostName"] = hostName;
   doc["sampleRateMs"] = sampleRateMs;
+  doc["acquisitionRateHz"] = acquisitionRateHz;
+  doc["decimationOrder"] = decimationOrder;
   doc["maxLogFiles"] = maxLogFiles;
   doc["bufferSize"] = bufferSize;
   doc["autoCalibration"] = autoCalibration;
   doc["accelRange"] = accelRange;
   doc["gyroRange"] = gyroRange;
+  doc["gyroBiasTracking"] = gyroBiasTracking;
+  doc["gyroBiasPersist"] = gyroBiasPersist;
+  doc["temperatureCompensation"] = temperatureCompensation;
+  doc["spectrumEnabled"] = spectrumEnabled;
+  doc["spectrumSize"] = spectrumSize;
+  doc["spectrumRateHz"] = spectrumRateHz;
+  doc["spectrumLogging"] = spectrumLogging;
+  doc["logMode"] = logMode == LOG_MODE_SUMMARY ? "summary" : logMode == LOG_MODE_HISTOGRAM ? "histogram" : "raw";
+  doc["channelMask"] = channelMask;
+  doc["columnarPages"] = columnarPages;
+  doc["pyramidEnabled"] = pyramidEnabled;
+  doc["summaryWindowSec"] = summaryWindowSec;
+  doc["histogramIntervalMin"] = histogramIntervalMin;
+  doc["deadbandEnabled"] = deadbandEnabled;
+  JsonArray deadbandList = doc.createNestedArray("deadband");
+  for (uint8_t i = 0; i < 6; i++) {
+    deadbandList.add(deadband[i]);
+  }
+  doc["deadbandHeartbeatMs"] = deadbandHeartbeatMs;
+  doc["rainflowEnabled"] = rainflowEnabled;
+  doc["rainflowChannel"] = rainflowChannel;
+  doc["rainflowPersistMin"] = rainflowPersistMin;
+  doc["serialStreamEnabled"] = serialStreamEnabled;
+  doc["serialStreamBaud"] = serialStreamBaud;
+  doc["udpStreamEnabled"] = udpStreamEnabled;
+  doc["udpStreamHost"] = udpStreamHost;
+  doc["udpStreamPort"] = udpStreamPort;
+  doc["logLevel"] = DebugOutput::levelName(logLevel);
   
-  String output;
-  serializeJson(doc, output);
-  return output;
+  JsonArray list = doc.createNestedArray("filters");
+  for (uint8_t i = 0; i < filterCount; i++) {
+    JsonObject item = list.createNestedObject();
+    item["type"] = BiquadFilter::typeName(filters[i].type);
+    item["frequencyHz"] = filters[i].frequencyHz;
+    item["q"] = filters[i].q;
+    item["channels"] = filters[i].channelMask;
+  }
 }
 
 // Calibration storage operations
@@ -107,34 +302,25 @@ bool Settings::loadCalibrationFromEEPROM() {
   }
   
   if (eepromManager.loadCalibrationData(calData)) {
-    Serial.println(F("Calibration data loaded from EEPROM"));
+    debugOutput.println(F("Calibration data loaded from EEPROM"));
     return true;
   }
   
-  Serial.println(F("No valid calibration data found in EEPROM"));
+  debugOutput.println(F("No valid calibration data found in EEPROM"));
   return false;
 }
 
-bool Settings::saveCalibrationToEEPROM(float accelX, float accelY, float accelZ, 
-                                     float gyroX, float gyroY, float gyroZ) {
+bool Settings::saveCalibrationToEEPROM(const CalibrationData& calData) {
   if (!eepromManager.begin()) {
     return false;
   }
   
-  CalibrationData calData = {0};
-  calData.accelOffsetX = accelX;
-  calData.accelOffsetY = accelY;
-  calData.accelOffsetZ = accelZ;
-  calData.gyroOffsetX = gyroX;
-  calData.gyroOffsetY = gyroY;
-  calData.gyroOffsetZ = gyroZ;
-  
   if (eepromManager.saveCalibrationData(calData)) {
-    Serial.println(F("Calibration data saved to EEPROM"));
+    debugOutput.println(F("Calibration data saved to EEPROM"));
     return true;
   }
   
-  Serial.println(F("Failed to save calibration data to EEPROM"));
+  debugOutput.at(LOG_LEVEL_ERROR).println(F("Failed to save calibration data to EEPROM"));
   return false;
 }
 
@@ -147,20 +333,41 @@ bool Settings::isCalibrationDataAvailable() {
   return eepromManager.loadCalibrationData(calData);
 }
 
-void Settings::getCalibrationData(float& accelX, float& accelY, float& accelZ,
-                                float& gyroX, float& gyroY, float& gyroZ) {
-  CalibrationData calData = {0};
-  
+bool Settings::getCalibrationData(CalibrationData& calData) {
   if (eepromManager.begin() && eepromManager.loadCalibrationData(calData)) {
-    accelX = calData.accelOffsetX;
-    accelY = calData.accelOffsetY;
-    accelZ = calData.accelOffsetZ;
-    gyroX = calData.gyroOffsetX;
-    gyroY = calData.gyroOffsetY;
-    gyroZ = calData.gyroOffsetZ;
-  } else {
-    // Return zeros if no valid calibration data
-    accelX = accelY = accelZ = 0.0;
-    gyroX = gyroY = gyroZ = 0.0;
+    return true;
   }
+  
+  // Return zero offsets and unity scale if no valid calibration data
+  calData = CalibrationData();
+  calData.accelScaleX = calData.accelScaleY = calData.accelScaleZ = 1.0;
+  return false;
+}
+
+bool Settings::loadTemperatureCompFromEEPROM(TemperatureCompData& tempData) {
+  if (!eepromManager.begin()) {
+    return false;
+  }
+  
+  if (eepromManager.loadTemperatureCompData(tempData)) {
+    debugOutput.println(F("Temperature compensation loaded from EEPROM"));
+    return true;
+  }
+  
+  debugOutput.println(F("No valid temperature compensation found in EEPROM"));
+  return false;
+}
+
+bool Settings::saveTemperatureCompToEEPROM(const TemperatureCompData& tempData) {
+  if (!eepromManager.begin()) {
+    return false;
+  }
+  
+  if (eepromManager.saveTemperatureCompData(tempData)) {
+    debugOutput.println(F("Temperature compensation saved to EEPROM"));
+    return true;
+  }
+  
+  debugOutput.at(LOG_LEVEL_ERROR).println(F("Failed to save temperature compensation to EEPROM"));
+  return false;
 }
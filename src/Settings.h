@@ -5,16 +5,46 @@
 #include <FS.h>
 #include "ArduinoJSON/ArduinoJson-v6.18.3.h"
 #include "EEPROMManager.h"
+#include "BiquadFilter.h"
 
 class Settings {
   public:
     char hostName[20] = "MPULogger";
-    uint16_t sampleRateMs = 100;        // 10Hz = 100ms
+    uint16_t sampleRateMs = 100;        // Logging interval, 10Hz = 100ms
+    uint16_t acquisitionRateHz = 100;   // Internal sensor read rate, decimated to sampleRateMs
+    uint8_t decimationOrder = 2;        // CIC decimator stages
     uint8_t maxLogFiles = 10;           // Maximum log files to keep
     uint32_t bufferSize = 32;           // Records in RAM buffer
     bool autoCalibration = false;        // Auto-calibrate on startup
     float accelRange = 8.0;             // MPU6050 accelerometer range
     float gyroRange = 500.0;            // MPU6050 gyroscope range
+    bool gyroBiasTracking = true;       // Track gyro bias while stationary
+    bool gyroBiasPersist = false;       // Save the tracked gyro bias to EEPROM
+    bool temperatureCompensation = true; // Apply the fitted temperature bias model
+    bool spectrumEnabled = false;       // Acquire vibration spectra
+    uint16_t spectrumSize = 256;        // FFT frame size: 256, 512 or 1024
+    uint16_t spectrumRateHz = 200;      // Spectrum acquisition rate
+    bool spectrumLogging = false;       // Write spectra to a sidecar while recording
+    FilterSectionConfig filters[FILTER_MAX_SECTIONS];  // Biquad chain applied before logging and streaming
+    uint8_t filterCount = 0;
+    uint8_t logMode = LOG_MODE_RAW;     // LOG_MODE_RAW or LOG_MODE_SUMMARY
+    uint8_t channelMask = 0x3F;         // Channels logged in raw mode and streamed (bits 0-2 accel, 3-5 gyro)
+    bool columnarPages = false;         // Raw mode writes each flash page as per-field blocks
+    bool pyramidEnabled = true;         // Raw mode writes min/max pyramid sidecars
+    uint8_t summaryWindowSec = 10;      // Summary mode window length
+    uint8_t histogramIntervalMin = 10;  // Histogram mode snapshot interval
+    bool deadbandEnabled = false;       // Raw mode: only log samples that moved beyond deadband
+    float deadband[6] = { 0.02f, 0.02f, 0.02f, 1.0f, 1.0f, 1.0f };  // Accel X/Y/Z in G, gyro X/Y/Z in deg/s
+    uint32_t deadbandHeartbeatMs = 10000;  // Longest gap between deadband records
+    bool rainflowEnabled = false;       // Count fatigue cycles on rainflowChannel
+    uint8_t rainflowChannel = 2;        // 0-2 accel X/Y/Z, 3-5 gyro X/Y/Z
+    uint8_t rainflowPersistMin = 10;    // Save the cycle matrix to flash this often
+    bool serialStreamEnabled = false;   // Stream framed binary samples over USB serial
+    uint32_t serialStreamBaud = 921600; // UART rate while streaming
+    bool udpStreamEnabled = false;      // Send sample batches to udpStreamHost over UDP
+    char udpStreamHost[16] = UDP_STREAM_DEFAULT_HOST;  // Collector IPv4 address
+    uint16_t udpStreamPort = UDP_STREAM_DEFAULT_PORT;
+    uint8_t logLevel = LOG_LEVEL_INFO;  // Debug output level, LOG_LEVEL_ERROR to LOG_LEVEL_DEBUG
     
     // Constructor
     Settings();
@@ -25,21 +55,24 @@ class Settings {
     
     // Configuration helpers
     void setDefaults();
+    bool applyFromJSON(const String& jsonStr);
+    size_t printJSON(Print& out);
     
     // Calibration storage operations
     bool loadCalibrationFromEEPROM();
-    bool saveCalibrationToEEPROM(float accelX, float accelY, float accelZ, 
-                                 float gyroX, float gyroY, float gyroZ);
+    bool saveCalibrationToEEPROM(const CalibrationData& calData);
     bool isCalibrationDataAvailable();
-    void getCalibrationData(float& accelX, float& accelY, float& accelZ,
-                           float& gyroX, float& gyroY, float& gyroZ);
+    bool getCalibrationData(CalibrationData& calData);
+    bool loadTemperatureCompFromEEPROM(TemperatureCompData& tempData);
+    bool saveTemperatureCompToEEPROM(const TemperatureCompData& tempData);
+    
+    // Heap allocated; the filter list outgrew 1KB on the stack. Also bounds POST /api/settings bodies.
+    static const unsigned int JSON_MEMORY_ALLOC = 2048;
     
   private:
-    static const unsigned int JSON_MEMORY_ALLOC = 1024;
-    const char* configFileName = "/settings.json";
+    void fillJSON(JsonDocument& doc);
     
-    bool applyFromJSON(const String& jsonStr);
-    String toJSON();
+    const char* configFileName = "/settings.json";
     
     // EEPROM manager instance
     EEPROMManager eepromManager;
@@ -0,0 +1,337 @@
+#include "SpectrumTask.h"
+#include "DebugOutput.h"
+#include "FixedFFT.h"
+#include "Settings.h"
+#include "MPUSensorTask.h"
+#include "DataLoggingTask.h"
+#include "WebStreamingTask.h"
+#include "TestDataGenerator.h"
+
+SpectrumTask::SpectrumTask(Settings& settings, MPUSensorTask& mpuSensor, DataLoggingTask& dataLogger,
+                           WebStreamingTask& webStreaming)
+  : Task(),
+    settings(settings),
+    mpuSensor(mpuSensor),
+    dataLogger(dataLogger),
+    webStreaming(webStreaming) {
+  runInterval = 500;  // Poll settings while idle, run every loop while acquiring
+}
+
+void SpectrumTask::run() {
+  if (!settings.spectrumEnabled) {
+    if (state != SPECTRUM_IDLE) {
+      stop();
+    }
+    allocationFailed = false;
+    return;
+  }
+  
+  // (Re)configure when enabled or when the frame size or rate changed
+  bool configChanged = frameSize != settings.spectrumSize || sampleRateHz != settings.spectrumRateHz;
+  if (state == SPECTRUM_IDLE || configChanged) {
+    if (state == SPECTRUM_IDLE && allocationFailed && !configChanged) {
+      return;
+    }
+    stop();
+    allocationFailed = !start();
+    return;
+  }
+  
+  if (state == SPECTRUM_ACQUIRING) {
+    acquire();
+  } else {
+    processNextAxis();
+  }
+}
+
+void SpectrumTask::inhibited() {
+  // Any partial frame now has a gap in it
+  if (state == SPECTRUM_ACQUIRING && sampleCount > 0) {
+    restartFrame();
+  }
+}
+
+bool SpectrumTask::isActive() const {
+  return state != SPECTRUM_IDLE;
+}
+
+bool SpectrumTask::start() {
+  frameSize = settings.spectrumSize;
+  sampleRateHz = settings.spectrumRateHz;
+  if (!FixedFFT::isValidSize(frameSize) || sampleRateHz == 0) {
+    debugOutput.at(LOG_LEVEL_ERROR).println(F("Spectrum: invalid frame size or rate"));
+    return false;
+  }
+  
+  samples = (int16_t*)malloc(3 * frameSize * sizeof(int16_t));
+  work = (int16_t*)malloc(2 * frameSize * sizeof(int16_t));
+  spectrum = (uint16_t*)malloc(3 * (frameSize / 2) * sizeof(uint16_t));
+  if (samples == nullptr || work == nullptr || spectrum == nullptr) {
+    debugOutput.at(LOG_LEVEL_ERROR).println(F("Spectrum: not enough heap for frame buffers"));
+    stop();
+    return false;
+  }
+  
+  samplePeriodMicros = 1000000UL / sampleRateHz;
+  frameCount = 0;
+  droppedFrames = 0;
+  mpuSensor.setFilterBandwidth(SPECTRUM_BANDWIDTH);
+  
+  state = SPECTRUM_ACQUIRING;
+  runInterval = 0;
+  restartFrame();
+  
+  debugOutput.print(F("Spectrum mode: "));
+  debugOutput.print(frameSize);
+  debugOutput.print(F(" samples at "));
+  debugOutput.print(sampleRateHz);
+  debugOutput.println(F("Hz"));
+  return true;
+}
+
+void SpectrumTask::stop() {
+  if (state != SPECTRUM_IDLE) {
+    mpuSensor.setFilterBandwidth(MPU6050_BANDWIDTH);
+    debugOutput.println(F("Spectrum mode stopped"));
+  }
+  
+  free(samples);
+  free(work);
+  free(spectrum);
+  samples = nullptr;
+  work = nullptr;
+  spectrum = nullptr;
+  
+  state = SPECTRUM_IDLE;
+  runInterval = 500;
+}
+
+void SpectrumTask::restartFrame() {
+  sampleCount = 0;
+  nextSampleMicros = micros();
+  frameStartMillis = millis();
+}
+
+void SpectrumTask::acquire() {
+  int16_t accel[3];
+  int16_t gyro[3];
+  int16_t temperature;
+  
+  uint32_t now = micros();
+  while ((int32_t)(now - nextSampleMicros) >= 0 && sampleCount < frameSize) {
+    // A stalled loop would leave a gap in the frame; start over instead
+    if (sampleCount > 0 && now - nextSampleMicros > 2 * samplePeriodMicros) {
+      droppedFrames++;
+      restartFrame();
+    }
+    
+    if (!mpuSensor.readRawSample(accel, gyro, temperature)) {
+      return;
+    }
+    samples[sampleCount] = accel[0];
+    samples[frameSize + sampleCount] = accel[1];
+    samples[2 * frameSize + sampleCount] = accel[2];
+    sampleCount++;
+    
+    nextSampleMicros += samplePeriodMicros;
+    now = micros();
+  }
+  
+  if (sampleCount >= frameSize) {
+    state = SPECTRUM_PROCESSING;
+    processAxisIndex = 0;
+    processMicros = 0;
+  }
+}
+
+void SpectrumTask::processNextAxis() {
+  // One axis per run() keeps each slice of FFT work short
+  uint32_t startMicros = micros();
+  processAxis(samples + processAxisIndex * frameSize, frameSize, work,
+              spectrum + processAxisIndex * (frameSize / 2));
+  processMicros += micros() - startMicros;
+  
+  if (++processAxisIndex >= 3) {
+    lastProcessMicros = processMicros;
+    publish();
+    state = SPECTRUM_ACQUIRING;
+    restartFrame();
+  }
+}
+
+void SpectrumTask::processAxis(const int16_t* samples, uint16_t n, int16_t* work, uint16_t* out) {
+  int16_t* re = work;
+  int16_t* im = work + n;
+  
+  // Remove the mean so gravity does not leak into the low bins
+  int32_t sum = 0;
+  for (uint16_t i = 0; i < n; i++) {
+    sum += samples[i];
+  }
+  int16_t mean = sum / n;
+  for (uint16_t i = 0; i < n; i++) {
+    re[i] = samples[i] - mean;
+    im[i] = 0;
+  }
+  
+  FixedFFT::applyHannWindow(re, n);
+  int8_t exponent = FixedFFT::normalize(re, n);
+  exponent += FixedFFT::transform(re, im, n);
+  FixedFFT::magnitude(re, im, out, n);
+  
+  // Single-sided amplitude = |X| * 2^exponent * 2 / (n * 0.5 Hann gain), then counts to milli-G
+  int8_t log2n = 0;
+  while ((1U << log2n) < n) {
+    log2n++;
+  }
+  int8_t shift = exponent + 2 - log2n;
+  const uint32_t countsPerG = (uint32_t)MPU6050_ACCEL_LSB_PER_G;
+  
+  for (uint16_t k = 0; k < n / 2; k++) {
+    uint64_t value = (uint64_t)out[k] * 1000;
+    value = shift >= 0 ? value << shift : value >> -shift;
+    value /= countsPerG;
+    out[k] = value > 0xFFFF ? 0xFFFF : (uint16_t)value;
+  }
+}
+
+void SpectrumTask::publish() {
+  frameCount++;
+  lastFrameMillis = millis();
+  
+  if (webStreaming.getConnectedClients() > 0) {
+    JsonWriter json(webStreaming.beginMessage());
+    json.beginObject();
+    writeSpectrumJSON(json, SPECTRUM_SSE_MAX_BINS);
+    json.endObject();
+    webStreaming.broadcastMessage("spectrum");
+  }
+  
+  if (settings.spectrumLogging && dataLogger.isRecording()) {
+    MPUSpectrumHeader header;
+    header.timestamp = frameStartMillis;
+    header.sampleRateHz = sampleRateHz;
+    header.frameSize = frameSize;
+    header.binCount = frameSize / 2;
+    header.axisCount = 3;
+    header.reserved = 0;
+    dataLogger.logSpectrum(header, spectrum);
+  }
+}
+
+void SpectrumTask::writeSpectrumJSON(JsonWriter& json, uint16_t maxBins) {
+  const uint16_t bins = frameSize / 2;
+  const uint16_t groupSize = (bins + maxBins - 1) / maxBins;
+  const uint16_t outputBins = (bins + groupSize - 1) / groupSize;
+  
+  json.add("timestamp", frameStartMillis);
+  json.add("sampleRate", sampleRateHz);
+  json.add("size", frameSize);
+  json.add("binHz", (float)sampleRateHz * groupSize / frameSize, 3);
+  json.add("units", F("mg"));
+  writeBins(json, "x", spectrum, groupSize, outputBins);
+  writeBins(json, "y", spectrum + bins, groupSize, outputBins);
+  writeBins(json, "z", spectrum + 2 * bins, groupSize, outputBins);
+}
+
+void SpectrumTask::writeBins(JsonWriter& json, const char* key, const uint16_t* bins, uint16_t groupSize,
+                             uint16_t outputBins) {
+  // Peak-hold within each group so narrow lines survive the reduction
+  const uint16_t binCount = frameSize / 2;
+  json.beginArray(key);
+  for (uint16_t j = 0; j < outputBins; j++) {
+    uint16_t peak = 0;
+    for (uint16_t k = j * groupSize; k < (j + 1) * groupSize && k < binCount; k++) {
+      if (bins[k] > peak) {
+        peak = bins[k];
+      }
+    }
+    json.value(peak);
+  }
+  json.endArray();
+}
+
+void SpectrumTask::writeStatusJSON(JsonWriter& json, uint16_t maxBins) {
+  json.add("enabled", settings.spectrumEnabled);
+  json.add("active", isActive());
+  json.add("size", settings.spectrumSize);
+  json.add("sampleRate", settings.spectrumRateHz);
+  json.add("logging", settings.spectrumLogging);
+  json.add("frames", frameCount);
+  json.add("droppedFrames", droppedFrames);
+  json.add("processMicros", lastProcessMicros);
+  
+  // Only a completed frame is reported; during processing the buffer is part old, part new
+  if (state == SPECTRUM_ACQUIRING && frameCount > 0) {
+    json.beginObject("spectrum");
+    writeSpectrumJSON(json, maxBins);
+    json.endObject();
+  } else {
+    json.addNull("spectrum");
+  }
+}
+
+void SpectrumTask::runSelfTest(JsonWriter& json) {
+  const float sampleRate = SPECTRUM_DEFAULT_RATE_HZ;
+  const uint16_t sizes[] = { 256, 512, 1024 };
+  const uint16_t expectedMg = (uint16_t)(SPECTRUM_SELFTEST_AMPLITUDE_G * 1000);
+  
+  json.add("sampleRate", (uint16_t)sampleRate);
+  json.add("frequency", SPECTRUM_SELFTEST_FREQ_HZ, 2);
+  json.add("expectedMg", expectedMg);
+  json.beginArray("results");
+  
+  for (uint8_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+    const uint16_t n = sizes[s];
+    int16_t* input = (int16_t*)malloc(n * sizeof(int16_t));
+    int16_t* fftWork = (int16_t*)malloc(2 * n * sizeof(int16_t));
+    uint16_t* output = (uint16_t*)malloc((n / 2) * sizeof(uint16_t));
+    
+    json.beginObject();
+    json.add("size", n);
+    if (input == nullptr || fftWork == nullptr || output == nullptr) {
+      json.add("error", F("out of memory"));
+    } else {
+      // Known sine on top of 1G, in raw accelerometer counts
+      for (uint16_t i = 0; i < n; i++) {
+        float g = TestDataGenerator::sineWave(i / sampleRate, SPECTRUM_SELFTEST_FREQ_HZ,
+                                              SPECTRUM_SELFTEST_AMPLITUDE_G, 1.0f);
+        input[i] = (int16_t)lroundf(g * MPU6050_ACCEL_LSB_PER_G);
+      }
+      
+      uint32_t startMicros = micros();
+      processAxis(input, n, fftWork, output);
+      uint32_t elapsed = micros() - startMicros;
+      
+      uint16_t peakBin = 1;
+      for (uint16_t k = 1; k < n / 2; k++) {
+        if (output[k] > output[peakBin]) {
+          peakBin = k;
+        }
+      }
+      float errorPercent = 100.0f * ((float)output[peakBin] - expectedMg) / expectedMg;
+      
+      json.add("micros", elapsed);
+      json.add("peakHz", peakBin * sampleRate / n, 3);
+      json.add("peakMg", output[peakBin]);
+      json.add("amplitudeErrorPercent", errorPercent, 2);
+      
+      debugOutput.print(F("Spectrum self-test N="));
+      debugOutput.print(n);
+      debugOutput.print(F(": "));
+      debugOutput.print(elapsed);
+      debugOutput.print(F("us, peak "));
+      debugOutput.print(peakBin * sampleRate / n);
+      debugOutput.print(F("Hz "));
+      debugOutput.print(output[peakBin]);
+      debugOutput.println(F("mg"));
+    }
+    json.endObject();
+    
+    free(input);
+    free(fftWork);
+    free(output);
+  }
+  
+  json.endArray();
+}
@@ -0,0 +1,98 @@
+#ifndef SPECTRUM_TASK_H
+#define SPECTRUM_TASK_H
+
+#include "Task.h"
+#include "MPULogRecord.h"
+#include "constants.h"
+#include "JsonWriter.h"
+
+// Forward declarations
+class Settings;
+class MPUSensorTask;
+class DataLoggingTask;
+class WebStreamingTask;
+
+/**
+ * Vibration spectrum mode.
+ *
+ * While Settings::spectrumEnabled is set, this task samples the accelerometer at
+ * spectrumRateHz into a frame of spectrumSize samples per axis, then transforms one
+ * axis per run() with FixedFFT so the scheduler is never blocked for a whole frame.
+ * Finished spectra (amplitude in milli-G per bin) are published as a "spectrum" SSE
+ * event and, when spectrumLogging is set, appended to the recording's .fft sidecar.
+ *
+ * Frames are not overlapped. If another task stalls the loop for more than two sample
+ * periods the partial frame is discarded rather than transformed with a gap in it.
+ */
+class SpectrumTask : public Task {
+  public:
+    static const uint16_t MASK { SPECTRUM_TASK_MASK };
+    
+    SpectrumTask(Settings& settings, MPUSensorTask& mpuSensor, DataLoggingTask& dataLogger,
+                 WebStreamingTask& webStreaming);
+    
+    virtual uint16_t getMask() override {
+      return SpectrumTask::MASK;
+    }
+    
+    virtual void run() override;
+    virtual void inhibited() override;
+    
+    bool isActive() const;
+    
+    // Status, timing and the latest spectrum peak-held down to maxBins per axis
+    void writeStatusJSON(JsonWriter& json, uint16_t maxBins);
+    
+    // Window, transform and convert one axis of raw accel counts to milli-G amplitudes.
+    // work must hold 2 * n int16 values; out receives n / 2 bins.
+    static void processAxis(const int16_t* samples, uint16_t n, int16_t* work, uint16_t* out);
+    
+    // Accuracy and timing of processAxis() for every frame size using a known sine input
+    static void runSelfTest(JsonWriter& json);
+  
+  private:
+    enum SpectrumState {
+      SPECTRUM_IDLE,
+      SPECTRUM_ACQUIRING,
+      SPECTRUM_PROCESSING
+    };
+    
+    Settings& settings;
+    MPUSensorTask& mpuSensor;
+    DataLoggingTask& dataLogger;
+    WebStreamingTask& webStreaming;
+    
+    SpectrumState state = SPECTRUM_IDLE;
+    uint16_t frameSize = 0;
+    uint16_t sampleRateHz = 0;
+    uint32_t samplePeriodMicros = 0;
+    
+    // Heap buffers, only allocated while spectrum mode is enabled
+    int16_t* samples = nullptr;     // 3 * frameSize raw accel counts, axis-major
+    int16_t* work = nullptr;        // 2 * frameSize FFT real/imaginary work area
+    uint16_t* spectrum = nullptr;   // 3 * frameSize / 2 amplitudes in milli-G
+    
+    uint16_t sampleCount = 0;
+    uint32_t nextSampleMicros = 0;
+    uint32_t frameStartMillis = 0;
+    uint8_t processAxisIndex = 0;
+    uint32_t processMicros = 0;
+    
+    // Statistics
+    uint32_t frameCount = 0;
+    uint32_t droppedFrames = 0;
+    uint32_t lastFrameMillis = 0;
+    uint32_t lastProcessMicros = 0;
+    bool allocationFailed = false;
+    
+    bool start();
+    void stop();
+    void acquire();
+    void processNextAxis();
+    void publish();
+    void restartFrame();
+    void writeSpectrumJSON(JsonWriter& json, uint16_t maxBins);
+    void writeBins(JsonWriter& json, const char* key, const uint16_t* bins, uint16_t groupSize, uint16_t outputBins);
+};
+
+#endif
@@ -0,0 +1,108 @@
+#include "StatusTask.h"
+#include "DebugOutput.h"
+#include "Tasks.h"
+#include "MPULogRecord.h"
+#include <FS.h>
+
+extern float cpuUtilization;
+
+StatusTask::StatusTask(Settings& settings)
+  : Task(),
+    settings(settings) {
+  setName(F("StatusTask"));
+  runInterval = STATUS_REFRESH_MS;
+}
+
+void StatusTask::run() {
+  refresh();
+  
+  if (webStreamingTask.getConnectedClients() > 0) {
+    JsonWriter json(webStreamingTask.beginMessage());
+    json.beginObject();
+    writeStatusJSON(json);
+    json.endObject();
+    webStreamingTask.broadcastMessage("status");
+  }
+}
+
+void StatusTask::noteFlashWrite(size_t bytes) {
+  flashFreeBytes = bytes < flashFreeBytes ? flashFreeBytes - bytes : 0;
+}
+
+void StatusTask::noteFlashChanged() {
+  flashChanged = true;
+}
+
+void StatusTask::refresh() {
+  if (!flashKnown || flashChanged) {
+    readFlashInfo();
+  }
+  
+  freeHeap = ESP.getFreeHeap();
+  maxFreeBlock = ESP.getMaxFreeBlockSize();
+  heapFragmentation = ESP.getHeapFragmentation();
+  connectedClients = WiFi.softAPgetStationNum();
+  
+  IPAddress ip = WiFi.softAPIP();
+  snprintf(apIp, sizeof(apIp), "%u.%u.%u.%u", ip[0], ip[1], ip[2], ip[3]);
+}
+
+void StatusTask::readFlashInfo() {
+  FSInfo fs_info;
+  flashChanged = false;
+  if (SPIFFS.info(fs_info)) {
+    flashFreeBytes = fs_info.totalBytes - fs_info.usedBytes;
+    flashKnown = true;
+  }
+}
+
+void StatusTask::writeStatusJSON(JsonWriter& json) {
+  json.add("uptime", millis());
+  json.add("freeHeap", freeHeap);
+  // Largest allocatable block; falls below freeHeap as the heap fragments over long uptimes
+  json.add("maxFreeBlock", maxFreeBlock);
+  json.add("heapFragmentation", heapFragmentation);
+  json.add("wifiMode", F("AP"));
+  json.add("apIp", apIp);
+  json.add("connectedClients", connectedClients);
+  
+  // Recording time the free flash holds at the current sample rate
+  uint32_t maxRecords = flashFreeBytes / MPULogRecord::getRecordSize();
+  json.add("flashFreeBytes", flashFreeBytes);
+  json.add("recordingDurationRemaining", (uint32_t)((uint64_t)maxRecords * settings.sampleRateMs / 1000));
+  
+  json.add("cpuUtilization", cpuUtilization, 1);
+  
+  // Startup timing: ms from boot until ready to record (0 while still calibrating)
+  json.add("ready", mpusensorTask.isReady());
+  json.add("startupReadyMs", mpusensorTask.getReadyTimeMs());
+  json.add("bootCalibration", mpusensorTask.getBootCalibrationResult());
+  
+  // Acquisition pipeline and the measured decimator cost per input sample
+  json.beginObject("acquisition");
+  json.add("rateHz", mpusensorTask.getAcquisitionRateHz());
+  json.add("decimationRatio", mpusensorTask.getDecimationRatio());
+  json.add("cicOrder", mpusensorTask.getDecimationOrder());
+  json.add("filterMicrosPerSample", mpusensorTask.getFilterMicrosPerSample(), 2);
+  json.endObject();
+  
+  // Raw log write volume; reductionRatio is samples per written record (1 without deadband)
+  uint32_t offered = dataLoggingTask.getSamplesOffered();
+  uint32_t committed = dataLoggingTask.getRecordsCommitted();
+  json.beginObject("logging");
+  json.add("deadband", dataLoggingTask.isDeadbandActive());
+  json.add("samples", offered);
+  json.add("records", committed);
+  json.add("reductionRatio", committed > 0 ? (float)offered / committed : 1.0f, 2);
+  json.endObject();
+  
+  json.beginObject("serialStream");
+  serialStreamTask.writeStatusJSON(json);
+  json.endObject();
+  json.beginObject("udpStream");
+  udpStreamTask.writeStatusJSON(json);
+  json.endObject();
+  json.beginObject("log");
+  debugOutput.writeStatusJSON(json);
+  json.endObject();
+}
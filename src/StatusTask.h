@@ -0,0 +1,58 @@
+#ifndef STATUS_TASK_H
+#define STATUS_TASK_H
+
+#include "Task.h"
+#include "constants.h"
+#include "JsonWriter.h"
+
+// Forward declaration
+class Settings;
+
+/**
+ * Snapshot of the system status, served by GET /api/status and pushed to the dashboard as a
+ * "status" event once a second while a client is connected.
+ *
+ * Heap, CPU and client counts are sampled on each run rather than per request. Free flash is
+ * read with SPIFFS.info() once at start, then reduced by the bytes DataLoggingTask reports as
+ * written; after a log is closed or a file deleted it is read again on the next run, since
+ * SPIFFS reclaims space in whole pages. Serving the status never touches the flash.
+ */
+class StatusTask : public Task {
+  public:
+    static const uint16_t MASK { STATUS_TASK_MASK };
+    
+    StatusTask(Settings& settings);
+    
+    virtual uint16_t getMask() override {
+      return StatusTask::MASK;
+    }
+    
+    virtual void run() override;
+    
+    // Called after data is appended to a file
+    void noteFlashWrite(size_t bytes);
+    
+    // Called after files are closed, created or deleted; free space is re-read on the next run
+    void noteFlashChanged();
+    
+    // Top-level status members, into the open object
+    void writeStatusJSON(JsonWriter& json);
+  
+  private:
+    Settings& settings;
+    
+    // Snapshot
+    bool flashKnown = false;
+    bool flashChanged = false;
+    uint32_t flashFreeBytes = 0;
+    uint32_t freeHeap = 0;
+    uint32_t maxFreeBlock = 0;
+    uint8_t heapFragmentation = 0;
+    uint8_t connectedClients = 0;
+    char apIp[16] = "";
+    
+    void refresh();
+    void readFlashInfo();
+};
+
+#endif
@@ -0,0 +1,67 @@
+#include "StillnessDetector.h"
+
+StillnessDetector::StillnessDetector() {
+  reset();
+}
+
+void StillnessDetector::reset() {
+  for (uint8_t i = 0; i < 3; i++) {
+    gyroMeanQ[i] = 0;
+    gyroVariance[i] = 0;
+  }
+  stillCount = 0;
+  sampleCount = 0;
+}
+
+bool StillnessDetector::update(const int32_t accel[3], const int32_t gyro[3], bool offsetsCalibrated) {
+  // Acceleration magnitude check on squared values to avoid a square root
+  int64_t magnitudeSq = (int64_t)accel[0] * accel[0] + (int64_t)accel[1] * accel[1] + (int64_t)accel[2] * accel[2];
+  const int32_t tolerance = offsetsCalibrated ? STILLNESS_ACCEL_TOLERANCE : 2 * STILLNESS_ACCEL_TOLERANCE;
+  const int64_t lowerG = ACCEL_FIXED_PER_G - tolerance;
+  const int64_t upperG = ACCEL_FIXED_PER_G + tolerance;
+  bool still = magnitudeSq >= lowerG * lowerG && magnitudeSq <= upperG * upperG;
+  
+  for (uint8_t i = 0; i < 3; i++) {
+    // Seed the averages from the first sample so the window does not start at zero
+    if (sampleCount == 0) {
+      gyroMeanQ[i] = gyro[i] << STILLNESS_EMA_SHIFT;
+    }
+    
+    int32_t deviation = gyro[i] - (gyroMeanQ[i] >> STILLNESS_EMA_SHIFT);
+    gyroMeanQ[i] += deviation;
+    
+    uint32_t deviationSq = abs(deviation);
+    if (deviationSq > 0xFFFF) {
+      deviationSq = 0xFFFF;
+    }
+    deviationSq *= deviationSq;
+    gyroVariance[i] += (deviationSq >> STILLNESS_EMA_SHIFT) - (gyroVariance[i] >> STILLNESS_EMA_SHIFT);
+    
+    if (gyroVariance[i] > STILLNESS_GYRO_VARIANCE || (offsetsCalibrated && abs(gyro[i]) > STILLNESS_GYRO_MAX_RATE)) {
+      still = false;
+    }
+  }
+  
+  if (sampleCount < (1 << STILLNESS_EMA_SHIFT)) {
+    sampleCount++;
+    still = false;  // Averages have not settled yet
+  }
+  
+  if (still) {
+    if (stillCount < 0xFFFF) {
+      stillCount++;
+    }
+  } else {
+    stillCount = 0;
+  }
+  
+  return isStill();
+}
+
+bool StillnessDetector::isStill() const {
+  return stillCount >= STILLNESS_MIN_SAMPLES;
+}
+
+uint16_t StillnessDetector::getStillCount() const {
+  return stillCount;
+}
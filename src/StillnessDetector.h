@@ -0,0 +1,32 @@
+#ifndef STILLNESS_DETECTOR_H
+#define STILLNESS_DETECTOR_H
+
+#include <Arduino.h>
+#include "constants.h"
+
+// Detects when the sensor is stationary from calibrated fixed-point samples.
+// Still means: acceleration magnitude near 1G, gyro rates near zero and low gyro
+// variance, held for STILLNESS_MIN_SAMPLES consecutive samples. Mean and variance
+// are exponential moving averages, so memory and per-sample cost are constant.
+class StillnessDetector {
+  public:
+    StillnessDetector();
+    
+    void reset();
+    
+    // Feed one sample (ACCEL_FIXED_PER_G / GYRO_FIXED_PER_DPS units). Returns isStill().
+    // Without calibrated offsets the gyro rate check is skipped and the 1G tolerance doubled,
+    // since an uncorrected bias alone can exceed those limits.
+    bool update(const int32_t accel[3], const int32_t gyro[3], bool offsetsCalibrated = true);
+    
+    bool isStill() const;
+    uint16_t getStillCount() const;
+    
+  private:
+    int32_t gyroMeanQ[3];        // EMA of gyro rate, fixed units << STILLNESS_EMA_SHIFT
+    uint32_t gyroVariance[3];    // EMA of squared deviation, fixed units^2
+    uint16_t stillCount;
+    uint16_t sampleCount;
+};
+
+#endif
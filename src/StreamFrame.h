@@ -0,0 +1,31 @@
+#ifndef STREAM_FRAME_H
+#define STREAM_FRAME_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "constants.h"
+
+// Frame of the binary serial stream, shared by SerialStreamTask and tools/serial_capture.cpp.
+// Each frame is this header, length payload bytes and a little-endian CRC-16/CCITT of the
+// header and payload. sequence counts every frame the device queued, including ones it had
+// to drop, so a gap on the host means frames were lost on either side of the cable.
+struct __attribute__((packed)) StreamFrameHeader {
+  uint16_t sync;            // STREAM_FRAME_SYNC (2 bytes)
+  uint8_t type;             // STREAM_FRAME_SAMPLES or STREAM_FRAME_TEXT (1 byte)
+  uint8_t reserved;         // Zero (1 byte)
+  uint16_t sequence;        // Frame number, wraps at 65536 (2 bytes)
+  uint16_t length;          // Payload bytes, at most STREAM_MAX_PAYLOAD (2 bytes)
+};
+
+// CRC-16/CCITT-FALSE (poly 0x1021), pass 0xFFFF to start and the previous result to continue
+inline uint16_t streamFrameCRC(uint16_t crc, const uint8_t* data, size_t length) {
+  while (length--) {
+    crc ^= (uint16_t)(*data++) << 8;
+    for (uint8_t bit = 0; bit < 8; bit++) {
+      crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+    }
+  }
+  return crc;
+}
+
+#endif
@@ -0,0 +1,79 @@
+#include "SummaryStatistics.h"
+
+SummaryStatistics::SummaryStatistics() {
+  reset(0);
+}
+
+void SummaryStatistics::reset(uint32_t startMillis) {
+  this->startMillis = startMillis;
+  sampleCount = 0;
+  for (uint8_t i = 0; i < CHANNELS; i++) {
+    minimum[i] = INT32_MAX;
+    maximum[i] = INT32_MIN;
+    sum[i] = 0;
+    sumSquares[i] = 0;
+  }
+}
+
+void SummaryStatistics::add(const SensorSample& sample) {
+  // A full window is at most 60s at 500Hz, but never let the count wrap
+  if (sampleCount == UINT16_MAX) {
+    return;
+  }
+  
+  const int32_t values[CHANNELS] = { sample.accel[0], sample.accel[1], sample.accel[2],
+                                     sample.gyro[0], sample.gyro[1], sample.gyro[2] };
+  for (uint8_t i = 0; i < CHANNELS; i++) {
+    int32_t value = values[i];
+    if (value < minimum[i]) {
+      minimum[i] = value;
+    }
+    if (value > maximum[i]) {
+      maximum[i] = value;
+    }
+    sum[i] += value;
+    sumSquares[i] += (uint64_t)((int64_t)value * value);
+  }
+  sampleCount++;
+}
+
+uint32_t SummaryStatistics::getStartMillis() const {
+  return startMillis;
+}
+
+uint16_t SummaryStatistics::getSampleCount() const {
+  return sampleCount;
+}
+
+void SummaryStatistics::toRecord(MPUSummaryRecord& record) const {
+  record.timestamp = startMillis;
+  record.sampleCount = sampleCount;
+  record.flags = 0;
+  
+  for (uint8_t i = 0; i < CHANNELS; i++) {
+    MPUSummaryChannel& channel = record.channels[i];
+    if (sampleCount == 0) {
+      channel.minimum = channel.maximum = channel.mean = 0;
+      channel.rms = 0;
+      continue;
+    }
+    
+    channel.minimum = toRecordUnits(minimum[i]);
+    channel.maximum = toRecordUnits(maximum[i]);
+    
+    // Round the mean to nearest rather than towards zero
+    int64_t halfCount = sum[i] >= 0 ? sampleCount / 2 : -(int64_t)(sampleCount / 2);
+    channel.mean = toRecordUnits((int32_t)((sum[i] + halfCount) / sampleCount));
+    
+    // One square root per channel per window, so float is fine here
+    float rms = sqrtf((float)sumSquares[i] / sampleCount) / SUMMARY_FIXED_PER_UNIT;
+    channel.rms = (uint16_t)constrain(lroundf(rms), 0L, (long)UINT16_MAX);
+  }
+}
+
+// Fixed-point sample units (0.1 mG, 0.01 deg/s) to record units (mG, 0.1 deg/s), saturated
+int16_t SummaryStatistics::toRecordUnits(int32_t value) {
+  int32_t half = value >= 0 ? SUMMARY_FIXED_PER_UNIT / 2 : -(SUMMARY_FIXED_PER_UNIT / 2);
+  int32_t scaled = (value + half) / SUMMARY_FIXED_PER_UNIT;
+  return (int16_t)constrain(scaled, (int32_t)INT16_MIN, (int32_t)INT16_MAX);
+}
@@ -0,0 +1,37 @@
+#ifndef SUMMARY_STATISTICS_H
+#define SUMMARY_STATISTICS_H
+
+#include <Arduino.h>
+#include "MPULogRecord.h"
+#include "SensorSample.h"
+#include "constants.h"
+
+// Incremental per-channel statistics over one summary window. Every full-rate sample
+// updates a running min, max, sum and sum of squares, so memory and per-sample cost are
+// constant however long the window is. toRecord() reduces them to an MPUSummaryRecord.
+class SummaryStatistics {
+  public:
+    static const uint8_t CHANNELS = 6;  // Accel X/Y/Z, gyro X/Y/Z
+    
+    SummaryStatistics();
+    
+    void reset(uint32_t startMillis);
+    void add(const SensorSample& sample);
+    
+    uint32_t getStartMillis() const;
+    uint16_t getSampleCount() const;
+    
+    void toRecord(MPUSummaryRecord& record) const;
+    
+  private:
+    uint32_t startMillis;
+    uint16_t sampleCount;
+    int32_t minimum[CHANNELS];
+    int32_t maximum[CHANNELS];
+    int64_t sum[CHANNELS];
+    uint64_t sumSquares[CHANNELS];
+    
+    static int16_t toRecordUnits(int32_t value);
+};
+
+#endif
@@ -0,0 +1,142 @@
+#include "TarArchive.h"
+
+// ustar header field offsets and widths
+static const uint16_t TAR_NAME = 0;
+static const uint8_t TAR_NAME_WIDTH = 100;
+static const uint16_t TAR_MODE = 100;
+static const uint16_t TAR_UID = 108;
+static const uint16_t TAR_GID = 116;
+static const uint16_t TAR_SIZE = 124;
+static const uint16_t TAR_MTIME = 136;
+static const uint16_t TAR_CHECKSUM = 148;
+static const uint16_t TAR_TYPE = 156;
+static const uint16_t TAR_MAGIC = 257;
+
+TarArchive::TarArchive(const String& fileNames)
+  : fileNames(fileNames) {
+}
+
+size_t TarArchive::fill(uint8_t* out, size_t maxLen) {
+  size_t written = 0;
+  while (written < maxLen) {
+    size_t room = maxLen - written;
+    
+    if (blockPosition < blockLength) {
+      size_t count = blockLength - blockPosition;
+      if (count > room) {
+        count = room;
+      }
+      memcpy(out + written, block + blockPosition, count);
+      blockPosition += count;
+      written += count;
+    } else if (dataRemaining > 0) {
+      size_t count = dataRemaining < room ? dataRemaining : room;
+      size_t length = file.read(out + written, count);
+      if (length == 0) {
+        // The file got shorter; the header has promised the rest
+        memset(out + written, 0, count);
+        length = count;
+      }
+      dataRemaining -= length;
+      written += length;
+    } else if (!nextBlock()) {
+      break;
+    }
+  }
+  return written;
+}
+
+uint16_t TarArchive::getFileCount() const {
+  return fileCount;
+}
+
+// Loads the block after the current file: its padding, the next header or an end block
+bool TarArchive::nextBlock() {
+  blockPosition = 0;
+  
+  if (file) {
+    file.close();
+    if (padding > 0) {
+      memset(block, 0, padding);
+      blockLength = padding;
+      padding = 0;
+      return true;
+    }
+  }
+  
+  if (openNextFile()) {
+    return true;
+  }
+  
+  if (endBlocks > 0) {
+    endBlocks--;
+    memset(block, 0, BLOCK_SIZE);
+    blockLength = BLOCK_SIZE;
+    return true;
+  }
+  
+  blockLength = 0;
+  return false;
+}
+
+bool TarArchive::openNextFile() {
+  while (nextName < (int)fileNames.length()) {
+    int end = fileNames.indexOf(',', nextName);
+    if (end < 0) {
+      end = fileNames.length();
+    }
+    String name = fileNames.substring(nextName, end);
+    nextName = end + 1;
+    
+    file = SPIFFS.open(name, "r");
+    if (!file) {
+      continue;
+    }
+    
+    dataRemaining = file.size();
+    padding = (BLOCK_SIZE - dataRemaining % BLOCK_SIZE) % BLOCK_SIZE;
+    writeHeader(name, dataRemaining);
+    fileCount++;
+    return true;
+  }
+  return false;
+}
+
+void TarArchive::writeHeader(const String& name, uint32_t size) {
+  memset(block, 0, BLOCK_SIZE);
+  char* header = reinterpret_cast<char*>(block);
+  
+  // Stored without the leading slash, so the files extract into the current directory
+  const char* path = name.c_str();
+  if (*path == '/') {
+    path++;
+  }
+  strncpy(header + TAR_NAME, path, TAR_NAME_WIDTH);
+  
+  writeOctal(header + TAR_MODE, 8, 0644);
+  writeOctal(header + TAR_UID, 8, 0);
+  writeOctal(header + TAR_GID, 8, 0);
+  writeOctal(header + TAR_SIZE, 12, size);
+  writeOctal(header + TAR_MTIME, 12, 0);
+  header[TAR_TYPE] = '0';
+  memcpy(header + TAR_MAGIC, "ustar\0" "00", 8);
+  
+  // The checksum is summed with its own field as spaces
+  memset(header + TAR_CHECKSUM, ' ', 8);
+  uint32_t checksum = 0;
+  for (uint16_t i = 0; i < BLOCK_SIZE; i++) {
+    checksum += block[i];
+  }
+  writeOctal(header + TAR_CHECKSUM, 7, checksum);
+  
+  blockLength = BLOCK_SIZE;
+}
+
+// Zero-padded octal in width - 1 digits and a terminating NUL
+void TarArchive::writeOctal(char* field, uint8_t width, uint32_t value) {
+  field[width - 1] = '\0';
+  for (int8_t i = width - 2; i >= 0; i--) {
+    field[i] = '0' + (value & 7);
+    value >>= 3;
+  }
+}
@@ -0,0 +1,48 @@
+#ifndef TAR_ARCHIVE_H
+#define TAR_ARCHIVE_H
+
+#include <Arduino.h>
+#include <FS.h>
+
+// Streams SPIFFS files as one uncompressed ustar archive for GET /api/archive, a response chunk
+// at a time. File data is read straight into the response buffer, one file after another; the
+// only buffer of its own is a single tar block, reused for each header, the padding after each
+// file and the two end blocks. Nothing is ever loaded whole, however large the files.
+//
+// Each file's size is taken when its header is written, so a log that is still being recorded
+// is archived as it was at that point. A file deleted before it is reached is left out, and one
+// that gets shorter while being read is padded with zeros to the size in its header.
+class TarArchive {
+  public:
+    static const uint16_t BLOCK_SIZE = 512;
+    
+    // fileNames: absolute SPIFFS paths, each followed by a comma
+    TarArchive(const String& fileNames);
+    
+    // Writes up to maxLen bytes of the archive to out. Only returns 0 once it is complete.
+    size_t fill(uint8_t* out, size_t maxLen);
+    
+    uint16_t getFileCount() const;
+  
+  private:
+    String fileNames;
+    int nextName = 0;               // Offset in fileNames of the next file
+    uint16_t fileCount = 0;
+    
+    File file;
+    uint32_t dataRemaining = 0;     // Bytes of the current file still to send
+    uint16_t padding = 0;           // Zeros after the current file, to a whole block
+    uint8_t endBlocks = 2;          // Zero blocks still to send once all files are done
+    
+    uint8_t block[BLOCK_SIZE];
+    uint16_t blockLength = 0;
+    uint16_t blockPosition = 0;
+    
+    bool nextBlock();
+    bool openNextFile();
+    void writeHeader(const String& name, uint32_t size);
+    
+    static void writeOctal(char* field, uint8_t width, uint32_t value);
+};
+
+#endif
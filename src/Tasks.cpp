@@ -4,6 +4,7 @@
 #include "ButtonControlTask.h"
 #include "BuzzerFeedbackTask.h"
 #include "TestDataGenerator.h"
+#include "DebugOutput.h"
 
 // Task instances with dependency injection
 extern Settings settings;
@@ -15,11 +16,22 @@ DataLoggingTask dataLoggingTask(settings);
 ButtonControlTask buttonControlTask(dataLoggingTask, buzzerFeedbackTask, mpusensorTask);
 WebServerTask webServerTask(settings);
 WebStreamingTask webStreamingTask(mpusensorTask, dataLoggingTask);
+SpectrumTask spectrumTask(settings, mpusensorTask, dataLoggingTask, webStreamingTask);
+RainflowTask rainflowTask(settings);
+SerialStreamTask serialStreamTask(settings);
+UdpStreamTask udpStreamTask(settings);
+StatusTask statusTask(settings);
+CommandTask commandTask;
 
 // Set up circular dependency after construction
 void setupTaskDependencies() {
   mpusensorTask.setDataLoggingTask(&dataLoggingTask);
   mpusensorTask.setBuzzerFeedbackTask(&buzzerFeedbackTask);
+  mpusensorTask.setRainflowTask(&rainflowTask);
+  mpusensorTask.setSerialStreamTask(&serialStreamTask);
+  mpusensorTask.setUdpStreamTask(&udpStreamTask);
+  dataLoggingTask.setStatusTask(&statusTask);
+  debugOutput.setSerialStreamTask(&serialStreamTask);
   
   // Set up web streaming with web server
   webStreamingTask.setupEventSource(&webServerTask.server);
@@ -32,7 +44,13 @@ Task* taskList[] = {
     &buzzerFeedbackTask,
     &dataLoggingTask,
     &webServerTask,
-    &webStreamingTask
+    &webStreamingTask,
+    &spectrumTask,
+    &rainflowTask,
+    &serialStreamTask,
+    &udpStreamTask,
+    &statusTask,
+    &commandTask
 };
 
 // Compile-time task count using sizeof()
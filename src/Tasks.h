@@ -9,6 +9,12 @@
 #include "DataLoggingTask.h"
 #include "WebServerTask.h"
 #include "WebStreamingTask.h"
+#include "SpectrumTask.h"
+#include "RainflowTask.h"
+#include "SerialStreamTask.h"
+#include "UdpStreamTask.h"
+#include "StatusTask.h"
+#include "CommandTask.h"
 
 // Global task instances - accessible from anywhere
 extern MPUSensorTask mpusensorTask;
@@ -17,6 +23,12 @@ extern BuzzerFeedbackTask buzzerFeedbackTask;
 extern DataLoggingTask dataLoggingTask;
 extern WebServerTask webServerTask;
 extern WebStreamingTask webStreamingTask;
+extern SpectrumTask spectrumTask;
+extern RainflowTask rainflowTask;
+extern SerialStreamTask serialStreamTask;
+extern UdpStreamTask udpStreamTask;
+extern StatusTask statusTask;
+extern CommandTask commandTask;
 
 // Global task array and count - accessible from main loop()
 extern Task* taskList[];
@@ -0,0 +1,177 @@
+#include "TemperatureModel.h"
+
+TemperatureModel::TemperatureModel() {
+  clear();
+}
+
+void TemperatureModel::clear() {
+  data = TemperatureCompData();
+  data.magicNumber = EEPROM_TEMPCOMP_MAGIC_NUMBER;
+  data.version = EEPROM_TEMPCOMP_VERSION;
+}
+
+void TemperatureModel::load(const TemperatureCompData& stored) {
+  data = stored;
+}
+
+const TemperatureCompData& TemperatureModel::getData() const {
+  return data;
+}
+
+void TemperatureModel::addPoint(float temperature, const float bias[TEMPCOMP_CHANNELS]) {
+  // Replace a point at nearly the same temperature; when full, replace the nearest point
+  // so the stored set keeps its temperature spread
+  uint8_t slot = data.pointCount;
+  float nearestDistance = 1e9;
+  for (uint8_t i = 0; i < data.pointCount; i++) {
+    float distance = fabs(data.pointTemp[i] - temperature);
+    if (distance < nearestDistance) {
+      nearestDistance = distance;
+      if (distance < TEMPCOMP_MERGE_C || data.pointCount >= TEMPCOMP_MAX_POINTS) {
+        slot = i;
+      }
+    }
+  }
+  
+  if (slot == data.pointCount) {
+    data.pointCount++;
+  }
+  
+  data.pointTemp[slot] = temperature;
+  for (uint8_t channel = 0; channel < TEMPCOMP_CHANNELS; channel++) {
+    data.pointBias[slot][channel] = bias[channel];
+  }
+  
+  fit();
+}
+
+bool TemperatureModel::fit() {
+  data.order = 0;
+  data.flags &= ~EEPROM_TEMPCOMP_FLAG_FITTED;
+  
+  if (data.pointCount < 2) {
+    return false;
+  }
+  
+  float minTemp = data.pointTemp[0];
+  float maxTemp = data.pointTemp[0];
+  float sumTemp = 0;
+  for (uint8_t i = 0; i < data.pointCount; i++) {
+    minTemp = min(minTemp, data.pointTemp[i]);
+    maxTemp = max(maxTemp, data.pointTemp[i]);
+    sumTemp += data.pointTemp[i];
+  }
+  
+  float span = maxTemp - minTemp;
+  if (span < TEMPCOMP_MIN_SPAN_C) {
+    return false;
+  }
+  
+  uint8_t order = (data.pointCount >= 4 && span >= TEMPCOMP_QUADRATIC_SPAN_C) ? 2 : 1;
+  uint8_t size = order + 1;
+  
+  // Centre on the mean temperature to keep the normal equations well conditioned
+  data.referenceTemp = sumTemp / data.pointCount;
+  
+  for (uint8_t channel = 0; channel < TEMPCOMP_CHANNELS; channel++) {
+    // Normal equations: sum(dT^(i+j)) * c_j = sum(bias * dT^i)
+    float matrix[TEMPCOMP_COEFFS][TEMPCOMP_COEFFS + 1] = {};
+    for (uint8_t p = 0; p < data.pointCount; p++) {
+      float dT = data.pointTemp[p] - data.referenceTemp;
+      float powers[2 * TEMPCOMP_COEFFS - 1];
+      powers[0] = 1;
+      for (uint8_t k = 1; k < 2 * size - 1; k++) {
+        powers[k] = powers[k - 1] * dT;
+      }
+      
+      for (uint8_t row = 0; row < size; row++) {
+        for (uint8_t col = 0; col < size; col++) {
+          matrix[row][col] += powers[row + col];
+        }
+        matrix[row][size] += data.pointBias[p][channel] * powers[row];
+      }
+    }
+    
+    if (!solve(matrix, size)) {
+      return false;
+    }
+    
+    for (uint8_t k = 0; k < TEMPCOMP_COEFFS; k++) {
+      data.coefficients[channel][k] = (k < size) ? matrix[k][size] : 0;
+    }
+  }
+  
+  data.order = order;
+  data.flags |= EEPROM_TEMPCOMP_FLAG_FITTED;
+  return true;
+}
+
+// Gauss-Jordan elimination with partial pivoting on an augmented matrix; solution left in the last column
+bool TemperatureModel::solve(float matrix[TEMPCOMP_COEFFS][TEMPCOMP_COEFFS + 1], uint8_t size) {
+  for (uint8_t col = 0; col < size; col++) {
+    uint8_t pivot = col;
+    for (uint8_t row = col + 1; row < size; row++) {
+      if (fabs(matrix[row][col]) > fabs(matrix[pivot][col])) {
+        pivot = row;
+      }
+    }
+    if (fabs(matrix[pivot][col]) < 1e-9) {
+      return false;
+    }
+    if (pivot != col) {
+      for (uint8_t k = 0; k <= size; k++) {
+        float swap = matrix[col][k];
+        matrix[col][k] = matrix[pivot][k];
+        matrix[pivot][k] = swap;
+      }
+    }
+    
+    float divisor = matrix[col][col];
+    for (uint8_t k = 0; k <= size; k++) {
+      matrix[col][k] /= divisor;
+    }
+    
+    for (uint8_t row = 0; row < size; row++) {
+      if (row != col) {
+        float factor = matrix[row][col];
+        for (uint8_t k = 0; k <= size; k++) {
+          matrix[row][k] -= factor * matrix[col][k];
+        }
+      }
+    }
+  }
+  return true;
+}
+
+bool TemperatureModel::isFitted() const {
+  return data.flags & EEPROM_TEMPCOMP_FLAG_FITTED;
+}
+
+uint8_t TemperatureModel::getOrder() const {
+  return data.order;
+}
+
+uint8_t TemperatureModel::getPointCount() const {
+  return data.pointCount;
+}
+
+void TemperatureModel::setCalibrationTemperature(float temperature) {
+  data.calibrationTemp = temperature;
+}
+
+float TemperatureModel::getCalibrationTemperature() const {
+  return data.calibrationTemp;
+}
+
+float TemperatureModel::evaluate(uint8_t channel, float temperature) const {
+  float dT = temperature - data.referenceTemp;
+  const float* c = data.coefficients[channel];
+  return c[0] + dT * (c[1] + dT * c[2]);
+}
+
+float TemperatureModel::correction(uint8_t channel, float temperature) const {
+  if (!isFitted()) {
+    return 0;
+  }
+  return evaluate(channel, temperature) - evaluate(channel, data.calibrationTemp);
+}
@@ -0,0 +1,44 @@
+#ifndef TEMPERATURE_MODEL_H
+#define TEMPERATURE_MODEL_H
+
+#include <Arduino.h>
+#include "constants.h"
+#include "EEPROMManager.h"
+
+// Per-channel polynomial model of sensor bias against die temperature.
+// Points are (temperature, offsets) pairs collected at the end of each calibration
+// session; fit() solves a least-squares polynomial per channel on-device.
+// Channels are accel X/Y/Z (m/s^2) followed by gyro X/Y/Z (rad/s).
+class TemperatureModel {
+  public:
+    TemperatureModel();
+    
+    void clear();
+    
+    // EEPROM representation
+    void load(const TemperatureCompData& stored);
+    const TemperatureCompData& getData() const;
+    
+    // Record a calibration session and refit
+    void addPoint(float temperature, const float bias[TEMPCOMP_CHANNELS]);
+    bool fit();
+    
+    bool isFitted() const;
+    uint8_t getOrder() const;
+    uint8_t getPointCount() const;
+    
+    // Temperature of the calibration currently applied on the hot path
+    void setCalibrationTemperature(float temperature);
+    float getCalibrationTemperature() const;
+    
+    // Bias at the given temperature, and its change relative to the calibration temperature
+    float evaluate(uint8_t channel, float temperature) const;
+    float correction(uint8_t channel, float temperature) const;
+    
+  private:
+    TemperatureCompData data;
+    
+    static bool solve(float matrix[TEMPCOMP_COEFFS][TEMPCOMP_COEFFS + 1], uint8_t size);
+};
+
+#endif
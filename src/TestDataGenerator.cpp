@@ -1,4 +1,5 @@
 #include "TestDataGenerator.h"
+#include "DebugOutput.h"
 #include <FS.h>
 #include "math.h"
 
@@ -186,11 +187,11 @@ File TestDataGenerator::openFileForWriting(const char* filename) {
   fullPath += filename;
   File file = SPIFFS.open(fullPath, "w");
   if (!file) {
-    Serial.printf("Failed to open file %s for writing\n", fullPath.c_str());
+    debugOutput.at(LOG_LEVEL_ERROR).printf("Failed to open file %s for writing\n", fullPath.c_str());
     return File();
   }
   
-  Serial.printf("Opened file %s for test data generation\n", fullPath.c_str());
+  debugOutput.printf("Opened file %s for test data generation\n", fullPath.c_str());
   return file;
 }
 
@@ -201,12 +202,12 @@ bool TestDataGenerator::closeAndVerifyFile(File &file, int expectedRecords) {
   
   size_t expectedSize = expectedRecords * sizeof(MPULogRecord);
   
-  Serial.printf("Test data generation complete. Records: %d, File size: %d bytes (expected: %d bytes)\n", 
+  debugOutput.printf("Test data generation complete. Records: %d, File size: %d bytes (expected: %d bytes)\n", 
                   expectedRecords, fileSize, expectedSize);
-  Serial.printf("File created: %s\n", fileName.c_str());
+  debugOutput.printf("File created: %s\n", fileName.c_str());
   
   if (fileSize != expectedSize) {
-    Serial.printf("ERROR: File size mismatch! Expected %d bytes, got %d bytes\n", expectedSize, fileSize);
+    debugOutput.at(LOG_LEVEL_ERROR).printf("ERROR: File size mismatch! Expected %d bytes, got %d bytes\n", expectedSize, fileSize);
     return false;
   }
   
@@ -0,0 +1,68 @@
+#include "UdpBatcher.h"
+#include <string.h>
+
+UdpBatcher::UdpBatcher() {
+  reset();
+}
+
+void UdpBatcher::reset() {
+  payloadLength = 0;
+  sequence = 0;
+  batchStartMs = 0;
+  sealed = false;
+}
+
+bool UdpBatcher::add(const void* record, uint16_t size, uint32_t nowMs) {
+  if (sealed) {
+    payloadLength = 0;
+    sealed = false;
+  }
+  if (payloadLength + size > UDP_MAX_PAYLOAD) {
+    return true;  // Caller missed a full batch; it must seal and send before adding more
+  }
+  
+  if (payloadLength == 0) {
+    batchStartMs = nowMs;
+  }
+  memcpy(datagram + sizeof(StreamFrameHeader) + payloadLength, record, size);
+  payloadLength += size;
+  return payloadLength + size > UDP_MAX_PAYLOAD;
+}
+
+bool UdpBatcher::isDue(uint32_t nowMs) const {
+  return !sealed && payloadLength > 0 && nowMs - batchStartMs >= UDP_BATCH_MAX_MS;
+}
+
+bool UdpBatcher::isEmpty() const {
+  return sealed || payloadLength == 0;
+}
+
+uint16_t UdpBatcher::seal() {
+  if (isEmpty()) {
+    return 0;
+  }
+  
+  StreamFrameHeader header;
+  header.sync = STREAM_FRAME_SYNC;
+  header.type = STREAM_FRAME_SAMPLES;
+  header.reserved = 0;
+  header.sequence = sequence++;
+  header.length = payloadLength;
+  memcpy(datagram, &header, sizeof(header));
+  
+  uint16_t frameLength = sizeof(header) + payloadLength;
+  uint16_t crc = streamFrameCRC(0xFFFF, datagram, frameLength);
+  datagram[frameLength] = crc & 0xFF;
+  datagram[frameLength + 1] = crc >> 8;
+  
+  sealed = true;
+  return frameLength + sizeof(uint16_t);
+}
+
+const uint8_t* UdpBatcher::data() const {
+  return datagram;
+}
+
+uint16_t UdpBatcher::getSequence() const {
+  return sequence;
+}
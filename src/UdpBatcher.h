@@ -0,0 +1,44 @@
+#ifndef UDP_BATCHER_H
+#define UDP_BATCHER_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "StreamFrame.h"
+#include "constants.h"
+
+// Collects log records into sequence-numbered datagrams for UDP streaming. Each datagram is
+// one StreamFrame samples frame: header, up to UDP_BATCH_RECORDS records and a CRC. Nothing
+// here touches the network or Arduino APIs, so the same batching runs in the host sender
+// (tools/udp_sender.cpp) that exercises tools/udp_collector.cpp on localhost.
+class UdpBatcher {
+  public:
+    static const uint16_t MAX_DATAGRAM = sizeof(StreamFrameHeader) + UDP_MAX_PAYLOAD + sizeof(uint16_t);
+    
+    UdpBatcher();
+    
+    // Drops any partial batch and restarts the sequence at zero
+    void reset();
+    
+    // Appends one record. True once the batch is full and should be sent.
+    bool add(const void* record, uint16_t size, uint32_t nowMs);
+    
+    // True when a partial batch has waited UDP_BATCH_MAX_MS
+    bool isDue(uint32_t nowMs) const;
+    bool isEmpty() const;
+    
+    // Completes the pending batch with its sequence number and CRC and returns the datagram
+    // length (0 if empty). The datagram stays in data() until the next add().
+    uint16_t seal();
+    const uint8_t* data() const;
+    
+    uint16_t getSequence() const;
+  
+  private:
+    uint8_t datagram[MAX_DATAGRAM];
+    uint16_t payloadLength = 0;
+    uint16_t sequence = 0;
+    uint32_t batchStartMs = 0;
+    bool sealed = false;
+};
+
+#endif
@@ -0,0 +1,117 @@
+#include "UdpStreamTask.h"
+#include "DebugOutput.h"
+#include "MPULogRecord.h"
+#include "Settings.h"
+
+UdpStreamTask::UdpStreamTask(Settings& settings)
+  : Task(),
+    settings(settings) {
+  setName(F("UdpStreamTask"));
+  runInterval = 1000;  // Only watches the settings until streaming starts
+}
+
+void UdpStreamTask::run() {
+  if (!settings.udpStreamEnabled) {
+    if (streaming) {
+      stop();
+    }
+    return;
+  }
+  
+  if (streaming && (port != settings.udpStreamPort || strcmp(hostSetting, settings.udpStreamHost) != 0)) {
+    stop();
+  }
+  if (!streaming) {
+    start();
+    return;
+  }
+  
+  if (batcher.isDue(millis())) {
+    send();
+  }
+}
+
+bool UdpStreamTask::isStreaming() const {
+  return streaming;
+}
+
+void UdpStreamTask::addSample(float accel_x, float accel_y, float accel_z,
+                              float yaw, float pitch, float roll) {
+  if (!streaming) {
+    return;
+  }
+  
+  MPULogRecord record;
+  record.timestamp = millis();
+  record.accel_x = accel_x;
+  record.accel_y = accel_y;
+  record.accel_z = accel_z;
+  record.yaw = yaw;
+  record.pitch = pitch;
+  record.roll = roll;
+  record.setRecording(true);
+  records++;
+  
+  if (batcher.add(&record, sizeof(record), record.timestamp)) {
+    send();
+  }
+}
+
+void UdpStreamTask::writeStatusJSON(JsonWriter& json) {
+  json.add("streaming", streaming);
+  json.add("host", settings.udpStreamHost);
+  json.add("port", settings.udpStreamPort);
+  json.add("records", records);
+  json.add("datagrams", datagramsSent);
+  json.add("sendFailures", sendFailures);
+  json.add("sequence", batcher.getSequence());
+}
+
+void UdpStreamTask::start() {
+  if (!host.fromString(settings.udpStreamHost)) {
+    Print& log = debugOutput.at(LOG_LEVEL_ERROR);
+    log.print(F("UDP stream: invalid host "));
+    log.println(settings.udpStreamHost);
+    return;
+  }
+  strlcpy(hostSetting, settings.udpStreamHost, sizeof(hostSetting));
+  port = settings.udpStreamPort;
+  
+  batcher.reset();
+  records = 0;
+  datagramsSent = 0;
+  sendFailures = 0;
+  streaming = true;
+  runInterval = 10;  // Partial batches only need checking against UDP_BATCH_MAX_MS
+  
+  debugOutput.print(F("UDP stream started to "));
+  debugOutput.print(host.toString());
+  debugOutput.print(F(":"));
+  debugOutput.println(port);
+}
+
+void UdpStreamTask::stop() {
+  send();
+  streaming = false;
+  runInterval = 1000;
+  
+  debugOutput.print(F("UDP stream stopped: "));
+  debugOutput.print(datagramsSent);
+  debugOutput.print(F(" datagrams, "));
+  debugOutput.print(sendFailures);
+  debugOutput.println(F(" failed"));
+}
+
+void UdpStreamTask::send() {
+  uint16_t length = batcher.seal();
+  if (length == 0) {
+    return;
+  }
+  
+  // The sequence number is spent either way, so a failure shows up as a gap on the host
+  if (udp.beginPacket(host, port) && udp.write(batcher.data(), length) == length && udp.endPacket()) {
+    datagramsSent++;
+  } else {
+    sendFailures++;
+  }
+}
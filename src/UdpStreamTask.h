@@ -0,0 +1,60 @@
+#ifndef UDP_STREAM_TASK_H
+#define UDP_STREAM_TASK_H
+
+#include "Task.h"
+#include "UdpBatcher.h"
+#include "constants.h"
+#include "JsonWriter.h"
+#include <WiFiUdp.h>
+
+// Forward declaration
+class Settings;
+
+/**
+ * Sample streaming over UDP to a host collector (tools/udp_collector.cpp).
+ *
+ * While Settings::udpStreamEnabled is set, every logged sample is batched by UdpBatcher and
+ * sent to udpStreamHost:udpStreamPort as soon as a datagram is full, or after UDP_BATCH_MAX_MS.
+ * There are no acknowledgements or retransmits: a datagram the stack refuses is counted and
+ * its sequence number skipped, so the collector sees every loss as a gap.
+ */
+class UdpStreamTask : public Task {
+  public:
+    static const uint16_t MASK { UDP_STREAM_TASK_MASK };
+    
+    UdpStreamTask(Settings& settings);
+    
+    virtual uint16_t getMask() override {
+      return UdpStreamTask::MASK;
+    }
+    
+    virtual void run() override;
+    
+    bool isStreaming() const;
+    
+    // Called by MPUSensorTask once per logged sample
+    void addSample(float accel_x, float accel_y, float accel_z, float yaw, float pitch, float roll);
+    
+    void writeStatusJSON(JsonWriter& json);
+  
+  private:
+    Settings& settings;
+    WiFiUDP udp;
+    UdpBatcher batcher;
+    
+    bool streaming = false;
+    IPAddress host;
+    char hostSetting[16] = "";  // Settings::udpStreamHost as streaming started, compared in run()
+    uint16_t port = 0;
+    
+    // Statistics
+    uint32_t records = 0;
+    uint32_t datagramsSent = 0;
+    uint32_t sendFailures = 0;
+    
+    void start();
+    void stop();
+    void send();
+};
+
+#endif
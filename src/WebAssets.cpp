@@ -0,0 +1,11 @@
+#include "WebAssets.h"
+#include "WebAssetData.h"
+
+const WebAsset* findWebAsset(const String& path) {
+  for (size_t i = 0; i < sizeof(webAssetTable) / sizeof(webAssetTable[0]); i++) {
+    if (strcmp_P(path.c_str(), webAssetTable[i].path) == 0) {
+      return &webAssetTable[i];
+    }
+  }
+  return nullptr;
+}
@@ -0,0 +1,19 @@
+#ifndef WEB_ASSETS_H
+#define WEB_ASSETS_H
+
+#include <Arduino.h>
+
+// A file from data/, gzipped into flash by tools/embed_assets.py. All pointers are PROGMEM.
+struct WebAsset {
+  const char* path;           // e.g. "/index.htm"
+  const char* contentType;
+  const char* etag;           // Quoted, as sent in the ETag header
+  const uint8_t* data;        // gzip stream, sent with Content-Encoding: gzip
+  uint32_t length;
+  uint32_t maxAge;            // Cache-Control max-age in seconds; 0 always revalidates
+};
+
+// The embedded asset for a request path, or nullptr
+const WebAsset* findWebAsset(const String& path);
+
+#endif
@@ -1,8 +1,12 @@
 #include "WebServerTask.h"
+#include "DebugOutput.h"
 #include "WebStreamingTask.h"
 #include "Tasks.h"
 #include "TestDataGenerator.h"
 #include "MPULogRecord.h"
+#include "WebAssets.h"
+#include "CsvEncoder.h"
+#include "TarArchive.h"
 #include "FS.h"
 #include "ArduinoJSON/ArduinoJson-v6.18.3.h"
 
@@ -32,20 +36,20 @@ void WebServerTask::run() {
 }
 
 bool WebServerTask::initCaptivePortal() {
-  Serial.println(F("Begin WiFi AP mode"));
+  debugOutput.println(F("Begin WiFi AP mode"));
   WiFi.disconnect(true);
   WiFi.mode(WIFI_AP);
   
   // Set up event handler for client connections
   wifiStaConnectHandler = WiFi.onSoftAPModeStationConnected([](const WiFiEventSoftAPModeStationConnected& evt) {
-    Serial.println(F("WiFi captive client connected"));
+    debugOutput.println(F("WiFi captive client connected"));
   });
   
   // Configure AP
   WiFi.softAPConfig(captivePortalIP, captivePortalIP, IPAddress(255, 255, 255, 0));
   WiFi.softAP(settings.hostName, nullptr, 1);
   
-  Serial.println(F("Starting captive portal"));
+  debugOutput.println(F("Starting captive portal"));
   dnsServer.setErrorReplyCode(DNSReplyCode::NoError);
   dnsServer.start(53, "*", captivePortalIP);
   
@@ -66,9 +70,9 @@ void WebServerTask::beginServer() {
   
   // Begin server
   server.begin();
-  Serial.println(F("Web server started"));
-  Serial.print(F("AP IP address: "));
-  Serial.println(captivePortalIP);
+  debugOutput.println(F("Web server started"));
+  debugOutput.print(F("AP IP address: "));
+  debugOutput.println(captivePortalIP);
 }
 
 void WebServerTask::setupRoutes() {
@@ -79,9 +83,16 @@ void WebServerTask::setupRoutes() {
   });
   
   // API endpoints
+  // Also receives /api/files/<name>/at and /api/files/<name>.csv, which it would match as sub-paths
   server.on("/api/files", HTTP_GET, [this](AsyncWebServerRequest *request) {
     logRequest(request);
-    handleFileList(request);
+    if (request->url().startsWith("/api/files/") && request->url().endsWith(".csv")) {
+      handleFileCsv(request);
+    } else if (request->url().startsWith("/api/files/")) {
+      handleFileWindow(request);
+    } else {
+      handleFileList(request);
+    }
   });
   
   server.on("/api/settings", HTTP_GET, [this](AsyncWebServerRequest *request) {
@@ -91,8 +102,34 @@ void WebServerTask::setupRoutes() {
   
   server.on("/api/settings", HTTP_POST, [this](AsyncWebServerRequest *request) {
     logRequest(request);
-    // TODO: Handle settings update
-    sendJsonResponse(request, "{\"status\":\"ok\"}");
+    handleSettingsUpdate(request);
+  }, nullptr, [](AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total) {
+    // Collect the JSON body. _tempObject is released with free() by the request destructor.
+    // A larger body is not collected; handleSettingsUpdate() answers it with 413.
+    if (total > SETTINGS_BODY_MAX) {
+      return;
+    }
+    if (index == 0) {
+      request->_tempObject = malloc(total + 1);
+    }
+    if (request->_tempObject != nullptr) {
+      char *body = static_cast<char *>(request->_tempObject);
+      memcpy(body + index, data, len);
+      body[index + len] = '\0';
+    }
+  });
+  
+  // Progress of queued commands (record start/stop, calibrate, test data, delete, settings save,
+  // tempcomp clear, rainflow reset)
+  server.on("/api/commands", HTTP_GET, [this](AsyncWebServerRequest *request) {
+    logRequest(request);
+    handleCommands(request);
+  });
+  
+  // Several files in one download, for offloading the logger in one request
+  server.on("/api/archive", HTTP_GET, [this](AsyncWebServerRequest *request) {
+    logRequest(request);
+    handleArchive(request);
   });
   
   server.on("/api/status", HTTP_GET, [this](AsyncWebServerRequest *request) {
@@ -121,6 +158,108 @@ void WebServerTask::setupRoutes() {
     handleRecordStop(request);
   });
   
+  // Six-position calibration (registered before /api/calibrate, which would also match this path)
+  server.on("/api/calibrate/sixpos", HTTP_GET, [this](AsyncWebServerRequest *request) {
+    logRequest(request);
+    handleSixPositionStatus(request);
+  });
+  
+  server.on("/api/calibrate/sixpos", HTTP_POST, [this](AsyncWebServerRequest *request) {
+    logRequest(request);
+    handleSixPositionCalibrate(request);
+  });
+  
+  // Temperature compensation model
+  server.on("/api/tempcomp", HTTP_GET, [this](AsyncWebServerRequest *request) {
+    logRequest(request);
+    handleTemperatureCompensation(request);
+  });
+  
+  server.on("/api/tempcomp", HTTP_POST, [this](AsyncWebServerRequest *request) {
+    logRequest(request);
+    if (request->hasParam("action", true) && request->getParam("action", true)->value() == "clear") {
+      // Clearing saves the empty model to EEPROM
+      queueCommand(request, Command::CLEAR_TEMPCOMP);
+      return;
+    }
+    handleTemperatureCompensation(request);
+  });
+  
+  // Filter chain (self-test registered first, /api/filters would also match it). Self-tests
+  // are run by CommandTask on POST; GET serves the last result.
+  server.on("/api/filters/selftest", HTTP_GET, [this](AsyncWebServerRequest *request) {
+    logRequest(request);
+    handleSelfTestResult(request, Command::FILTER_SELFTEST);
+  });
+  
+  server.on("/api/filters/selftest", HTTP_POST, [this](AsyncWebServerRequest *request) {
+    logRequest(request);
+    queueCommand(request, Command::FILTER_SELFTEST);
+  });
+  
+  server.on("/api/filters", HTTP_GET, [this](AsyncWebServerRequest *request) {
+    logRequest(request);
+    handleFilters(request);
+  });
+  
+  // Vibration spectrum (self-test registered first, /api/spectrum would also match it)
+  server.on("/api/spectrum/selftest", HTTP_GET, [this](AsyncWebServerRequest *request) {
+    logRequest(request);
+    handleSelfTestResult(request, Command::SPECTRUM_SELFTEST);
+  });
+  
+  server.on("/api/spectrum/selftest", HTTP_POST, [this](AsyncWebServerRequest *request) {
+    logRequest(request);
+    queueCommand(request, Command::SPECTRUM_SELFTEST);
+  });
+  
+  server.on("/api/spectrum", HTTP_GET, [this](AsyncWebServerRequest *request) {
+    logRequest(request);
+    handleSpectrum(request);
+  });
+  
+  server.on("/api/histogram", HTTP_GET, [this](AsyncWebServerRequest *request) {
+    logRequest(request);
+    handleHistogram(request);
+  });
+  
+  // Rainflow cycle counting (self-test registered first, /api/rainflow would also match it)
+  server.on("/api/rainflow/selftest", HTTP_GET, [this](AsyncWebServerRequest *request) {
+    logRequest(request);
+    handleSelfTestResult(request, Command::RAINFLOW_SELFTEST);
+  });
+  
+  server.on("/api/rainflow/selftest", HTTP_POST, [this](AsyncWebServerRequest *request) {
+    logRequest(request);
+    queueCommand(request, Command::RAINFLOW_SELFTEST);
+  });
+  
+  server.on("/api/rainflow", HTTP_GET, [this](AsyncWebServerRequest *request) {
+    logRequest(request);
+    handleRainflow(request);
+  });
+  
+  server.on("/api/rainflow", HTTP_POST, [this](AsyncWebServerRequest *request) {
+    logRequest(request);
+    if (request->hasParam("action", true) && request->getParam("action", true)->value() == "reset") {
+      // Resetting removes the persisted matrix from SPIFFS
+      queueCommand(request, Command::RESET_RAINFLOW);
+      return;
+    }
+    handleRainflow(request);
+  });
+  
+  // RAM burst capture
+  server.on("/api/burst", HTTP_GET, [this](AsyncWebServerRequest *request) {
+    logRequest(request);
+    handleBurst(request);
+  });
+  
+  server.on("/api/burst", HTTP_POST, [this](AsyncWebServerRequest *request) {
+    logRequest(request);
+    handleBurstArm(request);
+  });
+  
   // Calibration control endpoint
   server.on("/api/calibrate", HTTP_POST, [this](AsyncWebServerRequest *request) {
     logRequest(request);
@@ -144,6 +283,11 @@ void WebServerTask::setupRoutes() {
         path += "index.htm";
       }
       
+      // The web interface is compiled in; only log files are read from SPIFFS
+      if (sendWebAsset(request, path)) {
+        return;
+      }
+      
       // Check for gzip version first, then regular file
       String finalPath = path;
       if (SPIFFS.exists(path + ".gz")) {
@@ -152,8 +296,8 @@ void WebServerTask::setupRoutes() {
         finalPath = path;
       } else {
         // File not found - serve index for captive portal functionality
-        Serial.print(F("HTTP 404: File not found, serving captive portal: "));
-        Serial.println(path);
+        debugOutput.print(F("HTTP 404: File not found, serving captive portal: "));
+        debugOutput.println(path);
         handleRoot(request);
         return;
       }
@@ -189,21 +333,18 @@ void WebServerTask::setupRoutes() {
       }
       
       // Security check - prevent directory traversal
-      if (path.indexOf('/') != -1 || path.indexOf('\\') != -1) {
+      path = "/" + path;
+      if (path.indexOf('/', 1) != -1 || path.indexOf('\\') != -1 || path.length() >= COMMAND_TEXT_MAX) {
         sendErrorResponse(request, 400, "Invalid filename");
         return;
       }
       
-      if (deleteFile("/" + path)) {
-        sendJsonResponse(request, "{\"status\":\"ok\",\"message\":\"File deleted\"}");
-        Serial.print(F("File deleted via DELETE: "));
-        Serial.println(path);
-      } else {
-        sendErrorResponse(request, 500, "Error deleting file");
-      }
+      // Erasing a large log takes a while, so it is done by CommandTask
+      queueCommand(request, Command::DELETE_FILE, 0, path.c_str());
     } else {
-      Serial.print(F("HTTP 405: Method not allowed: "));
-      Serial.println(request->methodToString());
+      Print& log = debugOutput.at(LOG_LEVEL_WARN);
+      log.print(F("HTTP 405: Method not allowed: "));
+      log.println(request->methodToString());
       
       // Determine which methods are allowed based on the path
       String allowHeader = "GET, HEAD"; // Default for static files
@@ -218,6 +359,9 @@ void WebServerTask::setupRoutes() {
           allowHeader = "GET";
         } else if (path == "/api/testdata/generate") {
           allowHeader = "POST";
+        } else if (path == "/api/calibrate/sixpos" || path == "/api/tempcomp" || path == "/api/rainflow" ||
+                   path == "/api/burst" || path.endsWith("/selftest")) {
+          allowHeader = "GET, POST";
         } else {
           allowHeader = "GET"; // Default for other API endpoints
         }
@@ -231,28 +375,33 @@ void WebServerTask::setupRoutes() {
 }
 
 void WebServerTask::logRequest(AsyncWebServerRequest *request) {
+  // Every request passes through here, so skip the formatting unless it will be shown
+  if (!debugOutput.isEnabled(LOG_LEVEL_DEBUG)) {
+    return;
+  }
+  
   String clientIP = request->client()->remoteIP().toString();
   String method = request->methodToString();
   String url = request->url();
   
-  Serial.print(F("WEB REQUEST: "));
-  Serial.print(clientIP);
-  Serial.print(F(" "));
-  Serial.print(method);
-  Serial.print(F(" "));
-  Serial.println(url);
+  debugOutput.print(F("WEB REQUEST: "));
+  debugOutput.print(clientIP);
+  debugOutput.print(F(" "));
+  debugOutput.print(method);
+  debugOutput.print(F(" "));
+  debugOutput.println(url);
   
   // Log query parameters if any
   if (request->params() > 0) {
-    Serial.print(F("QUERY PARAMS: "));
+    debugOutput.print(F("QUERY PARAMS: "));
     for (int i = 0; i < request->params(); i++) {
-      if (i > 0) Serial.print(F(", "));
+      if (i > 0) debugOutput.print(F(", "));
       AsyncWebParameter* p = request->getParam(i);
-      Serial.print(p->name());
-      Serial.print(F("="));
-      Serial.print(p->value());
+      debugOutput.print(p->name());
+      debugOutput.print(F("="));
+      debugOutput.print(p->value());
     }
-    Serial.println();
+    debugOutput.println();
   }
 }
 
@@ -265,83 +414,253 @@ void WebServerTask::handleRoot(AsyncWebServerRequest *request) {
 }
 
 void WebServerTask::handleFileList(AsyncWebServerRequest *request) {
-  String json = listFiles();
-  Serial.println(F("FILES API RESPONSE:"));
-  Serial.println(json);
-  sendJsonResponse(request, json);
+  AsyncResponseStream *response = beginJsonResponse(request);
+  JsonWriter json(*response);
+  json.beginObject();
+  writeFileList(json);
+  json.endObject();
+  request->send(response);
 }
 
-
-void WebServerTask::handleSettings(AsyncWebServerRequest *request) {
-  // Return current settings as JSON
-  String json = "{";
-  json += "\"hostName\":\"" + String(settings.hostName) + "\",";
-  json += "\"sampleRateMs\":" + String(settings.sampleRateMs) + ",";
-  json += "\"maxLogFiles\":" + String(settings.maxLogFiles) + ",";
-  json += "\"bufferSize\":" + String(settings.bufferSize) + ",";
-  json += "\"autoCalibration\":" + String(settings.autoCalibration ? "true" : "false") + ",";
-  json += "\"accelRange\":" + String(settings.accelRange) + ",";
-  json += "\"gyroRange\":" + String(settings.gyroRange);
-  json += "}";
+// GET /api/files/<name>/at?t=<ms>[&span=<ms>]: the pages of a raw log covering span ms
+// centred on t ms after its first record, located through the log's time index
+void WebServerTask::handleFileWindow(AsyncWebServerRequest *request) {
+  String path = request->url().substring(strlen("/api/files"));
+  if (!path.endsWith("/at") || !request->hasParam("t")) {
+    sendErrorResponse(request, 400, "Expected /api/files/<name>/at?t=<ms>");
+    return;
+  }
+  
+  String fileName = path.substring(0, path.length() - 3);
+  const char* suffix = DataLoggingTask::getLogFileSuffix(fileName);
+  if (fileName.indexOf('/', 1) != -1 || !suffix || strcmp(suffix, LOG_FILE_SUFFIX) != 0) {
+    sendErrorResponse(request, 400, "Invalid filename");
+    return;
+  }
+  
+  uint32_t t = request->getParam("t")->value().toInt();
+  uint32_t span = LOG_INDEX_DEFAULT_SPAN_MS;
+  if (request->hasParam("span")) {
+    span = request->getParam("span")->value().toInt();
+  }
+  uint32_t from = t > span / 2 ? t - span / 2 : 0;
   
-  sendJsonResponse(request, json);
+  uint32_t startOffset = 0;
+  uint32_t endOffset = 0;
+  if (!SPIFFS.exists(fileName) ||
+      !DataLoggingTask::findTimeRange(fileName, from, from + span, startOffset, endOffset)) {
+    sendErrorResponse(request, 404, "No time index for file");
+    return;
+  }
+  
+  File file = SPIFFS.open(fileName, "r");
+  if (!file) {
+    sendErrorResponse(request, 500, "Error opening file");
+    return;
+  }
+  
+  // Files with an MPULogHeader get it ahead of the window so the result decodes on its own
+  uint32_t headerBytes = 0;
+  uint32_t magic = 0;
+  if (startOffset >= sizeof(MPULogHeader) &&
+      file.read(reinterpret_cast<uint8_t*>(&magic), sizeof(magic)) == sizeof(magic) && magic == LOG_HEADER_MAGIC) {
+    headerBytes = sizeof(MPULogHeader);
+  }
+  
+  const uint32_t length = headerBytes + (endOffset - startOffset);
+  AsyncWebServerResponse *response = request->beginResponse("application/octet-stream", length,
+    [file, headerBytes, startOffset, length](uint8_t *buffer, size_t maxLen, size_t index) mutable -> size_t {
+      if (index >= length) {
+        file.close();
+        return 0;
+      }
+      // Header bytes come from the start of the file, the rest from the window
+      size_t count = index < headerBytes ? headerBytes - index : length - index;
+      if (count > maxLen) {
+        count = maxLen;
+      }
+      file.seek(index < headerBytes ? index : startOffset + (index - headerBytes), SeekSet);
+      return file.read(buffer, count);
+    });
+  response->addHeader("X-Log-Offset", String(startOffset));
+  request->send(response);
 }
 
-void WebServerTask::handleStatus(AsyncWebServerRequest *request) {
-  // Return system status as JSON
-  String json = "{";
-  json += "\"uptime\":" + String(millis()) + ",";
-  json += "\"freeHeap\":" + String(ESP.getFreeHeap()) + ",";
-  json += "\"wifiMode\":\"AP\",";
-  json += "\"apIp\":\"" + captivePortalIP.toString() + "\",";
-  json += "\"connectedClients\":" + String(WiFi.softAPgetStationNum()) + ",";
-  
-  // Calculate recording duration remaining
-  FSInfo fs_info;
-  if (SPIFFS.info(fs_info)) {
-    // Calculate available space for new recordings
-    size_t usedSpace = fs_info.usedBytes;
-    size_t totalSpace = fs_info.totalBytes;
-    size_t freeSpace = totalSpace - usedSpace;
-    
-    // Calculate how many records can fit in remaining space
-    size_t recordSize = MPULogRecord::getRecordSize();
-    size_t maxRecords = freeSpace / recordSize;
-    
-    // Convert to time based on sample rate (convert to seconds)
-    uint32_t sampleRateMs = settings.sampleRateMs;
-    uint32_t remainingDurationSeconds = (maxRecords * sampleRateMs) / 1000;
+// Feeds CsvEncoder from a log file
+class FileCsvSource : public CsvEncoder::Source {
+  public:
+    FileCsvSource(File& file) : file(file) {}
     
-    json += "\"recordingDurationRemaining\":" + String(remainingDurationSeconds);
+    virtual size_t read(uint8_t* buffer, size_t length) override {
+      return file.read(buffer, length);
+    }
+  
+  private:
+    File& file;
+};
+
+// GET /api/files/<name>.csv: a raw log converted to CSV while it is sent, a response chunk at
+// a time, so the client never needs the binary file or the whole CSV in memory
+void WebServerTask::handleFileCsv(AsyncWebServerRequest *request) {
+  String fileName = request->url().substring(strlen("/api/files"));
+  fileName = fileName.substring(0, fileName.length() - strlen(".csv"));
+  if (!fileName.endsWith(LOG_FILE_SUFFIX)) {
+    fileName += LOG_FILE_SUFFIX;
+  }
+  
+  const char* suffix = DataLoggingTask::getLogFileSuffix(fileName);
+  if (fileName.indexOf('/', 1) != -1 || !suffix || strcmp(suffix, LOG_FILE_SUFFIX) != 0) {
+    sendErrorResponse(request, 400, "Invalid filename");
+    return;
+  }
+  if (!SPIFFS.exists(fileName)) {
+    sendErrorResponse(request, 404, "File not found");
+    return;
+  }
+  
+  File file = SPIFFS.open(fileName, "r");
+  if (!file) {
+    sendErrorResponse(request, 500, "Error opening file");
+    return;
+  }
+  
+  // The encoder's input page and line buffer are all the export holds, however long the log
+  CsvEncoder encoder;
+  AsyncWebServerResponse *response = request->beginChunkedResponse("text/csv",
+    [file, encoder](uint8_t *buffer, size_t maxLen, size_t index) mutable -> size_t {
+      FileCsvSource source(file);
+      size_t length = encoder.fill(source, buffer, maxLen);
+      if (length == 0) {
+        file.close();
+      }
+      return length;
+    });
+  
+  String csvName = fileName.substring(1, fileName.length() - strlen(LOG_FILE_SUFFIX)) + ".csv";
+  response->addHeader("Content-Disposition", "attachment; filename=\"" + csvName + "\"");
+  request->send(response);
+}
+
+// GET /api/archive[?files=<name>,<name>...]: the files as one tar, streamed a file at a time;
+// every file without files= or with files=all
+void WebServerTask::handleArchive(AsyncWebServerRequest *request) {
+  String requested = request->hasParam("files") ? request->getParam("files")->value() : String("all");
+  String fileNames;
+  
+  if (requested == "all") {
+    Dir dir = SPIFFS.openDir("/");
+    while (dir.next()) {
+      fileNames += dir.fileName();
+      fileNames += ',';
+    }
   } else {
-    json += "\"recordingDurationRemaining\":0";
+    // Every name is checked up front, so a typo is an error rather than a short archive
+    int start = 0;
+    while (start < (int)requested.length()) {
+      int end = requested.indexOf(',', start);
+      if (end < 0) {
+        end = requested.length();
+      }
+      String name = requested.substring(start, end);
+      start = end + 1;
+      if (name.length() == 0) {
+        continue;
+      }
+      if (!name.startsWith("/")) {
+        name = "/" + name;
+      }
+      if (name.indexOf('/', 1) != -1 || name.indexOf('\\') != -1) {
+        sendErrorResponse(request, 400, "Invalid filename");
+        return;
+      }
+      if (!SPIFFS.exists(name)) {
+        sendErrorResponse(request, 404, "File not found");
+        return;
+      }
+      fileNames += name;
+      fileNames += ',';
+    }
+    if (fileNames.length() == 0) {
+      sendErrorResponse(request, 400, "Expected files=<name>,<name>... or files=all");
+      return;
+    }
+  }
+  
+  // The archive's one block buffer is all it holds; file data goes straight into the response
+  TarArchive archive(fileNames);
+  AsyncWebServerResponse *response = request->beginChunkedResponse("application/x-tar",
+    [archive](uint8_t *buffer, size_t maxLen, size_t index) mutable -> size_t {
+      return archive.fill(buffer, maxLen);
+    });
+  
+  response->addHeader("Content-Disposition", "attachment; filename=\"" + String(settings.hostName) + ".tar\"");
+  request->send(response);
+}
+
+void WebServerTask::handleSettings(AsyncWebServerRequest *request) {
+  // Return current settings as JSON
+  AsyncResponseStream *response = beginJsonResponse(request);
+  settings.printJSON(*response);
+  request->send(response);
+}
+
+void WebServerTask::handleSettingsUpdate(AsyncWebServerRequest *request) {
+  if (request->contentLength() > SETTINGS_BODY_MAX) {
+    sendErrorResponse(request, 413, "Settings body too large");
+    return;
+  }
+  if (request->_tempObject == nullptr) {
+    sendErrorResponse(request, 400, "Expected a JSON settings body");
+    return;
   }
   
-  // Add CPU utilization
-  extern float cpuUtilization;
-  json += ",";
-  json += "\"cpuUtilization\":" + String(cpuUtilization, 1);
+  // Checked first, so settings are never applied without their save queued behind them
+  if (commandTask.isQueueFull()) {
+    sendErrorResponse(request, 503, "Command queue full");
+    return;
+  }
   
-  json += "}";
+  // Unknown keys are ignored, so clients can post just the settings they want to change.
+  // They take effect in RAM here; CommandTask writes settings.json.
+  String body = static_cast<const char *>(request->_tempObject);
+  if (!settings.applyFromJSON(body)) {
+    sendErrorResponse(request, 400, "Invalid settings JSON");
+    return;
+  }
   
-  sendJsonResponse(request, json);
+  queueCommand(request, Command::SAVE_SETTINGS);
+}
+
+void WebServerTask::handleStatus(AsyncWebServerRequest *request) {
+  // Served from StatusTask's snapshot; nothing here reads the flash
+  AsyncResponseStream *response = beginJsonResponse(request);
+  JsonWriter json(*response);
+  json.beginObject();
+  statusTask.writeStatusJSON(json);
+  json.endObject();
+  request->send(response);
 }
 
 void WebServerTask::handleMeta(AsyncWebServerRequest *request) {
   // Return metadata about the log structure
-  String json = "{";
-  json += "\"recordSize\":" + String(MPULogRecord::getRecordSize());
-  json += "}";
-  
-  sendJsonResponse(request, json);
+  AsyncResponseStream *response = beginJsonResponse(request);
+  JsonWriter json(*response);
+  json.beginObject();
+  json.add("recordSize", MPULogRecord::getRecordSize());
+  json.endObject();
+  request->send(response);
 }
 
 void WebServerTask::handleStaticFile(AsyncWebServerRequest *request, const String& filename) {
   String fullPath = "/" + filename;
+  if (sendWebAsset(request, fullPath)) {
+    return;
+  }
   
   if (!SPIFFS.exists(fullPath)) {
-    Serial.print(F("HTTP 404: Static file not found: "));
-    Serial.println(fullPath);
+    Print& log = debugOutput.at(LOG_LEVEL_WARN);
+    log.print(F("HTTP 404: Static file not found: "));
+    log.println(fullPath);
     request->send(404);
     return;
   }
@@ -350,14 +669,48 @@ void WebServerTask::handleStaticFile(AsyncWebServerRequest *request, const Strin
   
   // FIXED: Pass SPIFFS and path directly. 
   // The library handles the opening/closing lifecycle safely.
-  Serial.print("Responding with request->send(SPIFFS, ");
-  Serial.print(fullPath);
-  Serial.print(", ");
-  Serial.print(contentType);
-  Serial.println(")");
+  debugOutput.print("Responding with request->send(SPIFFS, ");
+  debugOutput.print(fullPath);
+  debugOutput.print(", ");
+  debugOutput.print(contentType);
+  debugOutput.println(")");
   request->send(SPIFFS, fullPath, contentType);
 }
 
+bool WebServerTask::sendWebAsset(AsyncWebServerRequest *request, const String& path) {
+  const WebAsset* asset = findWebAsset(path);
+  if (!asset) {
+    return false;
+  }
+  
+  // Unchanged since the client's copy: headers only
+  String etag = FPSTR(asset->etag);
+  if (request->hasHeader("If-None-Match") && request->getHeader("If-None-Match")->value() == etag) {
+    AsyncWebServerResponse *response = request->beginResponse(304);
+    response->addHeader("ETag", etag);
+    request->send(response);
+    return true;
+  }
+  
+  // Sent straight from flash in the form it was compressed at build time
+  AsyncWebServerResponse *response;
+  if (request->method() == HTTP_HEAD) {
+    response = request->beginResponse(200, FPSTR(asset->contentType), "");
+    response->addHeader("Content-Length", String(asset->length));
+  } else {
+    response = request->beginResponse_P(200, FPSTR(asset->contentType), asset->data, asset->length);
+  }
+  response->addHeader("Content-Encoding", "gzip");
+  response->addHeader("ETag", etag);
+  if (asset->maxAge > 0) {
+    response->addHeader("Cache-Control", "public, max-age=" + String(asset->maxAge));
+  } else {
+    response->addHeader("Cache-Control", "no-cache");
+  }
+  request->send(response);
+  return true;
+}
+
 String WebServerTask::getContentType(const String& filename) {
   if (filename.endsWith(".html") || filename.endsWith(".htm")) return "text/html";
   if (filename.endsWith(".css")) return "text/css";
@@ -367,7 +720,10 @@ String WebServerTask::getContentType(const String& filename) {
   if (filename.endsWith(".gif")) return "image/gif";
   if (filename.endsWith(".ico")) return "image/x-icon";
   if (filename.endsWith(".json")) return "application/json";
-  if (filename.endsWith(".bin")) return "application/octet-stream";
+  if (filename.endsWith(".bin") || filename.endsWith(".sum") || filename.endsWith(".hst")) return "application/octet-stream";
+  for (uint8_t level = 0; level < PYRAMID_LEVELS; level++) {
+    if (filename.endsWith(MinMaxPyramid::suffix(level))) return "application/octet-stream";
+  }
   return "text/plain";
 }
 
@@ -375,28 +731,18 @@ bool WebServerTask::fileExists(const String& filename) {
   return SPIFFS.exists(filename);
 }
 
-String WebServerTask::listFiles() {
-  String json = "{\"files\":[";
+void WebServerTask::writeFileList(JsonWriter& json) {
+  json.beginArray("files");
   
   Dir dir = SPIFFS.openDir("/");
-  bool first = true;
-  
   while (dir.next()) {
-    if (!first) json += ",";
-    
-    String fileName = dir.fileName();
-    size_t fileSize = dir.fileSize();
-    
-    json += "{";
-    json += "\"name\":\"" + fileName + "\",";
-    json += "\"size\":" + String(fileSize);
-    json += "}";
-    
-    first = false;
+    json.beginObject();
+    json.add("name", dir.fileName());
+    json.add("size", dir.fileSize());
+    json.endObject();
   }
   
-  json += "]}";
-  return json;
+  json.endArray();
 }
 
 String WebServerTask::getFileContent(const String& filename) {
@@ -412,11 +758,15 @@ String WebServerTask::getFileContent(const String& filename) {
 
 
 bool WebServerTask::deleteFile(const String& filename) {
+  DataLoggingTask::removeSidecarFiles(filename);
+  statusTask.noteFlashChanged();
   return SPIFFS.remove(filename);
 }
 
-void WebServerTask::sendJsonResponse(AsyncWebServerRequest *request, const String& json) {
-  request->send(200, "application/json", json);
+AsyncResponseStream* WebServerTask::beginJsonResponse(AsyncWebServerRequest *request, int code) {
+  AsyncResponseStream *response = request->beginResponseStream("application/json");
+  response->setCode(code);
+  return response;
 }
 
 void WebServerTask::handleTestData(AsyncWebServerRequest *request) {
@@ -442,93 +792,241 @@ void WebServerTask::handleTestData(AsyncWebServerRequest *request) {
   }
   
   // Validate filename
-  if (filename.indexOf('/') != -1 || filename.indexOf('\\') != -1 || !filename.endsWith(".bin")) {
+  if (filename.indexOf('/') != -1 || filename.indexOf('\\') != -1 || !filename.endsWith(".bin") ||
+      filename.length() >= COMMAND_TEXT_MAX) {
     sendErrorResponse(request, 400, "Invalid filename");
     return;
   }
   
-  Serial.printf("Generating test data: type=%s, filename=%s\n", testType.c_str(), filename.c_str());
-  
-  bool success = false;
-  
-  // Generate test data based on type
+  uint8_t option = Command::TEST_COMBINED;
   if (testType == "motion") {
-    success = TestDataGenerator::generateBasicMotionTest(filename.c_str());
+    option = Command::TEST_MOTION;
   } else if (testType == "static") {
-    success = TestDataGenerator::generateStaticTest(filename.c_str());
-  } else if (testType == "combined") {
-    success = TestDataGenerator::generateCombinedTest(filename.c_str());
-  } else {
+    option = Command::TEST_STATIC;
+  } else if (testType != "combined") {
     sendErrorResponse(request, 400, "Invalid test type. Use 'motion', 'static', or 'combined'");
     return;
   }
   
-  if (success) {
-    // Return success response with file info
-    String json = "{";
-    json += "\"status\":\"ok\",";
-    json += "\"message\":\"Test data generated successfully\",";
-    json += "\"filename\":\"" + filename + "\",";
-    json += "\"type\":\"" + testType + "\"";
-    json += "}";
-    
-    sendJsonResponse(request, json);
-    Serial.printf("Test data generation completed: %s\n", filename.c_str());
+  // Generation writes a whole file, so it runs from CommandTask
+  queueCommand(request, Command::GENERATE_TEST_DATA, option, filename.c_str());
+}
+
+void WebServerTask::sendErrorResponse(AsyncWebServerRequest *request, int code, const char* message) {
+  Print& log = debugOutput.at(LOG_LEVEL_WARN);
+  log.print(F("HTTP ERROR "));
+  log.print(code);
+  log.print(F(": "));
+  log.println(message);
+  
+  AsyncResponseStream *response = beginJsonResponse(request, code);
+  JsonWriter json(*response);
+  json.beginObject();
+  json.add("error", message);
+  json.endObject();
+  request->send(response);
+}
+
+void WebServerTask::handleRecordStart(AsyncWebServerRequest *request) {
+  // Opening the log file is left to CommandTask
+  queueCommand(request, Command::RECORD_START);
+}
+
+void WebServerTask::handleRecordStop(AsyncWebServerRequest *request) {
+  // Flushing and closing the log file is left to CommandTask
+  queueCommand(request, Command::RECORD_STOP);
+}
+
+void WebServerTask::handleCalibrate(AsyncWebServerRequest *request) {
+  queueCommand(request, Command::CALIBRATE);
+}
+
+void WebServerTask::handleCommands(AsyncWebServerRequest *request) {
+  const Command* command = nullptr;
+  if (request->hasParam("id")) {
+    command = commandTask.findCommand(request->getParam("id")->value().toInt());
+    if (!command) {
+      sendErrorResponse(request, 404, "Unknown command id");
+      return;
+    }
+  }
+  
+  AsyncResponseStream *response = beginJsonResponse(request);
+  JsonWriter json(*response);
+  if (command) {
+    commandTask.writeCommandJSON(json, *command);
   } else {
-    sendErrorResponse(request, 500, "Failed to generate test data");
-    Serial.printf("ERROR: Test data generation failed: %s\n", filename.c_str());
+    json.beginObject();
+    json.beginArray("commands");
+    commandTask.writeCommandsJSON(json);
+    json.endArray();
+    json.endObject();
   }
+  request->send(response);
 }
 
-void WebServerTask::sendErrorResponse(AsyncWebServerRequest *request, int code, const String& message) {
-  String json = "{\"error\":\"" + message + "\"}";
-  Serial.print(F("HTTP ERROR "));
-  Serial.print(code);
-  Serial.print(F(": "));
-  Serial.println(message);
-  request->send(code, "application/json", json);
+void WebServerTask::queueCommand(AsyncWebServerRequest *request, Command::Type type, uint8_t option,
+                                 const char* text) {
+  uint16_t id = commandTask.submit(type, option, text);
+  if (id == 0) {
+    sendErrorResponse(request, 503, "Command queue full");
+    return;
+  }
+  
+  AsyncResponseStream *response = beginJsonResponse(request, 202);
+  JsonWriter json(*response);
+  json.beginObject();
+  json.add("status", F("queued"));
+  json.add("id", id);
+  json.add("command", Command::typeName(type));
+  json.endObject();
+  request->send(response);
 }
 
-void WebServerTask::handleRecordStart(AsyncWebServerRequest *request) {
-  // Start recording via DataLoggingTask
-  dataLoggingTask.startRecording();
+void WebServerTask::handleSixPositionCalibrate(AsyncWebServerRequest *request) {
+  String action = "capture";
+  if (request->hasParam("action", true)) {
+    action = request->getParam("action", true)->value();
+  }
   
-  // Return response with current state
-  String json = "{";
-  json += "\"status\":\"ok\",";
-  json += "\"message\":\"Recording started\",";
-  json += "\"recording\":" + String(dataLoggingTask.isRecording() ? "true" : "false");
-  json += "}";
+  if (action == "start") {
+    mpusensorTask.startSixPositionCalibration();
+  } else if (action == "capture") {
+    if (!mpusensorTask.captureSixPosition()) {
+      sendErrorResponse(request, 409, "No six-position calibration in progress or capture already running");
+      return;
+    }
+  } else if (action == "cancel") {
+    mpusensorTask.cancelSixPositionCalibration();
+  } else {
+    sendErrorResponse(request, 400, "Invalid action. Use 'start', 'capture' or 'cancel'");
+    return;
+  }
   
-  sendJsonResponse(request, json);
-  Serial.println(F("WEB CONTROL: Recording started via web interface"));
+  debugOutput.print(F("WEB CONTROL: Six-position calibration action: "));
+  debugOutput.println(action);
+  handleSixPositionStatus(request);
 }
 
-void WebServerTask::handleRecordStop(AsyncWebServerRequest *request) {
-  // Stop recording via DataLoggingTask
-  dataLoggingTask.stopRecording();
+void WebServerTask::handleSixPositionStatus(AsyncWebServerRequest *request) {
+  AsyncResponseStream *response = beginJsonResponse(request);
+  JsonWriter json(*response);
+  json.beginObject();
+  json.add("status", F("ok"));
+  json.add("active", mpusensorTask.isSixPositionActive());
+  json.add("capturing", mpusensorTask.isCalibrating);
+  json.add("capturedMask", mpusensorTask.getSixPositionCapturedMask());
+  json.beginArray("accelScale");
+  json.value(mpusensorTask.accel_scale_x, 4).value(mpusensorTask.accel_scale_y, 4).value(mpusensorTask.accel_scale_z, 4);
+  json.endArray();
+  json.endObject();
+  request->send(response);
+}
+
+void WebServerTask::handleTemperatureCompensation(AsyncWebServerRequest *request) {
+  const TemperatureModel& model = mpusensorTask.getTemperatureModel();
+  const TemperatureCompData& data = model.getData();
   
-  // Return response with current state
-  String json = "{";
-  json += "\"status\":\"ok\",";
-  json += "\"message\":\"Recording stopped\",";
-  json += "\"recording\":" + String(dataLoggingTask.isRecording() ? "true" : "false");
-  json += "}";
+  AsyncResponseStream *response = beginJsonResponse(request);
+  JsonWriter json(*response);
+  json.beginObject();
+  json.add("temperature", mpusensorTask.temperature, 2);
+  json.add("active", mpusensorTask.isTemperatureCompensationActive());
+  json.add("order", model.getOrder());
+  json.add("calibrationTemp", data.calibrationTemp, 2);
+  json.add("referenceTemp", data.referenceTemp, 2);
+  json.beginArray("pointTemps");
+  for (uint8_t i = 0; i < data.pointCount; i++) {
+    json.value(data.pointTemp[i], 2);
+  }
+  json.endArray();
+  json.beginArray("coefficients");
+  for (uint8_t channel = 0; channel < TEMPCOMP_CHANNELS; channel++) {
+    json.beginArray();
+    for (uint8_t k = 0; k < TEMPCOMP_COEFFS; k++) {
+      json.value(data.coefficients[channel][k], 6);
+    }
+    json.endArray();
+  }
+  json.endArray();
+  json.endObject();
+  request->send(response);
+}
+
+void WebServerTask::handleSpectrum(AsyncWebServerRequest *request) {
+  AsyncResponseStream *response = beginJsonResponse(request);
+  JsonWriter json(*response);
+  json.beginObject();
+  spectrumTask.writeStatusJSON(json, SPECTRUM_API_MAX_BINS);
+  json.endObject();
+  request->send(response);
+}
+
+void WebServerTask::handleSelfTestResult(AsyncWebServerRequest *request, Command::Type type) {
+  const char* result = commandTask.getSelfTestResult(type);
+  if (result == nullptr) {
+    sendErrorResponse(request, 404, "No self-test result; POST to run one");
+    return;
+  }
   
-  sendJsonResponse(request, json);
-  Serial.println(F("WEB CONTROL: Recording stopped via web interface"));
+  AsyncResponseStream *response = beginJsonResponse(request);
+  response->print(result);
+  request->send(response);
 }
 
-void WebServerTask::handleCalibrate(AsyncWebServerRequest *request) {
-  // Start calibration via MPUSensorTask
-  mpusensorTask.startCalibration();
+void WebServerTask::handleHistogram(AsyncWebServerRequest *request) {
+  AsyncResponseStream *response = beginJsonResponse(request);
+  JsonWriter json(*response);
+  json.beginObject();
+  dataLoggingTask.writeHistogramJSON(json);
+  json.endObject();
+  request->send(response);
+}
+
+void WebServerTask::handleBurst(AsyncWebServerRequest *request) {
+  AsyncResponseStream *response = beginJsonResponse(request);
+  JsonWriter json(*response);
+  json.beginObject();
+  mpusensorTask.getBurst().writeStatusJSON(json);
+  json.endObject();
+  request->send(response);
+}
+
+void WebServerTask::handleBurstArm(AsyncWebServerRequest *request) {
+  if (!request->hasParam("action", true) || request->getParam("action", true)->value() != "arm") {
+    sendErrorResponse(request, 400, "Invalid action. Use 'arm'");
+    return;
+  }
+  
+  uint32_t durationMs = BURST_DEFAULT_DURATION_MS;
+  if (request->hasParam("durationMs", true)) {
+    durationMs = request->getParam("durationMs", true)->value().toInt();
+  }
   
-  // Return response
-  String json = "{";
-  json += "\"status\":\"ok\",";
-  json += "\"message\":\"Calibration started\"";
-  json += "}";
+  // Spectrum mode owns the sensor bandwidth; a recording or calibration owns acquisition
+  if (spectrumTask.isActive() || !mpusensorTask.armBurst(durationMs)) {
+    sendErrorResponse(request, 409, "Burst unavailable while recording, calibrating, in spectrum mode or during another burst");
+    return;
+  }
   
-  sendJsonResponse(request, json);
-  Serial.println(F("WEB CONTROL: Calibration started via web interface"));
+  debugOutput.println(F("WEB CONTROL: Burst capture armed"));
+  handleBurst(request);
+}
+
+void WebServerTask::handleRainflow(AsyncWebServerRequest *request) {
+  AsyncResponseStream *response = beginJsonResponse(request);
+  JsonWriter json(*response);
+  json.beginObject();
+  rainflowTask.writeStatusJSON(json);
+  json.endObject();
+  request->send(response);
+}
+
+void WebServerTask::handleFilters(AsyncWebServerRequest *request) {
+  AsyncResponseStream *response = beginJsonResponse(request);
+  JsonWriter json(*response);
+  json.beginObject();
+  mpusensorTask.writeFiltersJSON(json, false);
+  json.endObject();
+  request->send(response);
 }
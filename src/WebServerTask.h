@@ -3,6 +3,8 @@
 
 #include "Task.h"
 #include "Settings.h"
+#include "JsonWriter.h"
+#include "CommandQueue.h"
 #include <ESP8266WiFi.h>
 #include <ESPAsyncWebServer.h>
 #include <ESPAsyncTCP.h>
@@ -33,9 +35,13 @@ class WebServerTask : public Task {
     // API endpoints
     void handleRoot(AsyncWebServerRequest *request);
     void handleFileList(AsyncWebServerRequest *request);
+    void handleFileWindow(AsyncWebServerRequest *request);
+    void handleFileCsv(AsyncWebServerRequest *request);
+    void handleArchive(AsyncWebServerRequest *request);
     void handleFileData(AsyncWebServerRequest *request);
     void handleFileDelete(AsyncWebServerRequest *request);
     void handleSettings(AsyncWebServerRequest *request);
+    void handleSettingsUpdate(AsyncWebServerRequest *request);
     void handleStatus(AsyncWebServerRequest *request);
     void handleMeta(AsyncWebServerRequest *request);
     void handleTestData(AsyncWebServerRequest *request);
@@ -46,15 +52,41 @@ class WebServerTask : public Task {
     
     // Calibration control endpoint
     void handleCalibrate(AsyncWebServerRequest *request);
+    void handleCommands(AsyncWebServerRequest *request);
+    void handleSixPositionCalibrate(AsyncWebServerRequest *request);
+    void handleSixPositionStatus(AsyncWebServerRequest *request);
+    void handleTemperatureCompensation(AsyncWebServerRequest *request);
+    
+    // Filter chain endpoint
+    void handleFilters(AsyncWebServerRequest *request);
+    
+    // Last result of a self-test command, for GET /api/<filters|spectrum|rainflow>/selftest
+    void handleSelfTestResult(AsyncWebServerRequest *request, Command::Type type);
+    
+    // Vibration spectrum endpoints
+    void handleSpectrum(AsyncWebServerRequest *request);
+    
+    // Histogram logging endpoint
+    void handleHistogram(AsyncWebServerRequest *request);
+    
+    // Rainflow counting endpoints
+    void handleRainflow(AsyncWebServerRequest *request);
+    void handleBurst(AsyncWebServerRequest *request);
+    void handleBurstArm(AsyncWebServerRequest *request);
     
     // Static file serving
     void handleStaticFile(AsyncWebServerRequest *request, const String& filename);
     
+    // Serves a page, script or style compiled in by tools/embed_assets.py; false if there is none
+    bool sendWebAsset(AsyncWebServerRequest *request, const String& path);
+    
     // Utility methods
     String getContentType(const String& filename);
     bool fileExists(const String& filename);
     
   private:
+    static const size_t SETTINGS_BODY_MAX = Settings::JSON_MEMORY_ALLOC;  // Largest accepted POST /api/settings body
+    
     Settings& settings;
     DNSServer dnsServer;
     
@@ -69,13 +101,18 @@ class WebServerTask : public Task {
     bool apModeEnabled;
     
     // File management helpers
-    String listFiles();
+    void writeFileList(JsonWriter& json);
     String getFileContent(const String& filename);
     bool deleteFile(const String& filename);
     
     // Response helpers
-    void sendJsonResponse(AsyncWebServerRequest *request, const String& json);
-    void sendErrorResponse(AsyncWebServerRequest *request, int code, const String& message);
+    // JSON is written into the response stream as it is produced, never assembled in a String
+    AsyncResponseStream* beginJsonResponse(AsyncWebServerRequest *request, int code = 200);
+    void sendErrorResponse(AsyncWebServerRequest *request, int code, const char* message);
+    
+    // Hands the work to CommandTask and replies 202 with the command id
+    void queueCommand(AsyncWebServerRequest *request, Command::Type type, uint8_t option = 0,
+                      const char* text = nullptr);
     
     // Request logging
     void logRequest(AsyncWebServerRequest *request);
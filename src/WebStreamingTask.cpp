@@ -1,8 +1,12 @@
 #include "WebStreamingTask.h"
+#include "DebugOutput.h"
 #include "MPUSensorTask.h"
 #include "DataLoggingTask.h"
+#include "Settings.h"
 #include "constants.h"
 
+extern Settings settings;
+
 WebStreamingTask::WebStreamingTask(MPUSensorTask& mpuSensor, DataLoggingTask& dataLogger)
   : Task(), // Use default constructor
     mpuSensor(mpuSensor),
@@ -10,6 +14,7 @@ WebStreamingTask::WebStreamingTask(MPUSensorTask& mpuSensor, DataLoggingTask& da
     events(nullptr),
     lastBroadcast(0),
     broadcastInterval(100),
+    message(messageBuffer, sizeof(messageBuffer)),
     clientCount(0) {
   
   // Set the run interval for this specific task
@@ -49,22 +54,22 @@ void WebStreamingTask::setupEventSource(AsyncWebServer* server) {
   
   // Set up connection handler
   events->onConnect([this](AsyncEventSourceClient* client) {
-    Serial.println(F("EventSource client connected"));
+    debugOutput.println(F("EventSource client connected"));
     handleClientConnect(client);
     
     client->client()->onDisconnect([](void *arg, AsyncClient *c){
-        Serial.println("Client Disconnected");
+        debugOutput.println("Client Disconnected");
     }, nullptr);
     
     // Optional: Handle timeouts
     client->client()->onTimeout([](void *arg, AsyncClient *c, uint32_t time){
-        Serial.println("Client Timeout");
+        debugOutput.println("Client Timeout");
     }, nullptr);
   });
   
   // Add handler to server
   server->addHandler(events);
-  Serial.println(F("EventSource setup complete"));
+  debugOutput.println(F("EventSource setup complete"));
 }
 
 void WebStreamingTask::handleClientConnect(AsyncEventSourceClient* client) {
@@ -73,11 +78,16 @@ void WebStreamingTask::handleClientConnect(AsyncEventSourceClient* client) {
     sendInitialData(client);
     
     // Send connection acknowledgment with client count
-    String connectMsg = "{\"type\":\"connected\",\"message\":\"Real-time data streaming active\",\"clients\":" + String(clientCount) + "}";
-    client->send(connectMsg.c_str(), "connect", millis());
+    JsonWriter json(beginMessage());
+    json.beginObject();
+    json.add("type", F("connected"));
+    json.add("message", F("Real-time data streaming active"));
+    json.add("clients", clientCount);
+    json.endObject();
+    client->send(message.c_str(), "connect", millis());
     
-    Serial.print(F("Streaming client connected. Total clients: "));
-    Serial.println(clientCount);
+    debugOutput.print(F("Streaming client connected. Total clients: "));
+    debugOutput.println(clientCount);
   } else {
     // Send rejection message if max clients reached
     client->send("{\"type\":\"error\",\"message\":\"Maximum streaming clients reached\"}", "error", millis());
@@ -87,8 +97,8 @@ void WebStreamingTask::handleClientConnect(AsyncEventSourceClient* client) {
 
 void WebStreamingTask::handleClientDisconnect(AsyncEventSourceClient* client) {
   removeClient(client);
-  Serial.print(F("EventSource client disconnected. Total clients: "));
-  Serial.println(clientCount);
+  debugOutput.print(F("EventSource client disconnected. Total clients: "));
+  debugOutput.println(clientCount);
   
   // Broadcast updated client count to remaining clients
   if (clientCount > 0) {
@@ -96,23 +106,9 @@ void WebStreamingTask::handleClientDisconnect(AsyncEventSourceClient* client) {
   }
 }
 
-String WebStreamingTask::formatSensorData() {
-  return createJsonMessage();
-}
-
 void WebStreamingTask::broadcastSensorData() {
-  String jsonMessage = createJsonMessage();
-  
-  // Send to all connected clients with error handling
-  for (int i = 0; i < MAX_CLIENTS; i++) {
-    if (clients[i] != nullptr && clients[i]->connected()) {
-      // Check if send was successful by verifying client is still connected
-      clients[i]->send(jsonMessage.c_str(), "sensor_data", millis());
-      
-      // Update activity time on send attempt
-      lastActivityTime[i] = millis();
-    }
-  }
+  createJsonMessage();
+  broadcastMessage("sensor_data");
 }
 
 int WebStreamingTask::getConnectedClients() const {
@@ -121,36 +117,53 @@ int WebStreamingTask::getConnectedClients() const {
 
 void WebStreamingTask::sendInitialData(AsyncEventSourceClient* client) {
   // Send current sensor values and recording status
-  String initialJson = createJsonMessage();
-  client->send(initialJson.c_str(), "initial_data", millis());
-}
-
-String WebStreamingTask::formatFloat(float value, int decimalPlaces) {
-  char buffer[16];
-  dtostrf(value, 1, decimalPlaces, buffer);
-  return String(buffer);
-}
-
-String WebStreamingTask::createJsonMessage() {
-  String json = "{";
-  json += "\"timestamp\":" + String(millis()) + ",";
-  json += "\"accel\":{";
-  json += "\"x\":" + formatFloat(mpuSensor.accel_x, 2) + ",";
-  json += "\"y\":" + formatFloat(mpuSensor.accel_y, 2) + ",";
-  json += "\"z\":" + formatFloat(mpuSensor.accel_z, 2);
-  json += "},";
-  json += "\"orientation\":{";
-  json += "\"yaw\":" + formatFloat(mpuSensor.yaw, 1) + ",";
-  json += "\"pitch\":" + formatFloat(mpuSensor.pitch, 1) + ",";
-  json += "\"roll\":" + formatFloat(mpuSensor.roll, 1);
-  json += "},";
-  json += "\"recording\":" + String(dataLogger.isRecording() ? "true" : "false") + ",";
-  json += "\"calibrated\":" + String(mpuSensor.isCalibrated ? "true" : "false") + ",";
-  json += "\"calibrationStatus\":\"" + getCalibrationStatusString(mpuSensor.getCalibrationStatus()) + "\",";
-  json += "\"fifoCount\":" + String(mpuSensor.fifoCount);
-  json += "}";
-  
-  return json;
+  createJsonMessage();
+  client->send(message.c_str(), "initial_data", millis());
+}
+
+void WebStreamingTask::createJsonMessage() {
+  JsonWriter json(beginMessage());
+  json.beginObject();
+  writeSensorJSON(json);
+  json.endObject();
+}
+
+void WebStreamingTask::writeSensorJSON(JsonWriter& json) {
+  json.add("timestamp", millis());
+  // Only the channels selected by Settings::channelMask are streamed
+  const uint8_t mask = settings.channelMask;
+  if (mask & 0x07) {
+    json.beginObject("accel");
+    if (mask & 0x01) json.add("x", mpuSensor.accel_x, 2);
+    if (mask & 0x02) json.add("y", mpuSensor.accel_y, 2);
+    if (mask & 0x04) json.add("z", mpuSensor.accel_z, 2);
+    json.endObject();
+  }
+  if (mask & 0x38) {
+    json.beginObject("orientation");
+    if (mask & 0x08) json.add("yaw", mpuSensor.yaw, 1);
+    if (mask & 0x10) json.add("pitch", mpuSensor.pitch, 1);
+    if (mask & 0x20) json.add("roll", mpuSensor.roll, 1);
+    json.endObject();
+  }
+  json.add("recording", dataLogger.isRecording());
+  json.add("calibrated", mpuSensor.isCalibrated);
+  json.add("calibrationStatus", getCalibrationStatusString(mpuSensor.getCalibrationStatus()));
+  json.add("temperature", mpuSensor.temperature, 2);
+  json.beginObject("gyroBias");
+  json.add("x", mpuSensor.gyro_offset_x * RAD_TO_DEG, 3);
+  json.add("y", mpuSensor.gyro_offset_y * RAD_TO_DEG, 3);
+  json.add("z", mpuSensor.gyro_offset_z * RAD_TO_DEG, 3);
+  json.beginArray("drift");
+  json.value(mpuSensor.gyro_drift_x, 4).value(mpuSensor.gyro_drift_y, 4).value(mpuSensor.gyro_drift_z, 4);
+  json.endArray();
+  json.add("stationary", mpuSensor.isStationary());
+  json.endObject();
+  json.beginObject("sixPosition");
+  json.add("active", mpuSensor.isSixPositionActive());
+  json.add("capturedMask", mpuSensor.getSixPositionCapturedMask());
+  json.endObject();
+  json.add("fifoCount", mpuSensor.fifoCount);
 }
 
 void WebStreamingTask::cleanupDisconnectedClients() {
@@ -164,7 +177,7 @@ void WebStreamingTask::cleanupDisconnectedClients() {
       // Add timeout check - if client hasn't received data for CLIENT_TIMEOUT_MS
       if (!shouldRemove && lastActivityTime[i] > 0) {
         if (currentTime - lastActivityTime[i] > CLIENT_TIMEOUT_MS) {
-          Serial.println(F("Client timeout - removing inactive connection"));
+          debugOutput.println(F("Client timeout - removing inactive connection"));
           shouldRemove = true;
         }
       }
@@ -188,7 +201,7 @@ bool WebStreamingTask::addClient(AsyncEventSourceClient* client) {
   }
   
   // No empty slots available
-  Serial.println(F("Max streaming clients reached"));
+  debugOutput.println(F("Max streaming clients reached"));
   return false;
 }
 
@@ -206,7 +219,7 @@ void WebStreamingTask::removeClient(AsyncEventSourceClient* client) {
 void WebStreamingTask::forceDisconnectAll() {
   for (int i = 0; i < MAX_CLIENTS; i++) {
     if (clients[i] != nullptr) {
-      Serial.println(F("Force disconnecting existing streaming client"));
+      debugOutput.println(F("Force disconnecting existing streaming client"));
       clients[i]->close();
       removeClient(clients[i]);
     }
@@ -218,18 +231,40 @@ void WebStreamingTask::triggerCleanup() {
 }
 
 void WebStreamingTask::broadcastClientCount() {
-  String countMsg = "{\"type\":\"client_count\",\"count\":" + String(clientCount) + "}";
-  
-  // Send to all connected clients
+  JsonWriter json(beginMessage());
+  json.beginObject();
+  json.add("type", F("client_count"));
+  json.add("count", clientCount);
+  json.endObject();
+  broadcastMessage("client_count");
+}
+
+void WebStreamingTask::broadcastEvent(const char* message, const char* event) {
   for (int i = 0; i < MAX_CLIENTS; i++) {
     if (clients[i] != nullptr && clients[i]->connected()) {
-      clients[i]->send(countMsg.c_str(), "client_count", millis());
+      clients[i]->send(message, event, millis());
       lastActivityTime[i] = millis();
     }
   }
 }
 
-String WebStreamingTask::getCalibrationStatusString(CalibrationStatus status) {
+BufferPrint& WebStreamingTask::beginMessage() {
+  message.clear();
+  return message;
+}
+
+void WebStreamingTask::broadcastMessage(const char* event) {
+  if (message.overflowed()) {
+    Print& log = debugOutput.at(LOG_LEVEL_WARN);
+    log.print(F("Dropped oversized "));
+    log.print(event);
+    log.println(F(" event"));
+    return;
+  }
+  broadcastEvent(message.c_str(), event);
+}
+
+const char* WebStreamingTask::getCalibrationStatusString(CalibrationStatus status) {
   switch (status) {
     case UNCALIBRATED:
       return "Uncalibrated";
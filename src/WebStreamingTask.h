@@ -2,6 +2,7 @@
 #define WEB_STREAMING_TASK_H
 
 #include "Task.h"
+#include "JsonWriter.h"
 #include <ESPAsyncWebServer.h>
 #include <ESPAsyncTCP.h>
 
@@ -29,7 +30,7 @@ class WebStreamingTask : public Task {
     void handleClientDisconnect(AsyncEventSourceClient* client);
     
     // Data formatting
-    String formatSensorData();
+    void writeSensorJSON(JsonWriter& json);
     void broadcastSensorData();
     
     // Client management
@@ -38,6 +39,12 @@ class WebStreamingTask : public Task {
     void forceDisconnectAll();
     void triggerCleanup();
     void broadcastClientCount(); // Broadcast updated client count to all clients
+    void broadcastEvent(const char* message, const char* event); // Send a named event to all clients
+    
+    // Event messages are printed into one fixed buffer rather than built as Strings. beginMessage()
+    // clears it; broadcastMessage() sends it, or drops it if it did not fit.
+    BufferPrint& beginMessage();
+    void broadcastMessage(const char* event);
     
   private:
     MPUSensorTask& mpuSensor;
@@ -48,10 +55,13 @@ class WebStreamingTask : public Task {
     unsigned long lastBroadcast;
     unsigned long broadcastInterval;
     
+    // Shared message buffer
+    char messageBuffer[WEB_MESSAGE_BUFFER_BYTES];
+    BufferPrint message;
+    
     // Data formatting helpers
-    String formatFloat(float value, int decimalPlaces);
-    String createJsonMessage();
-    String getCalibrationStatusString(CalibrationStatus status);
+    void createJsonMessage();
+    const char* getCalibrationStatusString(CalibrationStatus status);
     
     // Client management
     static const int MAX_CLIENTS = WEB_CLIENT_MAX;
@@ -12,6 +12,28 @@
 #define MPU6050_GYRO_RANGE MPU6050_RANGE_500_DEG
 #define MPU6050_BANDWIDTH MPU6050_BAND_21_HZ
 
+// MPU6050 Register Access (raw integer reads on the sensor hot path)
+#define MPU6050_REG_ACCEL_XOUT_H 0x3B
+#define MPU6050_RAW_SAMPLE_BYTES 14      // accel(6) + temp(2) + gyro(6)
+#define MPU6050_ACCEL_LSB_PER_G 4096.0f  // Sensitivity at +/-8G
+#define MPU6050_GYRO_LSB_PER_DPS 65.5f   // Sensitivity at +/-500 deg/s
+#define MPU6050_TEMP_LSB_PER_C 340.0f    // Die temperature = raw / 340 + 36.53
+#define MPU6050_TEMP_OFFSET_C 36.53f
+#define MPU6050_REG_SMPLRT_DIV 0x19
+#define MPU6050_REG_FIFO_EN 0x23
+#define MPU6050_REG_USER_CTRL 0x6A
+#define MPU6050_REG_FIFO_COUNT_H 0x72
+#define MPU6050_REG_FIFO_R_W 0x74
+#define MPU6050_FIFO_EN_ACCEL_GYRO 0x78   // XG, YG, ZG and ACCEL into the FIFO, accel first
+#define MPU6050_USER_CTRL_FIFO_EN 0x40
+#define MPU6050_USER_CTRL_FIFO_RESET 0x04
+#define MPU6050_FIFO_SIZE 1024
+#define I2C_DEFAULT_CLOCK_HZ 100000UL
+
+// Fixed-point sample units produced by the sensor hot path
+#define ACCEL_FIXED_PER_G 10000     // 0.1 mG per count
+#define GYRO_FIXED_PER_DPS 100      // 0.01 deg/s per count
+
 // Task Mask Values (must be powers of 2)
 #define MPU_SENSOR_TASK_MASK 1      // 0b00000001
 #define BUTTON_CONTROL_TASK_MASK 2    // 0b00000010
@@ -19,11 +41,38 @@
 #define DATA_LOGGING_TASK_MASK 8    // 0b00001000
 #define WEB_SERVER_TASK_MASK 16      // 0b00010000
 #define WEB_STREAMING_TASK_MASK 32   // 0b00100000
+#define SPECTRUM_TASK_MASK 64        // 0b01000000
+#define RAINFLOW_TASK_MASK 128       // 0b10000000
+#define SERIAL_STREAM_TASK_MASK 256  // 0b100000000
+#define UDP_STREAM_TASK_MASK 512     // 0b1000000000
+#define STATUS_TASK_MASK 1024        // 0b10000000000
+#define COMMAND_TASK_MASK 2048       // 0b100000000000
 
 // SPIFFS Configuration
 #define SPIFFS_BLOCK_SIZE 256
 #define LOG_FILE_PREFIX "/mpulog"
 #define LOG_FILE_SUFFIX ".bin"
+#define LOG_TEMPERATURE_SUFFIX ".tmp"   // 1Hz temperature side channel next to each log file
+#define LOG_SPECTRUM_SUFFIX ".fft"      // Vibration spectra captured while recording
+#define LOG_INDEX_SUFFIX ".idx"         // Time index of raw log files
+#define LOG_INDEX_PAGE_INTERVAL 8       // Flushed pages between time index entries
+#define LOG_INDEX_DEFAULT_SPAN_MS 10000UL  // Window returned by /api/files/<name>/at without span=
+
+// Min/max pyramid sidecars of raw logs
+#define PYRAMID_LEVELS 3                // 1:16, 1:256 and 1:4096
+#define PYRAMID_FACTOR 16               // Samples per level 0 bucket, buckets per next level bucket
+#define PYRAMID_BUFFER_RECORDS 8        // Buffered buckets per level, one flash page
+#define PYRAMID_ACCEL_PER_G 1000        // mG, as summary records
+#define PYRAMID_GYRO_PER_DPS 10         // 0.1 deg/s, as summary records
+#define LOG_SUMMARY_SUFFIX ".sum"       // Summary logging mode, replaces LOG_FILE_SUFFIX
+#define LOG_HISTOGRAM_SUFFIX ".hst"     // Histogram logging mode, replaces LOG_FILE_SUFFIX
+#define LOG_PAGE_SIZE 256               // Packed records are buffered and written a page at a time
+#define LOG_CHANNELS_ALL 0x3F           // Accel X/Y/Z, gyro X/Y/Z (Settings::channelMask)
+#define LOG_HEADER_MAGIC 0xFFFE4C4DUL   // Never a plausible first timestamp, so legacy files stay headerless
+#define LOG_HEADER_VERSION 1
+#define LOG_LAYOUT_RECORDS 0            // MPULogHeader::layout, packed records one after another
+#define LOG_LAYOUT_COLUMNAR 1           // MPULogHeader::layout, per-page blocks of each field
+#define LOG_COLUMNAR_PAGE_HEADER 4      // uint16 record count + uint16 reserved ahead of each columnar page
 
 // Timing Configuration
 #define BUTTON_DEBOUNCE_MS 50
@@ -31,6 +80,148 @@
 #define CALIBRATION_SAMPLES 100
 #define CALIBRATION_HOLD_MS 3000   // 3 seconds
 
+// Boot Auto Calibration (Settings::autoCalibration)
+#define BOOT_CALIBRATION_SAMPLES 32              // Fast calibration: 32 samples...
+#define BOOT_CALIBRATION_INTERVAL_MS 10          // ...at 100Hz while waiting for stillness and sampling
+#define BOOT_CALIBRATION_TIMEOUT_MS 30000UL      // Give up and use the saved calibration after 30s
+#define BOOT_CALIBRATION_GYRO_THRESHOLD_DPS 0.2f // Only rewrite EEPROM if a gyro offset moved this far
+#define BOOT_CALIBRATION_LEVEL_TOLERANCE_G 0.1f  // Accel offsets are only taken if resting Z-up within this
+
+// Acquisition and Decimation (Settings::acquisitionRateHz, Settings::sampleRateMs)
+#define ACQUISITION_DEFAULT_RATE_HZ 100   // Internal sensor read rate
+#define ACQUISITION_MIN_RATE_HZ 10
+#define ACQUISITION_MAX_RATE_HZ 500
+#define DECIMATION_DEFAULT_ORDER 2        // CIC stages between acquisition and logging
+#define DECIMATION_MAX_ORDER 3
+#define DECIMATION_MAX_RATIO 64
+#define DECIMATION_MAX_GAIN 16384         // ratio^order; keeps +/-8G (80000 counts) * gain inside int32
+#define DECIMATION_TIMING_SAMPLES 1000    // Per-sample filter cost is averaged over this many samples
+
+// Biquad Filter Chain (Settings::filters), applied at the acquisition rate before decimation
+#define FILTER_MAX_SECTIONS 4             // Sections per channel
+#define FILTER_ALL_CHANNELS 0x3F          // Accel X/Y/Z and gyro X/Y/Z
+#define FILTER_FRACTION_BITS 6            // Extra precision carried through each section (+/-8G fits int32)
+#define FILTER_SELFTEST_AMPLITUDE 10000   // Test sine amplitude in fixed-point units (1G / 100 deg/s)
+#define FILTER_SELFTEST_SETTLE_SAMPLES 2000
+#define FILTER_SELFTEST_MEASURE_SAMPLES 2000  // Whole test periods up to this many are measured after settling
+
+// Six-Position Calibration
+#define SIXPOS_POSITION_COUNT 6
+#define SIXPOS_MIN_AXIS_G 0.8f        // Dominant axis must read at least 0.8G to identify the orientation
+#define SIXPOS_MAX_SCALE_ERROR 0.15f  // Reject fits where a scale factor is more than 15% from unity
+
+// Stillness Detection (fixed-point units, see ACCEL_FIXED_PER_G / GYRO_FIXED_PER_DPS)
+// Runs on the full-rate stream; sample counts are sized for the default 100Hz acquisition
+#define STILLNESS_ACCEL_TOLERANCE 500   // |a| within 0.05G of 1G
+#define STILLNESS_GYRO_MAX_RATE 500     // Every gyro axis below 5 deg/s after offset removal
+#define STILLNESS_GYRO_VARIANCE 2500    // Gyro variance below (0.5 deg/s)^2
+#define STILLNESS_EMA_SHIFT 6           // Mean/variance averaging window of ~64 samples (0.64s)
+#define STILLNESS_MIN_SAMPLES 200       // Consecutive still samples before declaring stillness (2s)
+
+// Gyro Bias Tracking
+#define GYRO_BIAS_TRACK_SHIFT 11                  // Bias EMA time constant of ~2048 still samples (20s)
+#define GYRO_DRIFT_WINDOW_MS 60000UL              // Drift rate is reported per minute
+#define GYRO_BIAS_PERSIST_INTERVAL_MS 1800000UL   // At most one EEPROM write every 30 minutes
+#define GYRO_BIAS_PERSIST_THRESHOLD_DPS 0.05f     // Only persist if the bias moved this far
+
+// Vibration Spectrum Mode
+#define SPECTRUM_DEFAULT_SIZE 256           // Samples per FFT frame (256, 512 or 1024)
+#define SPECTRUM_DEFAULT_RATE_HZ 200        // Acquisition rate while spectrum mode is enabled
+#define SPECTRUM_MIN_RATE_HZ 20
+#define SPECTRUM_MAX_RATE_HZ 500            // Limited by the I2C burst read time
+#define SPECTRUM_BANDWIDTH MPU6050_BAND_94_HZ  // Sensor DLPF while acquiring spectra
+#define SPECTRUM_SSE_MAX_BINS 64            // Bins are peak-held down to this for the "spectrum" event
+#define SPECTRUM_API_MAX_BINS 256           // ...and to this for GET /api/spectrum
+#define SPECTRUM_SELFTEST_FREQ_HZ 25.0f     // Self-test sine frequency (bin-centred for every size)
+#define SPECTRUM_SELFTEST_AMPLITUDE_G 0.25f
+
+// RAM burst capture
+#define BURST_RATE_HZ 1000                  // FIFO sample rate, DLPF on so SMPLRT_DIV 0 gives 1kHz
+#define BURST_BANDWIDTH MPU6050_BAND_184_HZ
+#define BURST_SAMPLE_BYTES 12               // FIFO accel(6) + gyro(6), no temperature
+#define BURST_DEFAULT_DURATION_MS 2000
+#define BURST_MAX_DURATION_MS 10000
+#define BURST_HEAP_RESERVE 8192             // Heap kept free for WiFi and the web server
+#define BURST_I2C_CLOCK_HZ 400000UL         // Fast mode, 1kHz of 12-byte samples needs it
+#define BURST_FIFO_READ_BYTES 120           // Whole samples per I2C read, within the Wire buffer
+#define BURST_WRITE_RECORDS 64              // Log records written per DataLoggingTask run
+
+// Binary Serial Streaming (Settings::serialStreamEnabled), frame layout in StreamFrame.h
+#define SERIAL_DEBUG_BAUD 115200
+#define SERIAL_STREAM_DEFAULT_BAUD 921600
+#define SERIAL_STREAM_MIN_BAUD 921600
+#define SERIAL_STREAM_MAX_BAUD 2000000
+#define STREAM_FRAME_SYNC 0xA55A            // Sent little-endian: 0x5A 0xA5, never valid ASCII text
+#define STREAM_FRAME_SAMPLES 1              // Payload is whole MPULogRecords
+#define STREAM_FRAME_TEXT 2                 // Payload is one line of debug output
+#define STREAM_BATCH_RECORDS 8              // Records per samples frame
+#define STREAM_BATCH_MAX_MS 50              // A partial batch is sent after this long
+#define STREAM_TEXT_MAX 120                 // Debug text per frame, longer lines are split
+#define STREAM_MAX_PAYLOAD 256              // STREAM_BATCH_RECORDS * sizeof(MPULogRecord)
+#define STREAM_TX_BUFFER_BYTES 2048         // Frames queued for the UART, whole frames are dropped when full
+
+// Debug Output (Settings::logLevel)
+#define LOG_LEVEL_ERROR 0
+#define LOG_LEVEL_WARN 1
+#define LOG_LEVEL_INFO 2                    // Plain debugOutput.print()
+#define LOG_LEVEL_DEBUG 3                   // Per-request, per-flush and button state chatter
+#define LOG_RING_BYTES 2048                 // Text waiting for the UART, lines are dropped when full
+
+// UDP Sample Streaming (Settings::udpStreamEnabled), datagrams are StreamFrame samples frames
+#define UDP_STREAM_DEFAULT_HOST "192.168.4.2"  // First DHCP lease of the access point
+#define UDP_STREAM_DEFAULT_PORT 5005
+#define UDP_BATCH_RECORDS 16                // Records per datagram
+#define UDP_BATCH_MAX_MS 100                // A partial batch is sent after this long
+#define UDP_RECORD_BYTES 32                 // sizeof(MPULogRecord)
+#define UDP_MAX_PAYLOAD 512                 // UDP_BATCH_RECORDS * UDP_RECORD_BYTES, well inside one MTU
+
+// System Status Snapshot (GET /api/status and the "status" event)
+#define STATUS_REFRESH_MS 1000              // Heap, CPU and client counts are sampled this often
+
+// Command Queue (web handlers -> CommandTask)
+#define COMMAND_QUEUE_SIZE 8                // Slots; one is kept free, so 7 commands can wait
+#define COMMAND_HISTORY 8                   // Finished commands kept for GET /api/commands
+#define COMMAND_TEXT_MAX 32                 // File name argument, including the terminator
+#define SELFTEST_RESULT_MAX 1536            // JSON of the last self-test command; four filter sections fit
+
+// CSV Export (GET /api/files/<name>.csv), the log is read LOG_PAGE_SIZE bytes at a time
+#define CSV_LINE_MAX 128                    // One formatted record; the longest is about 110 bytes
+
+// Logging Modes (Settings::logMode)
+#define LOG_MODE_RAW 0                    // One MPULogRecord per logged sample
+#define LOG_MODE_SUMMARY 1                // One MPUSummaryRecord per window of acquired samples
+#define LOG_MODE_HISTOGRAM 2              // One histogram snapshot per interval of acquired samples
+#define SUMMARY_DEFAULT_WINDOW_SEC 10
+#define SUMMARY_MIN_WINDOW_SEC 1
+#define SUMMARY_MAX_WINDOW_SEC 60
+#define SUMMARY_FIXED_PER_UNIT 10         // 0.1 mG -> mG and 0.01 deg/s -> 0.1 deg/s in summary records
+
+// Deadband Logging (Settings::deadbandEnabled), raw mode only
+#define DEADBAND_DEFAULT_ACCEL_G 0.02f        // Per accel axis
+#define DEADBAND_DEFAULT_GYRO_DPS 1.0f        // Per gyro axis
+#define DEADBAND_DEFAULT_HEARTBEAT_MS 10000UL // A record is written at least this often
+
+// Histogram Logging (Settings::histogramIntervalMin), bin widths in fixed-point units
+#define HISTOGRAM_BINS 32                 // Per channel
+#define HISTOGRAM_ACCEL_BIN_WIDTH 2500    // 0.25G: +/-4G per axis, 0-8G magnitude
+#define HISTOGRAM_GYRO_BIN_WIDTH 2500     // 25 deg/s: +/-400 deg/s
+#define HISTOGRAM_DEFAULT_INTERVAL_MIN 10
+#define HISTOGRAM_MIN_INTERVAL_MIN 1
+#define HISTOGRAM_MAX_INTERVAL_MIN 60
+
+// Rainflow Cycle Counting (Settings::rainflowEnabled), bin widths in fixed-point units
+#define RAINFLOW_RANGE_BINS 16
+#define RAINFLOW_RANGE_BIN_WIDTH 2500     // 0.25G or 25 deg/s: ranges up to 4G / 400 deg/s
+#define RAINFLOW_MEAN_BINS 16
+#define RAINFLOW_MEAN_BIN_WIDTH 5000      // 0.5G or 50 deg/s, centred on zero: means within +/-4G
+#define RAINFLOW_HYSTERESIS 200           // Reversals smaller than 0.02G / 2 deg/s are ignored
+#define RAINFLOW_STACK_SIZE 32            // Residual turning points before the oldest is closed
+#define RAINFLOW_DEFAULT_PERSIST_MIN 10   // Matrix is saved to flash this often while counting
+#define RAINFLOW_FILE "/rainflow.dat"
+#define RAINFLOW_FILE_MAGIC 0x52464C57    // "RFLW" in hex
+#define RAINFLOW_FILE_VERSION 1
+#define RAINFLOW_SELFTEST_SAMPLES 10000
+
 // Audio Feedback Frequencies (Hz)
 #define TONE_CALIBRATION_START 500
 #define TONE_CALIBRATION_COMPLETE 800
@@ -41,13 +232,29 @@
 
 // Memory Configuration
 #define WEB_CLIENT_MAX 4             // Maximum web streaming clients
+#define WEB_MESSAGE_BUFFER_BYTES 1400 // Event messages are built here; fits a 64-bin spectrum frame
 
 // EEPROM Configuration
 #define EEPROM_SIZE 512               // Total EEPROM size in bytes
 #define EEPROM_CAL_BASE_ADDR 0        // Calibration data base address
 #define EEPROM_CAL_MAGIC_NUMBER 0x43414C45  // "CALE" in hex
-#define EEPROM_CAL_VERSION 1          // Calibration data version
+#define EEPROM_CAL_VERSION 2          // Calibration data version (2 = offsets + per-axis accel scale)
+#define EEPROM_CAL_VERSION_LEGACY 1   // Offsets-only layout, migrated on load
 #define EEPROM_CAL_FLAG_VALID 0x01     // Bit 0: Valid calibration flag
+#define EEPROM_CAL_FLAG_SIXPOS 0x02    // Bit 1: Accel scale factors come from a six-position fit
+#define EEPROM_TEMPCOMP_BASE_ADDR 64        // Temperature compensation model base address
+#define EEPROM_TEMPCOMP_MAGIC_NUMBER 0x54434D50  // "TCMP" in hex
+#define EEPROM_TEMPCOMP_VERSION 1
+#define EEPROM_TEMPCOMP_FLAG_FITTED 0x01    // Bit 0: Coefficients hold a usable fit
+
+// Temperature Compensation
+#define TEMPCOMP_MAX_POINTS 8           // (temperature, bias) pairs kept from calibration sessions
+#define TEMPCOMP_CHANNELS 6             // Accel X/Y/Z, gyro X/Y/Z
+#define TEMPCOMP_COEFFS 3               // Up to a quadratic per channel
+#define TEMPCOMP_MERGE_C 1.0f           // A new point within 1C replaces the old one
+#define TEMPCOMP_MIN_SPAN_C 5.0f        // Points must span 5C before any fit is applied
+#define TEMPCOMP_QUADRATIC_SPAN_C 15.0f // ...and 15C (with 4+ points) for a quadratic term
+#define TEMPCOMP_UPDATE_MS 1000         // Corrections and the temperature log update at 1Hz
 
 // Calibration Status Enumeration
 enum CalibrationStatus {
@@ -0,0 +1,216 @@
+// Host benchmark of the CSV export behind GET /api/files/<name>.csv. Synthetic logs in each
+// layout (legacy records, packed records and columnar pages after an MPULogHeader) are built
+// in memory and converted by the firmware's own CsvEncoder in response-sized chunks, timing
+// bytes of CSV per second. The same records are also formatted with snprintf as a baseline,
+// and the two outputs are compared line by line.
+//
+// Build:  g++ -std=c++11 -O2 -I../src -o csv_benchmark csv_benchmark.cpp ../src/CsvEncoder.cpp
+// Usage:  ./csv_benchmark [records] [chunkBytes]
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "CsvEncoder.h"
+
+// Same layout as MPULogRecord, which needs the Arduino headers
+struct SyntheticRecord {
+  uint32_t timestamp;
+  float values[6];
+  uint8_t flags;
+  uint8_t padding;
+  uint16_t alignment;
+};
+
+class MemorySource : public CsvEncoder::Source {
+  public:
+    MemorySource(const std::vector<uint8_t>& data) : data(data) {}
+    
+    size_t read(uint8_t* buffer, size_t length) override {
+      if (length > data.size() - position) {
+        length = data.size() - position;
+      }
+      memcpy(buffer, data.data() + position, length);
+      position += length;
+      return length;
+    }
+  
+  private:
+    const std::vector<uint8_t>& data;
+    size_t position = 0;
+};
+
+static double secondsSince(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+static std::vector<SyntheticRecord> makeRecords(size_t count) {
+  std::vector<SyntheticRecord> records(count);
+  uint32_t timestamp = 12345;
+  for (size_t i = 0; i < count; i++) {
+    double t = i * 0.01;
+    SyntheticRecord& record = records[i];
+    memset(&record, 0, sizeof(record));
+    record.timestamp = timestamp;
+    record.values[0] = (float)(0.25 * sin(2 * M_PI * 25 * t));
+    record.values[1] = (float)(0.05 * cos(2 * M_PI * 3 * t) - 0.01);
+    record.values[2] = (float)(1.0 + 0.1 * sin(2 * M_PI * 7 * t));
+    record.values[3] = (float)(120.0 * sin(2 * M_PI * 0.5 * t));
+    record.values[4] = (float)(-45.5 + 3 * cos(2 * M_PI * 2 * t));
+    record.values[5] = (float)(0.3 * sin(2 * M_PI * 11 * t));
+    record.flags = i % 3 == 0 ? 3 : 1;
+    // 10ms with the odd late sample, as on the device
+    timestamp += i % 50 == 49 ? 11 : 10;
+  }
+  return records;
+}
+
+static void appendHeader(std::vector<uint8_t>& file, uint8_t layout) {
+  uint32_t magic = LOG_HEADER_MAGIC;
+  uint8_t rest[4] = { LOG_HEADER_VERSION, LOG_CHANNELS_ALL, 30, layout };
+  file.insert(file.end(), reinterpret_cast<uint8_t*>(&magic), reinterpret_cast<uint8_t*>(&magic) + 4);
+  file.insert(file.end(), rest, rest + 4);
+}
+
+static std::vector<uint8_t> makeLegacyLog(const std::vector<SyntheticRecord>& records) {
+  const uint8_t* data = reinterpret_cast<const uint8_t*>(records.data());
+  return std::vector<uint8_t>(data, data + records.size() * sizeof(SyntheticRecord));
+}
+
+static std::vector<uint8_t> makePackedLog(const std::vector<SyntheticRecord>& records) {
+  std::vector<uint8_t> file;
+  appendHeader(file, LOG_LAYOUT_RECORDS);
+  for (const SyntheticRecord& record : records) {
+    const uint8_t* data = reinterpret_cast<const uint8_t*>(&record);
+    file.insert(file.end(), data, data + 30);
+  }
+  return file;
+}
+
+static std::vector<uint8_t> makeColumnarLog(const std::vector<SyntheticRecord>& records) {
+  // MPULogHeader::columnarPageRecords(30)
+  const size_t pageRecords = 8;
+  std::vector<uint8_t> file;
+  appendHeader(file, LOG_LAYOUT_COLUMNAR);
+  for (size_t first = 0; first < records.size(); first += pageRecords) {
+    size_t count = std::min(pageRecords, records.size() - first);
+    uint16_t pageHeader[2] = { (uint16_t)count, 0 };
+    file.insert(file.end(), reinterpret_cast<uint8_t*>(pageHeader), reinterpret_cast<uint8_t*>(pageHeader) + 4);
+    for (size_t i = 0; i < count; i++) {
+      const uint8_t* data = reinterpret_cast<const uint8_t*>(&records[first + i].timestamp);
+      file.insert(file.end(), data, data + 4);
+    }
+    for (int c = 0; c < 6; c++) {
+      for (size_t i = 0; i < count; i++) {
+        const uint8_t* data = reinterpret_cast<const uint8_t*>(&records[first + i].values[c]);
+        file.insert(file.end(), data, data + 4);
+      }
+    }
+    for (size_t i = 0; i < count; i++) {
+      file.push_back(records[first + i].flags);
+    }
+  }
+  return file;
+}
+
+static std::string encode(const std::vector<uint8_t>& file, size_t chunkBytes, double& seconds) {
+  std::string csv;
+  csv.reserve(file.size() * 3);
+  std::vector<uint8_t> chunk(chunkBytes);
+  MemorySource source(file);
+  CsvEncoder encoder;
+  
+  auto start = std::chrono::steady_clock::now();
+  size_t length;
+  while ((length = encoder.fill(source, chunk.data(), chunk.size())) > 0) {
+    csv.append(reinterpret_cast<char*>(chunk.data()), length);
+  }
+  seconds = secondsSince(start);
+  return csv;
+}
+
+// The viewer's formatting, with printf's correctly rounded conversions
+static std::string reference(const std::vector<SyntheticRecord>& records, double& seconds) {
+  static const int decimals[6] = { 4, 4, 4, 2, 2, 2 };
+  std::string csv;
+  csv.reserve(records.size() * 80);
+  char line[160];
+  
+  auto start = std::chrono::steady_clock::now();
+  uint32_t previous = records.empty() ? 0 : records[0].timestamp;
+  for (const SyntheticRecord& record : records) {
+    int length = snprintf(line, sizeof(line), "%.3f,%.3f",
+                          (int32_t)(record.timestamp - records[0].timestamp) / 1000.0,
+                          (int32_t)(record.timestamp - previous) / 1000.0);
+    for (int c = 0; c < 6; c++) {
+      length += snprintf(line + length, sizeof(line) - length, ",%.*f", decimals[c], record.values[c]);
+    }
+    length += snprintf(line + length, sizeof(line) - length, ",%u\n", record.flags);
+    csv.append(line, length);
+    previous = record.timestamp;
+  }
+  seconds = secondsSince(start);
+  return csv;
+}
+
+static size_t countMismatches(const std::string& encoded, const std::string& expected) {
+  // The encoder's output starts with the column names
+  size_t a = encoded.find('\n') + 1;
+  size_t b = 0;
+  size_t mismatches = 0;
+  while (a < encoded.size() && b < expected.size()) {
+    size_t endA = encoded.find('\n', a);
+    size_t endB = expected.find('\n', b);
+    if (encoded.compare(a, endA - a, expected, b, endB - b) != 0) {
+      if (mismatches < 3) {
+        fprintf(stderr, "  got      %s\n  expected %s\n", encoded.substr(a, endA - a).c_str(),
+                expected.substr(b, endB - b).c_str());
+      }
+      mismatches++;
+    }
+    a = endA + 1;
+    b = endB + 1;
+  }
+  return mismatches + (a < encoded.size() || b < expected.size() ? 1 : 0);
+}
+
+int main(int argc, char** argv) {
+  size_t recordCount = argc > 1 ? strtoul(argv[1], nullptr, 10) : 200000;
+  size_t chunkBytes = argc > 2 ? strtoul(argv[2], nullptr, 10) : 1436;
+  if (recordCount == 0 || chunkBytes == 0) {
+    fprintf(stderr, "Usage: %s [records] [chunkBytes]\n", argv[0]);
+    return 1;
+  }
+  
+  std::vector<SyntheticRecord> records = makeRecords(recordCount);
+  double referenceSeconds;
+  std::string expected = reference(records, referenceSeconds);
+  printf("%zu records, %zu byte chunks\n", recordCount, chunkBytes);
+  printf("%-10s %10s %12s %10s %14s %10s\n", "layout", "log bytes", "CSV bytes", "seconds", "CSV bytes/s", "mismatches");
+  printf("%-10s %10s %12zu %10.3f %14.0f %10s\n", "snprintf", "-", expected.size(), referenceSeconds,
+         expected.size() / referenceSeconds, "-");
+  
+  struct { const char* name; std::vector<uint8_t> file; } logs[] = {
+    { "legacy", makeLegacyLog(records) },
+    { "packed", makePackedLog(records) },
+    { "columnar", makeColumnarLog(records) },
+  };
+  
+  int failures = 0;
+  for (auto& log : logs) {
+    double seconds;
+    std::string csv = encode(log.file, chunkBytes, seconds);
+    size_t mismatches = countMismatches(csv, expected);
+    printf("%-10s %10zu %12zu %10.3f %14.0f %10zu\n", log.name, log.file.size(), csv.size(), seconds,
+           csv.size() / seconds, mismatches);
+    if (mismatches > 0) {
+      failures++;
+    }
+  }
+  return failures > 0 ? 1 : 0;
+}
@@ -0,0 +1,175 @@
+// Host benchmark and response check of the CIC decimator between acquisition and logging. For
+// each order and ratio, the firmware's own Decimator is timed per pushed sample (all six
+// channels) and its response is checked:
+//   - DC: a constant input comes out unchanged, including negative and full-scale values
+//   - nulls: a sine at 1x and 2x the output rate is removed (it would alias onto DC)
+//   - passband: the gain at 1/8 and 1/4 of the output rate matches sinc^order
+// Orders that configure() reduces to keep ratio^order within DECIMATION_MAX_GAIN are reported
+// with the order actually used. Exits non-zero if any check fails.
+//
+// Build:  g++ -std=c++11 -O2 -Isrc -o decimator_benchmark tools/decimator_benchmark.cpp src/Decimator.cpp
+// Usage:  ./decimator_benchmark [samples]
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "Decimator.h"
+
+static const double SINE_AMPLITUDE = 10000;     // Fixed-point units (1G / 100 deg/s)
+static const int32_t MAX_NULL_RESIDUAL = 1;     // Counts left of a sine at a null
+static const double MAX_PASSBAND_ERROR = 0.002; // Relative to the sinc^order gain
+static const uint16_t SETTLE_OUTPUTS = DECIMATION_MAX_ORDER + 1;
+
+static double secondsSince(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Pushes input samples (the same value on every channel) and returns the channel 0 outputs
+static std::vector<int32_t> run(Decimator& decimator, const std::vector<int32_t>& input) {
+  std::vector<int32_t> outputs;
+  int32_t in[Decimator::CHANNELS], out[Decimator::CHANNELS];
+  for (int32_t value : input) {
+    for (uint8_t c = 0; c < Decimator::CHANNELS; c++) {
+      in[c] = value;
+    }
+    if (decimator.push(in, out)) {
+      outputs.push_back(out[0]);
+    }
+  }
+  return outputs;
+}
+
+// cyclesPerSample: sine frequency as a fraction of the input rate
+static std::vector<int32_t> makeSine(size_t count, double cyclesPerSample) {
+  std::vector<int32_t> input(count);
+  for (size_t i = 0; i < count; i++) {
+    // Offset so a sine at the input Nyquist rate is not sampled at its zero crossings
+    input[i] = (int32_t)lround(SINE_AMPLITUDE * sin(2 * M_PI * cyclesPerSample * i + 0.3));
+  }
+  return input;
+}
+
+static bool checkDC(uint8_t order, uint16_t ratio) {
+  // The sensor's full scale in fixed-point units is about +/-80000
+  const int32_t levels[] = { 0, 1, -1, 12345, -54321, 80000, -80000 };
+  for (int32_t level : levels) {
+    Decimator decimator;
+    decimator.configure(order, ratio);
+    std::vector<int32_t> outputs = run(decimator, std::vector<int32_t>((SETTLE_OUTPUTS + 4) * ratio, level));
+    for (size_t i = SETTLE_OUTPUTS; i < outputs.size(); i++) {
+      if (outputs[i] != level) {
+        printf("    DC %d came out as %d\n", level, outputs[i]);
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+static int32_t nullResidual(uint8_t order, uint16_t ratio, uint8_t multiple) {
+  Decimator decimator;
+  decimator.configure(order, ratio);
+  std::vector<int32_t> outputs = run(decimator, makeSine((SETTLE_OUTPUTS + 32) * ratio, (double)multiple / ratio));
+  int32_t residual = 0;
+  for (size_t i = SETTLE_OUTPUTS; i < outputs.size(); i++) {
+    residual = std::max(residual, std::abs(outputs[i]));
+  }
+  return residual;
+}
+
+// Gain at fraction of the output rate, from the output's correlation with a sine and cosine
+// over whole periods (the decimator's delay only shifts the phase)
+static double measuredGain(uint8_t order, uint16_t ratio, uint8_t divisor) {
+  const size_t periods = 16;
+  Decimator decimator;
+  decimator.configure(order, ratio);
+  std::vector<int32_t> outputs = run(decimator, makeSine((SETTLE_OUTPUTS + periods * divisor) * ratio,
+                                                         1.0 / (divisor * ratio)));
+  double re = 0, im = 0;
+  for (size_t i = 0; i < periods * divisor; i++) {
+    double phase = 2 * M_PI * i / divisor;
+    re += outputs[SETTLE_OUTPUTS + i] * cos(phase);
+    im += outputs[SETTLE_OUTPUTS + i] * sin(phase);
+  }
+  return 2 * sqrt(re * re + im * im) / (periods * divisor) / SINE_AMPLITUDE;
+}
+
+static double expectedGain(uint8_t order, uint16_t ratio, uint8_t divisor) {
+  double f = 1.0 / (divisor * ratio);
+  return pow(fabs(sin(M_PI * f * ratio) / (ratio * sin(M_PI * f))), order);
+}
+
+static double timePush(uint8_t order, uint16_t ratio, size_t samples) {
+  Decimator decimator;
+  decimator.configure(order, ratio);
+  int32_t in[Decimator::CHANNELS], out[Decimator::CHANNELS] = { 0 };
+  volatile int32_t sink = 0;
+  
+  auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < samples; i++) {
+    for (uint8_t c = 0; c < Decimator::CHANNELS; c++) {
+      in[c] = (int32_t)((i * 2654435761u + c) >> 15) - 65536;
+    }
+    if (decimator.push(in, out)) {
+      sink += out[0];
+    }
+  }
+  return secondsSince(start) * 1e9 / samples;
+}
+
+int main(int argc, char** argv) {
+  size_t samples = argc > 1 ? strtoul(argv[1], nullptr, 10) : 5000000;
+  if (samples == 0) {
+    fprintf(stderr, "Usage: %s [samples]\n", argv[0]);
+    return 1;
+  }
+  
+  const uint16_t ratios[] = { 2, 4, 5, 10, 20, 25, 50, 64 };
+  int failures = 0;
+  printf("%5s %5s %5s %10s %4s %12s %12s %10s %10s\n", "order", "ratio", "used", "ns/sample", "DC",
+         "null 1x/2x", "gain fo/8", "expected", "result");
+  
+  for (uint8_t order = 1; order <= DECIMATION_MAX_ORDER; order++) {
+    for (uint16_t ratio : ratios) {
+      Decimator decimator;
+      decimator.configure(order, ratio);
+      uint8_t used = decimator.getOrder();
+      
+      bool dc = checkDC(used, ratio);
+      int32_t null1 = nullResidual(used, ratio, 1);
+      int32_t null2 = ratio >= 4 ? nullResidual(used, ratio, 2) : 0;
+      bool nulls = null1 <= MAX_NULL_RESIDUAL && null2 <= MAX_NULL_RESIDUAL;
+      
+      bool passband = true;
+      double gain8 = 0, expected8 = 0;
+      const uint8_t divisors[] = { 8, 4 };
+      for (uint8_t divisor : divisors) {
+        double gain = measuredGain(used, ratio, divisor);
+        double expected = expectedGain(used, ratio, divisor);
+        if (fabs(gain - expected) > MAX_PASSBAND_ERROR * expected) {
+          printf("    gain at 1/%u of the output rate %.5f, expected %.5f\n", divisor, gain, expected);
+          passband = false;
+        }
+        if (divisor == 8) {
+          gain8 = gain;
+          expected8 = expected;
+        }
+      }
+      
+      bool ok = dc && nulls && passband;
+      printf("%5u %5u %5u %10.2f %4s %5d/%-6d %12.5f %10.5f %10s\n", order, ratio, used,
+             timePush(order, ratio, samples), dc ? "ok" : "FAIL", null1, null2, gain8, expected8,
+             ok ? "ok" : "FAIL");
+      if (!ok) {
+        failures++;
+      }
+    }
+  }
+  
+  printf(failures > 0 ? "%d configuration(s) failed\n" : "All checks passed\n", failures);
+  return failures > 0 ? 1 : 0;
+}
@@ -0,0 +1,88 @@
+#!/usr/bin/env python3
+# Compresses the web interface in data/ into src/WebAssetData.h, which is compiled into flash
+# and served by WebServerTask without touching SPIFFS. Each asset is gzipped once here (with a
+# zero timestamp, so unchanged files give an unchanged header) and given an ETag from its
+# contents, so browsers can revalidate with If-None-Match and get a 304.
+#
+# Run after changing anything in data/ and commit the regenerated header:
+#   python3 tools/embed_assets.py
+
+import gzip
+import hashlib
+import os
+import sys
+
+ROOT = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..")
+DATA_DIR = os.path.join(ROOT, "data")
+OUTPUT = os.path.join(ROOT, "src", "WebAssetData.h")
+
+CONTENT_TYPES = {
+    ".htm": "text/html",
+    ".html": "text/html",
+    ".css": "text/css",
+    ".js": "application/javascript",
+    ".png": "image/png",
+    ".ico": "image/x-icon",
+    ".json": "application/json",
+}
+
+# Pages are always revalidated so a firmware update shows at once; the scripts and styles they
+# load are cached for a day
+PAGE_MAX_AGE = 0
+ASSET_MAX_AGE = 86400
+
+
+def c_string(text):
+    return '"' + text.replace("\\", "\\\\").replace('"', '\\"') + '"'
+
+
+def main():
+    names = sorted(n for n in os.listdir(DATA_DIR) if os.path.splitext(n)[1] in CONTENT_TYPES)
+    lines = [
+        "// Generated by tools/embed_assets.py from data/. Do not edit: change data/ and run",
+        "// the script again.",
+        "#ifndef WEB_ASSET_DATA_H",
+        "#define WEB_ASSET_DATA_H",
+        "",
+        '#include "WebAssets.h"',
+        "",
+    ]
+    table = []
+    total = 0
+
+    for i, name in enumerate(names):
+        with open(os.path.join(DATA_DIR, name), "rb") as f:
+            raw = f.read()
+        packed = gzip.compress(raw, compresslevel=9, mtime=0)
+        etag = '"' + hashlib.sha1(packed).hexdigest()[:16] + '"'
+        extension = os.path.splitext(name)[1]
+        max_age = PAGE_MAX_AGE if CONTENT_TYPES[extension] == "text/html" else ASSET_MAX_AGE
+        total += len(packed)
+
+        lines.append("// %s: %d bytes, %d gzipped" % (name, len(raw), len(packed)))
+        lines.append("static const char webAssetPath%d[] PROGMEM = %s;" % (i, c_string("/" + name)))
+        lines.append("static const char webAssetType%d[] PROGMEM = %s;" % (i, c_string(CONTENT_TYPES[extension])))
+        lines.append("static const char webAssetETag%d[] PROGMEM = %s;" % (i, c_string(etag)))
+        lines.append("static const uint8_t webAssetData%d[] PROGMEM = {" % i)
+        for offset in range(0, len(packed), 16):
+            lines.append("  " + ",".join("0x%02x" % b for b in packed[offset:offset + 16]) + ",")
+        lines.append("};")
+        lines.append("")
+        table.append("  { webAssetPath%d, webAssetType%d, webAssetETag%d, webAssetData%d, %d, %d },"
+                     % (i, i, i, i, len(packed), max_age))
+
+    lines.append("// %d assets, %d bytes of flash" % (len(names), total))
+    lines.append("static const WebAsset webAssetTable[] = {")
+    lines.extend(table)
+    lines.append("};")
+    lines.append("")
+    lines.append("#endif")
+
+    with open(OUTPUT, "w") as f:
+        f.write("\n".join(lines) + "\n")
+    print("Wrote %s: %d assets, %d bytes gzipped" % (os.path.relpath(OUTPUT, ROOT), len(names), total),
+          file=sys.stderr)
+
+
+if __name__ == "__main__":
+    main()
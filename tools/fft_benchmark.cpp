@@ -0,0 +1,146 @@
+// Host benchmark and accuracy check of the fixed-point FFT behind spectrum mode. Each frame size
+// the firmware supports for spectra (256, 512, 1024) is timed over many transforms, and known
+// sines in raw accelerometer counts are run through the same chain as SpectrumTask::processAxis
+// (mean removal, Hann window, normalize, transform, magnitude) to check that the peak lands in
+// the right bin with the right amplitude. Exits non-zero if any check fails.
+//
+// Build:  g++ -std=c++11 -O2 -Isrc -o fft_benchmark tools/fft_benchmark.cpp src/FixedFFT.cpp
+// Usage:  ./fft_benchmark [iterations]
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "FixedFFT.h"
+#include "constants.h"
+
+// Allowed amplitude error for a bin-centred sine, and for one near the bottom of the range
+static const double MAX_ERROR_PERCENT = 1.0;
+static const double MAX_SMALL_ERROR_PERCENT = 5.0;
+
+struct SineCase {
+  const char* name;
+  double amplitudeG;
+  uint16_t bin256;      // Bin at N = 256; the same frequency is bin * N / 256 at larger sizes
+};
+
+static const SineCase CASES[] = {
+  { "self-test", SPECTRUM_SELFTEST_AMPLITUDE_G, 32 },   // 25Hz at 200Hz, as /api/spectrum/selftest
+  { "low", 0.5, 3 },
+  { "high", 0.25, 120 },
+  { "full scale", 6.5, 50 },
+  { "small", 0.02, 64 },
+};
+
+static double secondsSince(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// SpectrumTask::processAxis up to the magnitude, returning single-sided amplitudes in counts
+static void spectrum(const std::vector<int16_t>& samples, std::vector<double>& amplitude) {
+  const uint16_t n = samples.size();
+  std::vector<int16_t> re(n), im(n, 0);
+  std::vector<uint16_t> magnitude(n / 2);
+  
+  int32_t sum = 0;
+  for (int16_t sample : samples) {
+    sum += sample;
+  }
+  int16_t mean = sum / n;
+  for (uint16_t i = 0; i < n; i++) {
+    re[i] = samples[i] - mean;
+  }
+  
+  FixedFFT::applyHannWindow(re.data(), n);
+  int8_t exponent = FixedFFT::normalize(re.data(), n);
+  exponent += FixedFFT::transform(re.data(), im.data(), n);
+  FixedFFT::magnitude(re.data(), im.data(), magnitude.data(), n);
+  
+  // |X| * 2^exponent * 2 / (n * 0.5 Hann gain)
+  amplitude.resize(n / 2);
+  for (uint16_t k = 0; k < n / 2; k++) {
+    amplitude[k] = ldexp(magnitude[k], exponent + 2) / n;
+  }
+}
+
+static std::vector<int16_t> makeSine(uint16_t n, uint16_t bin, double amplitudeG) {
+  // On top of 1G, as the accelerometer reads at rest
+  std::vector<int16_t> samples(n);
+  for (uint16_t i = 0; i < n; i++) {
+    double g = 1.0 + amplitudeG * sin(2 * M_PI * bin * i / n);
+    samples[i] = (int16_t)lround(g * MPU6050_ACCEL_LSB_PER_G);
+  }
+  return samples;
+}
+
+static int checkAccuracy(uint16_t n) {
+  int failures = 0;
+  for (const SineCase& test : CASES) {
+    const uint16_t bin = test.bin256 * (n / 256);
+    std::vector<double> amplitude;
+    spectrum(makeSine(n, bin, test.amplitudeG), amplitude);
+    
+    uint16_t peakBin = 1;
+    for (uint16_t k = 1; k < n / 2; k++) {
+      if (amplitude[k] > amplitude[peakBin]) {
+        peakBin = k;
+      }
+    }
+    double expected = test.amplitudeG * MPU6050_ACCEL_LSB_PER_G;
+    double errorPercent = 100.0 * (amplitude[peakBin] - expected) / expected;
+    double limit = test.amplitudeG < 0.1 ? MAX_SMALL_ERROR_PERCENT : MAX_ERROR_PERCENT;
+    bool ok = peakBin == bin && fabs(errorPercent) <= limit;
+    
+    printf("  %-10s %5u %9.2fHz %10.1f %10.1f %9.2f%%  %s\n", test.name, peakBin,
+           peakBin * (double)SPECTRUM_DEFAULT_RATE_HZ / n, expected, amplitude[peakBin], errorPercent,
+           ok ? "ok" : "FAIL");
+    if (!ok) {
+      failures++;
+    }
+  }
+  return failures;
+}
+
+static void benchmark(uint16_t n, unsigned iterations) {
+  std::vector<int16_t> input = makeSine(n, 32 * (n / 256), SPECTRUM_SELFTEST_AMPLITUDE_G);
+  std::vector<int16_t> re(n), im(n);
+  std::vector<uint16_t> magnitude(n / 2);
+  volatile uint32_t sink = 0;
+  
+  auto start = std::chrono::steady_clock::now();
+  for (unsigned iteration = 0; iteration < iterations; iteration++) {
+    for (uint16_t i = 0; i < n; i++) {
+      re[i] = input[i] - (int16_t)MPU6050_ACCEL_LSB_PER_G;
+      im[i] = 0;
+    }
+    FixedFFT::applyHannWindow(re.data(), n);
+    FixedFFT::normalize(re.data(), n);
+    FixedFFT::transform(re.data(), im.data(), n);
+    FixedFFT::magnitude(re.data(), im.data(), magnitude.data(), n);
+    sink += magnitude[1];
+  }
+  double seconds = secondsSince(start);
+  printf("N=%-5u %8.2f us per axis (window, normalize, transform, magnitude), %u iterations\n", n,
+         seconds * 1e6 / iterations, iterations);
+}
+
+int main(int argc, char** argv) {
+  unsigned iterations = argc > 1 ? strtoul(argv[1], nullptr, 10) : 2000;
+  if (iterations == 0) {
+    fprintf(stderr, "Usage: %s [iterations]\n", argv[0]);
+    return 1;
+  }
+  
+  const uint16_t sizes[] = { 256, 512, 1024 };
+  int failures = 0;
+  for (uint16_t n : sizes) {
+    benchmark(n, iterations);
+    printf("  %-10s %5s %11s %10s %10s %10s\n", "sine", "bin", "peak", "expected", "measured", "error");
+    failures += checkAccuracy(n);
+  }
+  
+  printf(failures > 0 ? "%d check(s) failed\n" : "All checks passed\n", failures);
+  return failures > 0 ? 1 : 0;
+}
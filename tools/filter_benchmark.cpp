@@ -0,0 +1,161 @@
+// Host check and benchmark of the biquad filter chain. Each filter type is configured through
+// the firmware's own BiquadFilter and its magnitude response is compared at fixed frequencies
+// with reference gains that do not come from the firmware's coefficients: they are the analog
+// prototypes of the RBJ cookbook designs (1 / (s^2 + s/Q + 1) and its highpass, bandpass and
+// notch numerators) evaluated at the bilinear-warped frequency tan(pi f / fs) / tan(pi f0 / fs),
+// computed in double precision. Both the float design (designResponse) and the Q30 fixed-point
+// sections driven with a sine (measuredResponse) are checked. BiquadFilter::process is then
+// timed per sample for one to FILTER_MAX_SECTIONS sections on all six channels.
+// Exits non-zero if any check fails.
+//
+// Build:  g++ -std=c++11 -O2 -Isrc -o filter_benchmark tools/filter_benchmark.cpp src/BiquadFilter.cpp
+// Usage:  ./filter_benchmark [samples]
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+#include "BiquadFilter.h"
+
+static const float SAMPLE_RATE_HZ = 200.0f;
+
+// Allowed error against the reference, relative plus absolute (the latter for notch nulls)
+static const double DESIGN_TOLERANCE = 0.001;
+static const double MEASURED_TOLERANCE = 0.01;
+static const double ABSOLUTE_TOLERANCE = 0.002;
+
+struct ReferencePoint {
+  uint8_t type;
+  float frequencyHz;      // Section cutoff, centre or notch frequency
+  float q;
+  float testHz;
+  double gain;
+};
+
+static const ReferencePoint REFERENCE[] = {
+  { FILTER_LOWPASS, 10.0f, 0.7071f, 2.5f, 0.998111 },
+  { FILTER_LOWPASS, 10.0f, 0.7071f, 5.0f, 0.970839 },
+  { FILTER_LOWPASS, 10.0f, 0.7071f, 10.0f, 0.707100 },
+  { FILTER_LOWPASS, 10.0f, 0.7071f, 20.0f, 0.231177 },
+  { FILTER_LOWPASS, 10.0f, 0.7071f, 40.0f, 0.047469 },
+  // Poles close to z = 1, where the fixed-point rounding matters most
+  { FILTER_LOWPASS, 1.0f, 0.7071f, 0.5f, 0.970145 },
+  { FILTER_LOWPASS, 1.0f, 0.7071f, 1.0f, 0.707100 },
+  { FILTER_LOWPASS, 1.0f, 0.7071f, 2.0f, 0.242422 },
+  { FILTER_LOWPASS, 1.0f, 0.7071f, 4.0f, 0.062225 },
+  // Resonant, with a 6dB peak at the cutoff
+  { FILTER_LOWPASS, 40.0f, 2.0f, 10.0f, 1.043086 },
+  { FILTER_LOWPASS, 40.0f, 2.0f, 20.0f, 1.203859 },
+  { FILTER_LOWPASS, 40.0f, 2.0f, 40.0f, 2.000000 },
+  { FILTER_LOWPASS, 40.0f, 2.0f, 80.0f, 0.058561 },
+  { FILTER_HIGHPASS, 5.0f, 0.7071f, 1.25f, 0.062139 },
+  { FILTER_HIGHPASS, 5.0f, 0.7071f, 2.5f, 0.241830 },
+  { FILTER_HIGHPASS, 5.0f, 0.7071f, 5.0f, 0.707100 },
+  { FILTER_HIGHPASS, 5.0f, 0.7071f, 10.0f, 0.970839 },
+  { FILTER_HIGHPASS, 5.0f, 0.7071f, 20.0f, 0.998282 },
+  { FILTER_BANDPASS, 20.0f, 2.0f, 5.0f, 0.127606 },
+  { FILTER_BANDPASS, 20.0f, 2.0f, 10.0f, 0.304510 },
+  { FILTER_BANDPASS, 20.0f, 2.0f, 20.0f, 1.000000 },
+  { FILTER_BANDPASS, 20.0f, 2.0f, 40.0f, 0.269191 },
+  { FILTER_BANDPASS, 20.0f, 2.0f, 80.0f, 0.053305 },
+  { FILTER_NOTCH, 50.0f, 5.0f, 12.5f, 0.999143 },
+  { FILTER_NOTCH, 50.0f, 5.0f, 25.0f, 0.995037 },
+  { FILTER_NOTCH, 50.0f, 5.0f, 45.0f, 0.845567 },
+  { FILTER_NOTCH, 50.0f, 5.0f, 50.0f, 0.000000 },
+  { FILTER_NOTCH, 50.0f, 5.0f, 55.0f, 0.845567 },
+  { FILTER_NOTCH, 50.0f, 5.0f, 90.0f, 0.999473 },
+};
+
+static double secondsSince(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+static bool within(double value, double reference, double tolerance) {
+  return fabs(value - reference) <= tolerance * reference + ABSOLUTE_TOLERANCE;
+}
+
+static int checkResponse() {
+  int failures = 0;
+  printf("%-9s %7s %6s %8s %10s %10s %10s\n", "type", "f0 Hz", "Q", "test Hz", "reference", "design",
+         "measured");
+  for (const ReferencePoint& point : REFERENCE) {
+    FilterSectionConfig config;
+    config.type = point.type;
+    config.frequencyHz = point.frequencyHz;
+    config.q = point.q;
+    BiquadFilter filter;
+    if (filter.configure(&config, 1, SAMPLE_RATE_HZ) != 1) {
+      printf("%-9s %7.2f %6.4f rejected  FAIL\n", BiquadFilter::typeName(point.type), point.frequencyHz, point.q);
+      failures++;
+      continue;
+    }
+    
+    double design = filter.designResponse(0, point.testHz);
+    double measured = filter.measuredResponse(0, point.testHz);
+    bool ok = within(design, point.gain, DESIGN_TOLERANCE) && within(measured, point.gain, MEASURED_TOLERANCE);
+    printf("%-9s %7.2f %6.4f %8.2f %10.6f %10.6f %10.6f  %s\n", BiquadFilter::typeName(point.type),
+           point.frequencyHz, point.q, point.testHz, point.gain, design, measured, ok ? "ok" : "FAIL");
+    if (!ok) {
+      failures++;
+    }
+  }
+  return failures;
+}
+
+static int checkRejected() {
+  // Frequencies at or above Nyquist and non-positive Q cannot be designed
+  FilterSectionConfig configs[3];
+  configs[0].type = FILTER_LOWPASS;
+  configs[0].frequencyHz = SAMPLE_RATE_HZ / 2;
+  configs[1].type = FILTER_NOTCH;
+  configs[1].frequencyHz = 10.0f;
+  configs[1].q = 0;
+  configs[2].type = FILTER_HIGHPASS;
+  configs[2].frequencyHz = 10.0f;
+  BiquadFilter filter;
+  uint8_t active = filter.configure(configs, 3, SAMPLE_RATE_HZ);
+  bool ok = active == 1 && filter.getRejectedSections() == 0x03;
+  printf("Invalid sections rejected: %s\n", ok ? "ok" : "FAIL");
+  return ok ? 0 : 1;
+}
+
+static void benchmark(unsigned long samples) {
+  for (uint8_t count = 1; count <= FILTER_MAX_SECTIONS; count++) {
+    FilterSectionConfig configs[FILTER_MAX_SECTIONS];
+    for (uint8_t s = 0; s < count; s++) {
+      configs[s].type = s % 2 == 0 ? FILTER_LOWPASS : FILTER_NOTCH;
+      configs[s].frequencyHz = 10.0f + 10.0f * s;
+    }
+    BiquadFilter filter;
+    filter.configure(configs, count, SAMPLE_RATE_HZ);
+    
+    int32_t values[BiquadFilter::CHANNELS];
+    volatile int32_t sink = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (unsigned long i = 0; i < samples; i++) {
+      for (uint8_t c = 0; c < BiquadFilter::CHANNELS; c++) {
+        values[c] = (int32_t)((i * 2654435761u + c) >> 15) - 65536;
+      }
+      filter.process(values);
+      sink += values[0];
+    }
+    printf("%u section(s): %8.2f ns per sample (6 channels)\n", count, secondsSince(start) * 1e9 / samples);
+  }
+}
+
+int main(int argc, char** argv) {
+  unsigned long samples = argc > 1 ? strtoul(argv[1], nullptr, 10) : 2000000;
+  if (samples == 0) {
+    fprintf(stderr, "Usage: %s [samples]\n", argv[0]);
+    return 1;
+  }
+  
+  printf("Sample rate %.0fHz\n", SAMPLE_RATE_HZ);
+  int failures = checkResponse();
+  failures += checkRejected();
+  benchmark(samples);
+  
+  printf(failures > 0 ? "%d check(s) failed\n" : "All checks passed\n", failures);
+  return failures > 0 ? 1 : 0;
+}
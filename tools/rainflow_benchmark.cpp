@@ -0,0 +1,159 @@
+// Host check and benchmark of the streaming rainflow counter. The firmware's own RainflowCounter
+// is fed signals whose cycles are known and its matrix is compared with them:
+//   - the ASTM E1049 example sequence, whose only closed cycle is -1..3 (the rest stays in the
+//     residual, which the counter does not close at the end)
+//   - the /api/rainflow/selftest signal: a 1G-mean, 0.5G carrier with a 0.15G ripple after each
+//     peak, so every period is one 1G cycle and two 0.15G cycles
+//   - noise inside RAINFLOW_HYSTERESIS, which must count nothing
+//   - a growing oscillation that never closes a cycle, which must stay within the residual
+//     stack by closing its oldest points as half cycles
+// It then prints the counter's fixed memory and times add() per sample. Exits non-zero if any
+// check fails.
+//
+// Build:  g++ -std=c++11 -O2 -Isrc -o rainflow_benchmark tools/rainflow_benchmark.cpp src/RainflowCounter.cpp
+// Usage:  ./rainflow_benchmark [samples]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "RainflowCounter.h"
+
+static double secondsSince(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+static bool report(const char* name, bool ok) {
+  printf("%-44s %s\n", name, ok ? "ok" : "FAIL");
+  return ok;
+}
+
+// The /api/rainflow/selftest signal, in fixed-point units
+static std::vector<int32_t> makeCarrier(size_t samples) {
+  static const int8_t shape[20] = {
+    0, 3, 6, 8, 10, 8, 6, 9, 7, 3, 0, -3, -6, -8, -10, -8, -6, -9, -7, -3
+  };
+  std::vector<int32_t> signal(samples);
+  for (size_t i = 0; i < samples; i++) {
+    signal[i] = ACCEL_FIXED_PER_G + shape[i % 20] * (ACCEL_FIXED_PER_G / 20);
+  }
+  return signal;
+}
+
+static uint32_t halfCyclesInRange(const RainflowCounter& counter, uint8_t rangeBin) {
+  uint32_t halfCycles = 0;
+  for (uint8_t m = 0; m < RAINFLOW_MEAN_BINS; m++) {
+    halfCycles += counter.getHalfCycles(rangeBin, m);
+  }
+  return halfCycles;
+}
+
+static int checkAstmExample() {
+  // Scaled so a range of 1 is one range bin and a mean of 1 half a mean bin. The trailing 5
+  // confirms the final -2 as a turning point.
+  static const int8_t sequence[] = { -2, 1, -3, 5, -1, 3, -4, 4, -2, 5 };
+  RainflowCounter counter;
+  for (int8_t point : sequence) {
+    counter.add(point * RAINFLOW_RANGE_BIN_WIDTH);
+  }
+  
+  // -1..3: range 4, mean 1 -> 2500, the first mean bin above zero
+  uint8_t meanBin = RAINFLOW_MEAN_BINS / 2;
+  bool ok = counter.getTotalHalfCycles() == 2 && counter.getHalfCycles(4, meanBin) == 2 &&
+            counter.getResidualCount() == 7;
+  return report("ASTM E1049 example: one full cycle of range 4", ok) ? 0 : 1;
+}
+
+static int checkCarrier(size_t samples) {
+  RainflowCounter counter;
+  for (int32_t value : makeCarrier(samples)) {
+    counter.add(value);
+  }
+  
+  // Range 1G is bin 4, the 0.15G ripple bin 0. Depending on where the input stops, up to one
+  // large and two small cycles are still open, which holds at most six points in the residual.
+  const uint32_t periods = samples / 20;
+  uint32_t large = halfCyclesInRange(counter, ACCEL_FIXED_PER_G / RAINFLOW_RANGE_BIN_WIDTH);
+  uint32_t small = halfCyclesInRange(counter, 0);
+  printf("  %u periods: %.1f large cycles (expected %u), %.1f small (expected %u), residual %u\n", periods,
+         large / 2.0, periods, small / 2.0, 2 * periods, counter.getResidualCount());
+  
+  bool ok = large + small == counter.getTotalHalfCycles() &&
+            large % 2 == 0 && large / 2 <= periods && large / 2 + 1 >= periods &&
+            small % 2 == 0 && small / 2 <= 2 * periods && small / 2 + 2 >= 2 * periods &&
+            counter.getResidualCount() <= 6 && counter.getStackOverflows() == 0;
+  return report("Self-test signal: 1 large + 2 small per period", ok) ? 0 : 1;
+}
+
+static int checkHysteresis() {
+  RainflowCounter counter;
+  uint32_t seed = 1;
+  for (int i = 0; i < 10000; i++) {
+    seed = seed * 1103515245 + 12345;
+    counter.add(ACCEL_FIXED_PER_G + (int32_t)((seed >> 16) % RAINFLOW_HYSTERESIS) - RAINFLOW_HYSTERESIS / 2);
+  }
+  bool ok = counter.getTotalHalfCycles() == 0 && counter.getResidualCount() == 1;
+  return report("Noise within the hysteresis counts nothing", ok) ? 0 : 1;
+}
+
+static int checkStackBound() {
+  // Each reversal is larger than the last, so no cycle ever closes by the four-point rule
+  RainflowCounter counter;
+  const int turningPoints = 4 * RAINFLOW_STACK_SIZE;
+  for (int i = 1; i <= turningPoints + 1; i++) {
+    counter.add((i % 2 == 0 ? 1 : -1) * i * (RAINFLOW_HYSTERESIS * 2));
+  }
+  uint32_t overflows = counter.getStackOverflows();
+  bool ok = counter.getResidualPeak() == RAINFLOW_STACK_SIZE && overflows > 0 &&
+            counter.getTotalHalfCycles() == overflows &&
+            counter.getResidualCount() + overflows == (uint32_t)turningPoints;
+  printf("  %u turning points, residual peak %u, %u closed as half cycles\n", turningPoints,
+         counter.getResidualPeak(), overflows);
+  return report("Residual stays within RAINFLOW_STACK_SIZE", ok) ? 0 : 1;
+}
+
+static void benchmark(const char* name, const std::vector<int32_t>& signal) {
+  RainflowCounter counter;
+  auto start = std::chrono::steady_clock::now();
+  for (int32_t value : signal) {
+    counter.add(value);
+  }
+  double seconds = secondsSince(start);
+  printf("%-28s %8.2f ns per sample, %u half cycles\n", name, seconds * 1e9 / signal.size(),
+         counter.getTotalHalfCycles());
+}
+
+int main(int argc, char** argv) {
+  size_t samples = argc > 1 ? strtoul(argv[1], nullptr, 10) : 10000000;
+  if (samples < 20) {
+    fprintf(stderr, "Usage: %s [samples (at least 20)]\n", argv[0]);
+    return 1;
+  }
+  
+  int failures = checkAstmExample();
+  failures += checkCarrier(RAINFLOW_SELFTEST_SAMPLES);
+  failures += checkCarrier(RAINFLOW_SELFTEST_SAMPLES + 7);
+  failures += checkHysteresis();
+  failures += checkStackBound();
+  
+  printf("sizeof(RainflowCounter) = %u bytes (%u-bin matrix, %u-point residual)\n",
+         (unsigned)sizeof(RainflowCounter), RAINFLOW_RANGE_BINS * RAINFLOW_MEAN_BINS, RAINFLOW_STACK_SIZE);
+  
+  benchmark("Self-test signal", makeCarrier(samples));
+  
+  // Random steps of up to 0.5G: a turning point every few samples
+  std::vector<int32_t> walk(samples);
+  uint32_t seed = 7;
+  int32_t value = 0;
+  for (size_t i = 0; i < samples; i++) {
+    seed = seed * 1103515245 + 12345;
+    value += (int32_t)((seed >> 16) % ACCEL_FIXED_PER_G) - ACCEL_FIXED_PER_G / 2;
+    value = value > 4 * ACCEL_FIXED_PER_G ? 4 * ACCEL_FIXED_PER_G : value < -4 * ACCEL_FIXED_PER_G ? -4 * ACCEL_FIXED_PER_G : value;
+    walk[i] = value;
+  }
+  benchmark("Random walk", walk);
+  
+  printf(failures > 0 ? "%d check(s) failed\n" : "All checks passed\n", failures);
+  return failures > 0 ? 1 : 0;
+}
@@ -0,0 +1,210 @@
+// Host-side capture tool for the binary serial stream (Settings::serialStreamEnabled).
+//
+// Reads frames (see src/StreamFrame.h) from a serial port, or from a file or pty standing in
+// for one, writes the sample records to a standard .bin log and prints the device's debug
+// text frames to stderr. Frames with a bad CRC are skipped by searching for the next sync
+// word; gaps in the sequence numbers are counted as dropped frames.
+//
+// Build:  g++ -std=c++11 -O2 -I../src -o serial_capture serial_capture.cpp
+// Usage:  ./serial_capture /dev/ttyUSB0 capture.bin [baud]
+//         ./serial_capture recorded-stream.raw capture.bin
+
+#include <cerrno>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include <fcntl.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include "StreamFrame.h"
+
+static const size_t RECORD_SIZE = 32;  // sizeof(MPULogRecord)
+
+static volatile sig_atomic_t stopRequested = 0;
+
+struct CaptureStats {
+  unsigned long bytesRead = 0;
+  unsigned long bytesSkipped = 0;
+  unsigned long frames = 0;
+  unsigned long sampleFrames = 0;
+  unsigned long textFrames = 0;
+  unsigned long records = 0;
+  unsigned long crcErrors = 0;
+  unsigned long droppedFrames = 0;
+};
+
+static void onSignal(int) {
+  stopRequested = 1;
+}
+
+static speed_t baudConstant(unsigned long baud) {
+  switch (baud) {
+    case 115200: return B115200;
+    case 230400: return B230400;
+    case 460800: return B460800;
+    case 921600: return B921600;
+#ifdef B1000000
+    case 1000000: return B1000000;
+    case 1500000: return B1500000;
+    case 2000000: return B2000000;
+#endif
+    default: return 0;
+  }
+}
+
+// Raw 8N1 at baud; returns false for files and ptys that are not real ttys, which is fine
+static bool configurePort(int fd, unsigned long baud) {
+  if (!isatty(fd)) {
+    return false;
+  }
+  struct termios tty;
+  if (tcgetattr(fd, &tty) != 0) {
+    return false;
+  }
+  cfmakeraw(&tty);
+  tty.c_cflag |= CLOCAL | CREAD;
+  tty.c_cc[VMIN] = 1;
+  tty.c_cc[VTIME] = 0;
+  speed_t speed = baudConstant(baud);
+  if (speed == 0) {
+    fprintf(stderr, "Unsupported baud rate %lu\n", baud);
+    return false;
+  }
+  cfsetispeed(&tty, speed);
+  cfsetospeed(&tty, speed);
+  return tcsetattr(fd, TCSANOW, &tty) == 0;
+}
+
+static void printStats(const CaptureStats& stats) {
+  unsigned long expected = stats.frames + stats.droppedFrames;
+  fprintf(stderr, "\nBytes read:      %lu\n", stats.bytesRead);
+  fprintf(stderr, "Frames:          %lu (%lu samples, %lu text)\n",
+          stats.frames, stats.sampleFrames, stats.textFrames);
+  fprintf(stderr, "Records written: %lu\n", stats.records);
+  fprintf(stderr, "Dropped frames:  %lu (%.2f%%)\n", stats.droppedFrames,
+          expected > 0 ? 100.0 * stats.droppedFrames / expected : 0.0);
+  fprintf(stderr, "CRC errors:      %lu\n", stats.crcErrors);
+  fprintf(stderr, "Bytes skipped:   %lu\n", stats.bytesSkipped);
+}
+
+// Parses every complete frame at the start of buffer and removes the bytes it consumed
+static void parseFrames(std::vector<uint8_t>& buffer, FILE* out, CaptureStats& stats,
+                        bool& haveSequence, uint16_t& nextSequence) {
+  const uint8_t syncLow = STREAM_FRAME_SYNC & 0xFF;
+  const uint8_t syncHigh = STREAM_FRAME_SYNC >> 8;
+  size_t pos = 0;
+
+  while (buffer.size() - pos >= sizeof(StreamFrameHeader)) {
+    if (buffer[pos] != syncLow || buffer[pos + 1] != syncHigh) {
+      pos++;
+      stats.bytesSkipped++;
+      continue;
+    }
+
+    StreamFrameHeader header;
+    memcpy(&header, &buffer[pos], sizeof(header));
+    if (header.length > STREAM_MAX_PAYLOAD ||
+        (header.type != STREAM_FRAME_SAMPLES && header.type != STREAM_FRAME_TEXT)) {
+      pos++;
+      stats.bytesSkipped++;
+      continue;
+    }
+
+    size_t frameSize = sizeof(header) + header.length + sizeof(uint16_t);
+    if (buffer.size() - pos < frameSize) {
+      break;  // Wait for the rest of the frame
+    }
+
+    const uint8_t* payload = &buffer[pos + sizeof(header)];
+    uint16_t crc = streamFrameCRC(0xFFFF, &buffer[pos], sizeof(header) + header.length);
+    uint16_t frameCRC = payload[header.length] | (payload[header.length + 1] << 8);
+    if (crc != frameCRC) {
+      stats.crcErrors++;
+      pos++;
+      stats.bytesSkipped++;
+      continue;
+    }
+
+    if (haveSequence) {
+      stats.droppedFrames += (uint16_t)(header.sequence - nextSequence);
+    }
+    haveSequence = true;
+    nextSequence = header.sequence + 1;
+    stats.frames++;
+
+    if (header.type == STREAM_FRAME_SAMPLES) {
+      size_t records = header.length / RECORD_SIZE;
+      fwrite(payload, RECORD_SIZE, records, out);
+      stats.records += records;
+      stats.sampleFrames++;
+    } else {
+      fprintf(stderr, "[device] %.*s", (int)header.length, (const char*)payload);
+      if (header.length == 0 || payload[header.length - 1] != '\n') {
+        fputc('\n', stderr);
+      }
+      stats.textFrames++;
+    }
+    pos += frameSize;
+  }
+
+  buffer.erase(buffer.begin(), buffer.begin() + pos);
+}
+
+int main(int argc, char** argv) {
+  if (argc < 3) {
+    fprintf(stderr, "Usage: %s <tty|file> <output.bin> [baud]\n", argv[0]);
+    return 1;
+  }
+  unsigned long baud = argc > 3 ? strtoul(argv[3], nullptr, 10) : SERIAL_STREAM_DEFAULT_BAUD;
+
+  int fd = open(argv[1], O_RDONLY | O_NOCTTY);
+  if (fd < 0) {
+    fprintf(stderr, "Cannot open %s: %s\n", argv[1], strerror(errno));
+    return 1;
+  }
+  if (configurePort(fd, baud)) {
+    fprintf(stderr, "Capturing from %s at %lu baud, Ctrl-C to stop\n", argv[1], baud);
+  }
+
+  FILE* out = fopen(argv[2], "wb");
+  if (!out) {
+    fprintf(stderr, "Cannot create %s: %s\n", argv[2], strerror(errno));
+    close(fd);
+    return 1;
+  }
+
+  signal(SIGINT, onSignal);
+  signal(SIGTERM, onSignal);
+
+  CaptureStats stats;
+  std::vector<uint8_t> buffer;
+  bool haveSequence = false;
+  uint16_t nextSequence = 0;
+  uint8_t chunk[4096];
+
+  while (!stopRequested) {
+    ssize_t n = read(fd, chunk, sizeof(chunk));
+    if (n < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      fprintf(stderr, "Read error: %s\n", strerror(errno));
+      break;
+    }
+    if (n == 0) {
+      break;  // End of file, or the pty closed
+    }
+    stats.bytesRead += n;
+    buffer.insert(buffer.end(), chunk, chunk + n);
+    parseFrames(buffer, out, stats, haveSequence, nextSequence);
+  }
+
+  stats.bytesSkipped += buffer.size();
+  fclose(out);
+  close(fd);
+  printStats(stats);
+  return 0;
+}
@@ -0,0 +1,187 @@
+// Host collector for UDP sample streaming (Settings::udpStreamEnabled).
+//
+// Receives the logger's datagrams (one StreamFrame samples frame each, see src/UdpBatcher.h),
+// appends their records to a standard .bin log and reports loss and latency. There are no
+// retransmits, so loss is the gaps in the sequence numbers; a datagram that arrives after a
+// later one is counted as reordered and no longer as lost.
+//
+// Latency is one-way, so without synchronised clocks it is reported relative to the fastest
+// datagram seen: the arrival time minus the timestamp of the newest record in each datagram,
+// less the minimum of that over the session. It includes batching delay, up to 100ms.
+//
+// Build:  g++ -std=c++11 -O2 -I../src -o udp_collector udp_collector.cpp
+// Usage:  ./udp_collector capture.bin [port]
+
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "StreamFrame.h"
+
+static const size_t RECORD_SIZE = UDP_RECORD_BYTES;
+static const unsigned REPORT_INTERVAL_MS = 5000;
+
+static volatile sig_atomic_t stopRequested = 0;
+
+struct CollectorStats {
+  unsigned long datagrams = 0;
+  unsigned long records = 0;
+  unsigned long lost = 0;
+  unsigned long reordered = 0;
+  unsigned long invalid = 0;
+  bool haveOffset = false;
+  long long minOffsetMs = 0;
+  long long latencyTotalMs = 0;
+  long long latencyMaxMs = 0;
+  unsigned long latencySamples = 0;
+};
+
+static void onSignal(int) {
+  stopRequested = 1;
+}
+
+static long long hostMillis() {
+  using namespace std::chrono;
+  return duration_cast<milliseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+static void printStats(const CollectorStats& stats) {
+  unsigned long expected = stats.datagrams + stats.lost;
+  fprintf(stderr, "Datagrams: %lu  Records: %lu  Lost: %lu (%.2f%%)  Reordered: %lu  Invalid: %lu",
+          stats.datagrams, stats.records, stats.lost,
+          expected > 0 ? 100.0 * stats.lost / expected : 0.0, stats.reordered, stats.invalid);
+  if (stats.latencySamples > 0) {
+    fprintf(stderr, "  Latency above minimum: avg %.1fms max %lldms",
+            (double)stats.latencyTotalMs / stats.latencySamples, stats.latencyMaxMs);
+  }
+  fputc('\n', stderr);
+}
+
+// Validates one datagram; returns the record payload length or -1
+static int checkDatagram(const uint8_t* data, size_t length, StreamFrameHeader& header) {
+  if (length < sizeof(header) + sizeof(uint16_t)) {
+    return -1;
+  }
+  memcpy(&header, data, sizeof(header));
+  if (header.sync != STREAM_FRAME_SYNC || header.type != STREAM_FRAME_SAMPLES ||
+      header.length > UDP_MAX_PAYLOAD || sizeof(header) + header.length + sizeof(uint16_t) != length) {
+    return -1;
+  }
+  uint16_t crc = streamFrameCRC(0xFFFF, data, sizeof(header) + header.length);
+  const uint8_t* crcBytes = data + sizeof(header) + header.length;
+  if (crc != (crcBytes[0] | (crcBytes[1] << 8))) {
+    return -1;
+  }
+  return header.length;
+}
+
+int main(int argc, char** argv) {
+  if (argc < 2) {
+    fprintf(stderr, "Usage: %s <output.bin> [port]\n", argv[0]);
+    return 1;
+  }
+  int port = argc > 2 ? atoi(argv[2]) : UDP_STREAM_DEFAULT_PORT;
+
+  int sock = socket(AF_INET, SOCK_DGRAM, 0);
+  if (sock < 0) {
+    fprintf(stderr, "Cannot create socket: %s\n", strerror(errno));
+    return 1;
+  }
+  struct sockaddr_in address;
+  memset(&address, 0, sizeof(address));
+  address.sin_family = AF_INET;
+  address.sin_addr.s_addr = htonl(INADDR_ANY);
+  address.sin_port = htons(port);
+  if (bind(sock, (struct sockaddr*)&address, sizeof(address)) != 0) {
+    fprintf(stderr, "Cannot bind port %d: %s\n", port, strerror(errno));
+    close(sock);
+    return 1;
+  }
+
+  // Wake up periodically so statistics are printed and Ctrl-C is noticed
+  struct timeval timeout = { 0, 200000 };
+  setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+  FILE* out = fopen(argv[1], "wb");
+  if (!out) {
+    fprintf(stderr, "Cannot create %s: %s\n", argv[1], strerror(errno));
+    close(sock);
+    return 1;
+  }
+
+  signal(SIGINT, onSignal);
+  signal(SIGTERM, onSignal);
+  fprintf(stderr, "Listening on UDP port %d, Ctrl-C to stop\n", port);
+
+  CollectorStats stats;
+  bool haveSequence = false;
+  uint16_t nextSequence = 0;
+  long long lastReport = hostMillis();
+  uint8_t datagram[2048];
+
+  while (!stopRequested) {
+    ssize_t n = recv(sock, datagram, sizeof(datagram), 0);
+    long long now = hostMillis();
+
+    if (n > 0) {
+      StreamFrameHeader header;
+      int payloadLength = checkDatagram(datagram, n, header);
+      if (payloadLength < 0) {
+        stats.invalid++;
+      } else {
+        uint16_t gap = header.sequence - nextSequence;
+        if (!haveSequence || gap < 0x8000) {
+          if (haveSequence) {
+            stats.lost += gap;
+          }
+          nextSequence = header.sequence + 1;
+          haveSequence = true;
+        } else if (stats.lost > 0) {
+          // Behind the expected sequence: a late arrival that was counted as lost
+          stats.lost--;
+          stats.reordered++;
+        }
+
+        size_t records = payloadLength / RECORD_SIZE;
+        fwrite(datagram + sizeof(header), RECORD_SIZE, records, out);
+        stats.records += records;
+        stats.datagrams++;
+
+        if (records > 0) {
+          uint32_t newest;
+          memcpy(&newest, datagram + sizeof(header) + (records - 1) * RECORD_SIZE, sizeof(newest));
+          long long offset = now - newest;
+          if (!stats.haveOffset || offset < stats.minOffsetMs) {
+            stats.minOffsetMs = offset;
+            stats.haveOffset = true;
+          }
+          long long latency = offset - stats.minOffsetMs;
+          stats.latencyTotalMs += latency;
+          stats.latencyMaxMs = latency > stats.latencyMaxMs ? latency : stats.latencyMaxMs;
+          stats.latencySamples++;
+        }
+      }
+    } else if (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+      fprintf(stderr, "Receive error: %s\n", strerror(errno));
+      break;
+    }
+
+    if (now - lastReport >= REPORT_INTERVAL_MS) {
+      printStats(stats);
+      fflush(out);
+      lastReport = now;
+    }
+  }
+
+  fclose(out);
+  close(sock);
+  printStats(stats);
+  return 0;
+}
@@ -0,0 +1,103 @@
+// Host build of the logger's UDP streaming path, for testing tools/udp_collector.cpp on
+// localhost without a device. Synthetic records go through the firmware's own UdpBatcher at
+// the logging rate and are sent with a POSIX socket where UdpStreamTask uses WiFiUDP.
+// Every Nth datagram can be skipped (its sequence number is still spent, as on the device
+// when a send fails) to check that the collector reports the loss. The last datagram is always
+// sent: losing it leaves no sequence gap, so the collector could not report it.
+//
+// Build:  g++ -std=c++11 -O2 -I../src -o udp_sender udp_sender.cpp ../src/UdpBatcher.cpp
+// Usage:  ./udp_sender [host] [port] [seconds] [rateHz] [dropEveryN]
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "UdpBatcher.h"
+
+// Same layout as MPULogRecord, which needs the Arduino headers
+struct SyntheticRecord {
+  uint32_t timestamp;
+  float accel[3];
+  float gyro[3];
+  uint8_t flags;
+  uint8_t padding;
+  uint16_t alignment;
+};
+
+static uint32_t hostMillis() {
+  using namespace std::chrono;
+  return duration_cast<milliseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+int main(int argc, char** argv) {
+  const char* host = argc > 1 ? argv[1] : "127.0.0.1";
+  int port = argc > 2 ? atoi(argv[2]) : UDP_STREAM_DEFAULT_PORT;
+  int seconds = argc > 3 ? atoi(argv[3]) : 10;
+  int rateHz = argc > 4 ? atoi(argv[4]) : 100;
+  int dropEvery = argc > 5 ? atoi(argv[5]) : 0;
+  static_assert(sizeof(SyntheticRecord) == UDP_RECORD_BYTES, "record layout must match MPULogRecord");
+
+  int sock = socket(AF_INET, SOCK_DGRAM, 0);
+  struct sockaddr_in address;
+  memset(&address, 0, sizeof(address));
+  address.sin_family = AF_INET;
+  address.sin_port = htons(port);
+  if (sock < 0 || inet_pton(AF_INET, host, &address.sin_addr) != 1) {
+    fprintf(stderr, "Cannot send to %s:%d\n", host, port);
+    return 1;
+  }
+
+  UdpBatcher batcher;
+  unsigned long sent = 0;
+  unsigned long skipped = 0;
+  unsigned long records = 0;
+
+  auto send = [&](bool last) {
+    uint16_t length = batcher.seal();
+    if (length == 0) {
+      return;
+    }
+    if (!last && dropEvery > 0 && batcher.getSequence() % dropEvery == 0) {
+      skipped++;
+      return;
+    }
+    if (sendto(sock, batcher.data(), length, 0, (struct sockaddr*)&address, sizeof(address)) == length) {
+      sent++;
+    }
+  };
+
+  const auto period = std::chrono::microseconds(1000000 / rateHz);
+  auto next = std::chrono::steady_clock::now();
+  const long total = (long)seconds * rateHz;
+  for (long i = 0; i < total; i++) {
+    SyntheticRecord record;
+    memset(&record, 0, sizeof(record));
+    record.timestamp = hostMillis();
+    record.accel[2] = 1.0f + 0.1f * sinf(i * 0.1f);
+    record.gyro[0] = 10.0f * cosf(i * 0.05f);
+    record.flags = 1;
+    records++;
+
+    if (batcher.add(&record, sizeof(record), record.timestamp)) {
+      send(i + 1 == total);
+    }
+    if (batcher.isDue(hostMillis())) {
+      send(false);
+    }
+
+    next += period;
+    std::this_thread::sleep_until(next);
+  }
+  send(true);
+
+  fprintf(stderr, "Records: %lu  Datagrams sent: %lu  Skipped: %lu\n", records, sent, skipped);
+  close(sock);
+  return 0;
+}